@@ -1,17 +1,19 @@
+#include <vector>
 #include <utility>
 #include <iterator>
 
 #ifndef _AGENDA_H
 #define _AGENDA_H
 
+// iterates over the items of a beam, dereferenced to a pointer to the item
 template<typename T>
 class BeamIterator {
 public:
 	typedef BeamIterator<T>	self;
 
-	typedef T				value_type;
-	typedef T*				pointer;
-	typedef T&				reference;
+	typedef T *				value_type;
+	typedef T *				pointer;
+	typedef T *				reference;
 
 public:
 	T* node;
@@ -24,17 +26,13 @@ public:
 	bool operator==(const self & x) const { return node == x.node; }
 	bool operator!=(const self & x) const { return node != x.node; }
 
-	reference operator*() { return *node; }
-	pointer operator->() { return node; }
-
-	reference operator*() const { return *node; }
-	pointer operator->() const { return node; }
+	T * operator*() const { return node; }
 
 	self & operator++() {
 		++node;
 		return *this;
 	}
-	self & operator++(int) {
+	self operator++(int) {
 		self tmp = *this;
 		++*this;
 		return tmp;
@@ -43,52 +41,38 @@ public:
 		--node;
 		return *this;
 	}
-	self & operator--(int) {
+	self operator--(int) {
 		self tmp = *this;
-		++*this;
+		--*this;
 		return tmp;
 	}
 };
 
+// top SIZE items, stored inline and kept sorted from the best one
+// a full beam rejects a candidate with one comparison against its last item,
+// items with equal scores keep their insertion order
+// setLimit() narrows the beam at runtime
 template<typename KEY_TYPE, int SIZE>
 class AgendaBeam {
 public:
-	typedef BeamIterator<KEY_TYPE *>				iterator;
-	typedef BeamIterator<KEY_TYPE * const>			const_iterator;
+	typedef BeamIterator<KEY_TYPE>				iterator;
+	typedef BeamIterator<const KEY_TYPE>		const_iterator;
 
 private:
 	int m_nBeamSize;
-	bool m_bItemSorted;
-	KEY_TYPE * m_lBeam[SIZE];
-	KEY_TYPE m_lEntity[SIZE];
-
-	void pop_heap();
-	void push_heap(int base);
+	int m_nLimit;
+	KEY_TYPE m_lBeam[SIZE];
 
 public:
 
-	AgendaBeam() : m_nBeamSize(0), m_bItemSorted(false) {
-		for (int i = 0; i < SIZE; ++i) {
-			m_lBeam[i] = &m_lEntity[i];
-		}
-	}
-	AgendaBeam(const AgendaBeam<KEY_TYPE, SIZE> & ab) : m_nBeamSize(ab.m_nBeamSize), m_bItemSorted(ab.m_bItemSorted) {
-		for (int i = 0; i < SIZE; ++i) {
-			m_lEntity[i] = ab.m_lEntity[i];
-			m_lBeam[i] = &m_lEntity[ab.m_lBeam[i] - ab.m_lEntity];
-		}
-	}
-	AgendaBeam(AgendaBeam<KEY_TYPE, SIZE> && ab) : m_nBeamSize(ab.m_nBeamSize), m_bItemSorted(ab.m_bItemSorted) {
-		for (int i = 0; i < SIZE; ++i) {
-			m_lEntity[i] = ab.m_lEntity[i];
-			m_lBeam[i] = &m_lEntity[ab.m_lBeam[i] - ab.m_lEntity];
-			ab.m_lBeam[i] = nullptr;
-		}
-	}
+	AgendaBeam() : m_nBeamSize(0), m_nLimit(SIZE) {}
+	AgendaBeam(const AgendaBeam<KEY_TYPE, SIZE> & ab) = default;
+	AgendaBeam(AgendaBeam<KEY_TYPE, SIZE> && ab) = default;
 	~AgendaBeam() = default;
 
 	const int & size() const;
 	void clear();
+	void setLimit(const int & nLimit);
 
 	void insertItem(const KEY_TYPE & item);
 	void sortItems();
@@ -100,67 +84,21 @@ public:
 	const_iterator begin() const { return &m_lBeam[0]; }
 	const_iterator end() const { return &m_lBeam[m_nBeamSize]; }
 
-	AgendaBeam<KEY_TYPE, SIZE> & operator=(const AgendaBeam<KEY_TYPE, SIZE> & ab) {
-		m_nBeamSize = ab.m_nBeamSize;
-		m_bItemSorted = ab.m_bItemSorted;
-		for (int i = 0; i < SIZE; ++i) {
-			m_lEntity[i] = ab.m_lEntity[i];
-			m_lBeam[i] = &m_lEntity[ab.m_lBeam[i] - ab.m_lEntity];
-		}
-		return *this;
-	}
-
-	AgendaBeam<KEY_TYPE, SIZE> & operator=(AgendaBeam<KEY_TYPE, SIZE> && ab) {
-		m_nBeamSize = ab.m_nBeamSize;
-		m_bItemSorted = ab.m_bItemSorted;
-		for (int i = 0; i < SIZE; ++i) {
-			m_lEntity[i] = ab.m_lEntity[i];
-			m_lBeam[i] = &m_lEntity[ab.m_lBeam[i] - ab.m_lEntity];
-			ab.m_lBeam[i] = nullptr;
-		}
-		return *this;
-	}
+	const KEY_TYPE & operator[](const int & index) const { return m_lBeam[index]; }
 
+	AgendaBeam<KEY_TYPE, SIZE> & operator=(const AgendaBeam<KEY_TYPE, SIZE> & ab) = default;
+	AgendaBeam<KEY_TYPE, SIZE> & operator=(AgendaBeam<KEY_TYPE, SIZE> && ab) = default;
 };
 
 template<typename KEY_TYPE, int SIZE>
-void AgendaBeam<KEY_TYPE, SIZE>::push_heap(int base) {
-	while (base > 0) {
-		int next_base = (base - 1) >> 1;
-		if (*m_lBeam[next_base] > *m_lBeam[base]) {
-			std::swap(m_lBeam[next_base], m_lBeam[base]);
-			base = next_base;
-		}
-		else {
-			break;
-		}
-	}
-}
-
-template<typename KEY_TYPE, int SIZE>
-void AgendaBeam<KEY_TYPE, SIZE>::pop_heap() {
-	if (m_nBeamSize <= 0) {
-		return;
-	}
-	std::swap(m_lBeam[0], m_lBeam[--m_nBeamSize]);
-	KEY_TYPE * smallest = m_lBeam[0];
-	int index = 0, child = 1;
-	while (child < m_nBeamSize) {
-		if (child + 1 < m_nBeamSize && *m_lBeam[child + 1] <= *m_lBeam[child]) {
-			++child;
-		}
-		m_lBeam[index] = m_lBeam[child];
-		index = child;
-		child = (child << 1) + 1;
-	}
-	m_lBeam[index] = smallest;
-	push_heap(index);
+inline void AgendaBeam<KEY_TYPE, SIZE>::clear() {
+	m_nBeamSize = 0;
 }
 
 template<typename KEY_TYPE, int SIZE>
-inline void AgendaBeam<KEY_TYPE, SIZE>::clear() {
-	m_nBeamSize = 0;
-	m_bItemSorted = false;
+inline void AgendaBeam<KEY_TYPE, SIZE>::setLimit(const int & nLimit) {
+	// insertItem() needs room for one item at least
+	m_nLimit = nLimit < 1 ? 1 : nLimit < SIZE ? nLimit : SIZE;
 }
 
 template<typename KEY_TYPE, int SIZE>
@@ -169,49 +107,105 @@ inline const int & AgendaBeam<KEY_TYPE, SIZE>::size() const {
 }
 
 template<typename KEY_TYPE, int SIZE>
-void AgendaBeam<KEY_TYPE, SIZE>::insertItem(const KEY_TYPE & item) {
-	if (m_nBeamSize == SIZE) {
-		if (item > *m_lBeam[0]) {
-			pop_heap();
+inline void AgendaBeam<KEY_TYPE, SIZE>::insertItem(const KEY_TYPE & item) {
+	if (m_nBeamSize == m_nLimit) {
+		if (item > m_lBeam[m_nLimit - 1]) {
+			--m_nBeamSize;
 		}
 		else {
 			return;
 		}
 	}
-	*m_lBeam[m_nBeamSize] = item;
-	push_heap(m_nBeamSize++);
+	int index = m_nBeamSize++;
+	while (index > 0 && item > m_lBeam[index - 1]) {
+		m_lBeam[index] = m_lBeam[index - 1];
+		--index;
+	}
+	m_lBeam[index] = item;
 }
 
+// items are always sorted
 template<typename KEY_TYPE, int SIZE>
-void AgendaBeam<KEY_TYPE, SIZE>::sortItems() {
-	if (m_bItemSorted) {
-		return;
-	}
-	int size = m_nBeamSize;
-	while (m_nBeamSize > 0) {
-		pop_heap();
-	}
-	m_nBeamSize = size;
-	m_bItemSorted = true;
+inline void AgendaBeam<KEY_TYPE, SIZE>::sortItems() {}
+
+template<typename KEY_TYPE, int SIZE>
+inline const KEY_TYPE & AgendaBeam<KEY_TYPE, SIZE>::bestItem(const int & /*index*/) {
+	return m_lBeam[0];
 }
 
 template<typename KEY_TYPE, int SIZE>
-const KEY_TYPE & AgendaBeam<KEY_TYPE, SIZE>::bestItem(const int & index) {
-	if (!m_bItemSorted) {
-		sortItems();
+inline const KEY_TYPE & AgendaBeam<KEY_TYPE, SIZE>::bestUnsortItem(const int & /*index*/) {
+	return m_lBeam[0];
+}
+
+// the same beam with storage for only the items of its limit, allocated by
+// setLimit(), for beams whose width is picked when the parser is built
+template<typename KEY_TYPE>
+class AgendaBeam<KEY_TYPE, 0> {
+public:
+	typedef BeamIterator<KEY_TYPE>				iterator;
+	typedef BeamIterator<const KEY_TYPE>		const_iterator;
+
+private:
+	int m_nBeamSize;
+	int m_nLimit;
+	std::vector<KEY_TYPE> m_lBeam;
+
+public:
+
+	AgendaBeam() : m_nBeamSize(0), m_nLimit(1), m_lBeam(1) {}
+	AgendaBeam(const AgendaBeam<KEY_TYPE, 0> & ab) = default;
+	AgendaBeam(AgendaBeam<KEY_TYPE, 0> && ab) = default;
+	~AgendaBeam() = default;
+
+	const int & size() const { return m_nBeamSize; }
+	void clear() { m_nBeamSize = 0; }
+	void setLimit(const int & nLimit);
+
+	void insertItem(const KEY_TYPE & item);
+	void sortItems() {}
+	const KEY_TYPE & bestItem(const int & = 0) { return m_lBeam[0]; }
+	const KEY_TYPE & bestUnsortItem(const int & = 0) { return m_lBeam[0]; }
+
+	iterator begin() { return m_lBeam.data(); }
+	iterator end() { return m_lBeam.data() + m_nBeamSize; }
+	const_iterator begin() const { return m_lBeam.data(); }
+	const_iterator end() const { return m_lBeam.data() + m_nBeamSize; }
+
+	const KEY_TYPE & operator[](const int & index) const { return m_lBeam[index]; }
+
+	AgendaBeam<KEY_TYPE, 0> & operator=(const AgendaBeam<KEY_TYPE, 0> & ab) = default;
+	AgendaBeam<KEY_TYPE, 0> & operator=(AgendaBeam<KEY_TYPE, 0> && ab) = default;
+};
+
+template<typename KEY_TYPE>
+inline void AgendaBeam<KEY_TYPE, 0>::setLimit(const int & nLimit) {
+	m_nLimit = nLimit < 1 ? 1 : nLimit;
+	if (m_nBeamSize > m_nLimit) {
+		m_nBeamSize = m_nLimit;
+	}
+	if ((int)m_lBeam.size() != m_nLimit) {
+		std::vector<KEY_TYPE>(m_nLimit).swap(m_lBeam);
+		m_nBeamSize = 0;
 	}
-	return *m_lBeam[0];
 }
 
-template<typename KEY_TYPE, int SIZE>
-const KEY_TYPE & AgendaBeam<KEY_TYPE, SIZE>::bestUnsortItem(const int & index) {
-	int best_index = 0;
-	for (int i = 1; i < m_nBeamSize; ++i) {
-		if (*m_lBeam[best_index] < *m_lBeam[i]) {
-			best_index = i;
+template<typename KEY_TYPE>
+inline void AgendaBeam<KEY_TYPE, 0>::insertItem(const KEY_TYPE & item) {
+	if (m_nBeamSize == m_nLimit) {
+		if (item > m_lBeam[m_nLimit - 1]) {
+			--m_nBeamSize;
 		}
+		else {
+			return;
+		}
+	}
+	int index = m_nBeamSize++;
+	while (index > 0 && item > m_lBeam[index - 1]) {
+		m_lBeam[index] = m_lBeam[index - 1];
+		--index;
 	}
-	return *m_lBeam[best_index];
+	m_lBeam[index] = item;
 }
 
 #endif
@@ -0,0 +1,172 @@
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+#include "corpus.h"
+#include "score_cache.h"
+#include "arc_labeler.h"
+
+ArcLabeler::ArcLabeler() : m_mapWeights("m_mapLabels"), m_nScoreIndex(eNonAverage), m_nTrainingRound(0) {}
+
+ArcLabeler::~ArcLabeler() = default;
+
+void ArcLabeler::addLabel(const ttoken & label) {
+	if (std::find(m_vecLabels.begin(), m_vecLabels.end(), label) == m_vecLabels.end()) {
+		m_vecLabels.push_back(label);
+		m_vecLabelKeys.push_back(ScoreCache::hash(label, ScoreCache::hash("label")));
+	}
+}
+
+void ArcLabeler::countChildren(const DependencyTree & tree) {
+	m_vecChildren.assign(tree.size(), 0);
+	for (const auto & node : tree) {
+		if (TREENODE_HEAD(node) != -1) {
+			++m_vecChildren[TREENODE_HEAD(node)];
+		}
+	}
+}
+
+void ArcLabeler::features(const DependencyTree & tree, const int & c, std::vector<std::uint64_t> & vecFeatures) const {
+	int n = tree.size(), h = TREENODE_HEAD(tree[c]);
+	auto word = [&](const int & i) -> const ttoken & {
+		static const ttoken start = START_WORD, end = END_WORD;
+		return i < 0 ? start : i >= n ? end : TREENODE_WORD(tree[i]);
+	};
+	auto tag = [&](const int & i) -> const ttoken & {
+		static const ttoken start = START_POSTAG, end = END_POSTAG;
+		return i < 0 ? start : i >= n ? end : TREENODE_POSTAG(tree[i]);
+	};
+	// the root has no position, its head is the root again
+	auto headTag = [&](const int & i) -> const ttoken & {
+		static const ttoken root = ROOT_POSTAG;
+		return i == -1 ? root : tag(i);
+	};
+	static const ttoken root_word = ROOT_WORD;
+	const ttoken & pw = h == -1 ? root_word : word(h);
+	const ttoken & pt = headTag(h);
+	const ttoken & cw = word(c);
+	const ttoken & ct = tag(c);
+	const ttoken & gt = headTag(h == -1 ? -1 : TREENODE_HEAD(tree[h]));
+	std::string dist = std::to_string(h == -1 ? 0 : h < c ? encodeLinkDistance(h, c) : -encodeLinkDistance(c, h));
+
+	vecFeatures.clear();
+	vecFeatures.push_back(ScoreCache::hash("b"));
+	vecFeatures.push_back(ScoreCache::hash(pw, ScoreCache::hash("pw")));
+	vecFeatures.push_back(ScoreCache::hash(pt, ScoreCache::hash("pt")));
+	vecFeatures.push_back(ScoreCache::hash(cw, ScoreCache::hash("cw")));
+	vecFeatures.push_back(ScoreCache::hash(ct, ScoreCache::hash("ct")));
+	vecFeatures.push_back(ScoreCache::hash(pt, ScoreCache::hash(pw, ScoreCache::hash("pwpt"))));
+	vecFeatures.push_back(ScoreCache::hash(ct, ScoreCache::hash(cw, ScoreCache::hash("cwct"))));
+	vecFeatures.push_back(ScoreCache::hash(ct, ScoreCache::hash(pt, ScoreCache::hash("ptct"))));
+	vecFeatures.push_back(ScoreCache::hash(ct, ScoreCache::hash(pw, ScoreCache::hash("pwct"))));
+	vecFeatures.push_back(ScoreCache::hash(cw, ScoreCache::hash(pt, ScoreCache::hash("ptcw"))));
+	vecFeatures.push_back(ScoreCache::hash(cw, ScoreCache::hash(pw, ScoreCache::hash("pwcw"))));
+	vecFeatures.push_back(ScoreCache::hash(dist, ScoreCache::hash(ct, ScoreCache::hash(pt, ScoreCache::hash("ptctd")))));
+	vecFeatures.push_back(ScoreCache::hash(tag(c + 1), ScoreCache::hash(ct, ScoreCache::hash(tag(c - 1), ScoreCache::hash("ct-1ctct1")))));
+	vecFeatures.push_back(ScoreCache::hash(ct, ScoreCache::hash(pt, ScoreCache::hash(gt, ScoreCache::hash("gtptct")))));
+	vecFeatures.push_back(ScoreCache::hash(std::to_string(std::min(m_vecChildren[c], 3)), ScoreCache::hash(ct, ScoreCache::hash("ctk"))));
+}
+
+int ArcLabeler::bestLabel(const DependencyTree & tree, const int & c) {
+	features(tree, c, m_vecFeatures);
+	m_vecScores.assign(m_vecLabels.size(), 0);
+	int best = 0;
+	for (int l = 0; l < (int)m_vecLabels.size(); ++l) {
+		for (const auto & feature : m_vecFeatures) {
+			m_mapWeights.getOrUpdateScore(m_vecScores[l], feature ^ m_vecLabelKeys[l], m_nScoreIndex, 0, m_nTrainingRound);
+		}
+		if (m_vecScores[best] < m_vecScores[l]) {
+			best = l;
+		}
+	}
+	return best;
+}
+
+void ArcLabeler::update(const std::vector<std::uint64_t> & vecFeatures, const int & label, const int & amount) {
+	for (const auto & feature : vecFeatures) {
+		m_mapWeights.updateScore(feature ^ m_vecLabelKeys[label], amount, m_nTrainingRound);
+	}
+}
+
+void ArcLabeler::train(const std::string & sInputFile, const int & nIterations) {
+	DependencyTree tree;
+	std::vector<DependencyTree> trees;
+
+	CorpusReader input(sInputFile);
+	while (input >> tree) {
+		for (const auto & node : tree) {
+			addLabel(TREENODE_LABEL(node));
+		}
+		trees.push_back(tree);
+	}
+	input.close();
+
+	m_nScoreIndex = eNonAverage;
+	for (int iteration = 0; iteration < nIterations; ++iteration) {
+		int nArcs = 0, nCorrect = 0;
+		for (const auto & correct : trees) {
+			++m_nTrainingRound;
+			countChildren(correct);
+			for (int c = 0; c < (int)correct.size(); ++c) {
+				int best = bestLabel(correct, c);
+				int gold = std::find(m_vecLabels.begin(), m_vecLabels.end(), TREENODE_LABEL(correct[c])) - m_vecLabels.begin();
+				if (best != gold) {
+					update(m_vecFeatures, gold, 1);
+					update(m_vecFeatures, best, -1);
+				}
+				else {
+					++nCorrect;
+				}
+				++nArcs;
+			}
+		}
+		std::cout << "labeler iteration " << iteration + 1 << " accuracy " << (nArcs == 0 ? 0.0 : (double)nCorrect / nArcs) << std::endl;
+	}
+	m_mapWeights.computeAverage(m_nTrainingRound);
+	m_nScoreIndex = eAverage;
+}
+
+bool ArcLabeler::load(const std::string & sFile) {
+	std::ifstream input(sFile);
+	int nLabels = 0;
+	if (!(input >> nLabels)) {
+		return false;
+	}
+	ttoken label;
+	for (int i = 0; i < nLabels; ++i) {
+		input >> label;
+		addLabel(label);
+	}
+	input >> m_mapWeights;
+	m_nScoreIndex = eAverage;
+	return !m_vecLabels.empty();
+}
+
+bool ArcLabeler::save(const std::string & sFile) const {
+	std::ofstream output(sFile);
+	output << m_vecLabels.size() << std::endl;
+	for (const auto & label : m_vecLabels) {
+		output << label << std::endl;
+	}
+	output << m_mapWeights;
+	return (bool)output;
+}
+
+void ArcLabeler::label(DependencyTree & tree) {
+	if (m_vecLabels.empty()) {
+		return;
+	}
+	countChildren(tree);
+	for (int c = 0; c < (int)tree.size(); ++c) {
+		TREENODE_LABEL(tree[c]) = m_vecLabels[bestLabel(tree, c)];
+	}
+}
+
+std::shared_ptr<ArcLabeler> ArcLabeler::open(const std::string & sFile) {
+	std::shared_ptr<ArcLabeler> labeler(new ArcLabeler());
+	if (!labeler->load(sFile)) {
+		std::cout << "arc labeler " << sFile << " can't be loaded." << std::endl;
+		return nullptr;
+	}
+	return labeler;
+}
@@ -0,0 +1,59 @@
+#ifndef _ARC_LABELER_H
+#define _ARC_LABELER_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "macros_base.h"
+#include "include/learning/perceptron/packed_score.h"
+
+#define ARC_LABELER_ITERATION	10
+
+// linear labeler giving a dependency label to every arc of a parsed tree
+// it runs after any decoder on the heads it found, every arc is labeled on
+// its own from the words and tags around it, so a sentence costs
+// O(n x |labels|) weight lookups
+// features are hashed over the strings of the tree, so the model doesn't
+// depend on the tokenizer codes of the parser model loaded with it, and
+// every (feature, label) pair has a weight trained by the averaged perceptron
+class ArcLabeler {
+private:
+	// labels in the order they were seen in training, with their hashes
+	std::vector<ttoken> m_vecLabels;
+	std::vector<std::uint64_t> m_vecLabelKeys;
+	PackedScoreMap<std::uint64_t> m_mapWeights;
+	int m_nScoreIndex;
+	int m_nTrainingRound;
+
+	std::vector<int> m_vecChildren;
+	std::vector<std::uint64_t> m_vecFeatures;
+	std::vector<tscore> m_vecScores;
+
+	void addLabel(const ttoken & label);
+	void countChildren(const DependencyTree & tree);
+	// needs countChildren() of the tree first
+	void features(const DependencyTree & tree, const int & c, std::vector<std::uint64_t> & vecFeatures) const;
+	// index of the best label of the arc to c, scores of every label in m_vecScores
+	int bestLabel(const DependencyTree & tree, const int & c);
+	void update(const std::vector<std::uint64_t> & vecFeatures, const int & label, const int & amount);
+
+public:
+	ArcLabeler();
+	~ArcLabeler();
+
+	const std::vector<ttoken> & labels() const { return m_vecLabels; }
+
+	void train(const std::string & sInputFile, const int & nIterations);
+	bool load(const std::string & sFile);
+	bool save(const std::string & sFile) const;
+
+	// sets the label of every node from its head
+	void label(DependencyTree & tree);
+
+	// nullptr if the file can't be read
+	static std::shared_ptr<ArcLabeler> open(const std::string & sFile);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+
+#include "score_cache.h"
+#include "batch_parser.h"
+#include "common/parser/graph_dp/decoders.h"
+
+namespace {
+	// the tokenizers and what the decoders code at loading belong to the
+	// process, so every BatchParser loads and parses under this one lock
+	std::mutex parsing;
+}
+
+bool BatchParser::parseLocked(const Sentence & sentence, DependencyTree & tree) {
+	tree.clear();
+	if (sentence.empty() || sentence.size() >= MAX_SENTENCE_SIZE) {
+		return false;
+	}
+	bool degraded = m_pRun->parseSentence(*m_pParser, sentence, tree);
+	if (m_pLabeler) {
+		m_pLabeler->label(tree);
+	}
+	return degraded;
+}
+
+bool BatchParser::parse(const Sentence & sentence, DependencyTree & tree) {
+	std::lock_guard<std::mutex> lock(parsing);
+	return parseLocked(sentence, tree);
+}
+
+std::vector<DependencyTree> BatchParser::parse(const std::vector<Sentence> & vecSentences) {
+	std::vector<DependencyTree> trees(vecSentences.size());
+	std::lock_guard<std::mutex> lock(parsing);
+	for (std::size_t i = 0; i < vecSentences.size(); ++i) {
+		parseLocked(vecSentences[i], trees[i]);
+	}
+	return trees;
+}
+
+std::unique_ptr<BatchParser> BatchParser::open(const std::string & sDecoder, const std::string & sFeatureFile, const std::vector<std::string> & vecOptions) {
+	std::lock_guard<std::mutex> lock(parsing);
+	std::unique_ptr<BatchParser> parser(new BatchParser());
+	std::vector<std::string> options;
+	int lru = 0;
+	double budget = 0.0;
+	for (const auto & option : vecOptions) {
+		if (strncmp(option.c_str(), "labeler=", strlen("labeler=")) == 0) {
+			parser->m_pLabeler = ArcLabeler::open(option.substr(strlen("labeler=")));
+			if (!parser->m_pLabeler) {
+				return nullptr;
+			}
+		}
+		else if (strncmp(option.c_str(), "lru=", strlen("lru=")) == 0) {
+			lru = std::atoi(option.c_str() + strlen("lru="));
+		}
+		else if (strncmp(option.c_str(), "budget=", strlen("budget=")) == 0) {
+			budget = std::atof(option.c_str() + strlen("budget="));
+		}
+		else if (strncmp(option.c_str(), "cache=", strlen("cache=")) != 0) {
+			options.push_back(option);
+		}
+	}
+	parser->m_pRun = createRun(sDecoder, options);
+	if (!parser->m_pRun) {
+		return nullptr;
+	}
+	parser->m_pRun->setBudget(budget);
+	if (lru > 0) {
+		parser->m_pRun->setSentenceCache(std::make_shared<SentenceCache>((std::size_t)lru << 20, sDecoder + ScoreCache::fingerprint({ sFeatureFile })));
+	}
+	parser->m_pParser = parser->m_pRun->load(sFeatureFile);
+	if (!parser->m_pParser) {
+		return nullptr;
+	}
+	return parser;
+}
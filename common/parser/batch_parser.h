@@ -0,0 +1,45 @@
+#ifndef _BATCH_PARSER_H
+#define _BATCH_PARSER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "run_base.h"
+#include "arc_labeler.h"
+#include "sentence_parser.h"
+
+// entry point for programs using xeisner as a library, it holds the loaded
+// models of one decoder and parses sentences in memory, nothing but the
+// model files is touched on the filesystem
+// parse() and open() may be called from any thread, calls of all instances
+// take turns on one lock of the process since the tokenizers are shared
+class BatchParser {
+private:
+	std::unique_ptr<RunBase> m_pRun;
+	std::unique_ptr<SentenceParser> m_pParser;
+	std::shared_ptr<ArcLabeler> m_pLabeler;
+
+	BatchParser() = default;
+
+	bool parseLocked(const Sentence & sentence, DependencyTree & tree);
+
+public:
+	~BatchParser() = default;
+
+	// sentences parse can't take, empty or of MAX_SENTENCE_SIZE words and
+	// more, get an empty tree
+	// true when the tree is degraded, the decoder ran out of the time budget
+	// and finished the sentence with its fallback
+	bool parse(const Sentence & sentence, DependencyTree & tree);
+	std::vector<DependencyTree> parse(const std::vector<Sentence> & vecSentences);
+
+	// decoder names and options are those of the parse command, labeler=file
+	// labels the arcs, lru=mb keeps the trees of repeated sentences, budget=ms
+	// bounds the decoding time of a sentence, cache= is dropped since the cache
+	// is a file it writes
+	// nullptr if the decoder is unknown or its models can't be loaded
+	static std::unique_ptr<BatchParser> open(const std::string & sDecoder, const std::string & sFeatureFile, const std::vector<std::string> & vecOptions = std::vector<std::string>());
+};
+
+#endif
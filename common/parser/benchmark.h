@@ -0,0 +1,221 @@
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <set>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <memory>
+#include <iostream>
+
+#include "corpus.h"
+#include "macros_base.h"
+#include "score_cache.h"
+#include "empty_detector.h"
+
+// gold trees short enough to be parsed
+inline void loadGoldTrees(const std::string & sInputFile, std::vector<DependencyTree> & vecTrees) {
+	DependencyTree tree;
+	CorpusReader input(sInputFile);
+	vecTrees.clear();
+	while (input >> tree) {
+		if (tree.size() < MAX_SENTENCE_SIZE) {
+			vecTrees.push_back(tree);
+		}
+	}
+	input.close();
+}
+
+inline int correctHeads(const DependencyTree & correct, const DependencyTree & tree) {
+	int nCorrect = 0;
+	for (std::size_t i = 0; i < correct.size(); ++i) {
+		nCorrect += TREENODE_HEAD(correct[i]) == TREENODE_HEAD(tree[i]) ? 1 : 0;
+	}
+	return nCorrect;
+}
+
+// empty nodes of a tree as (words before it, category), and the heads of
+// the other words counted in words only, -1 for the root or an empty head
+inline void emptyNodes(const DependencyTree & tree, std::multiset<std::pair<int, ttoken>> & setEmpties, std::vector<int> & vecHeads) {
+	std::vector<int> vecIds;
+	int nWords = 0;
+	for (const auto & node : tree) {
+		if (TREENODE_POSTAG(node) == EMPTY_NODE_POSTAG) {
+			vecIds.push_back(-1);
+			setEmpties.insert(std::make_pair(nWords, TREENODE_WORD(node)));
+		}
+		else {
+			vecIds.push_back(nWords++);
+		}
+	}
+	for (const auto & node : tree) {
+		if (TREENODE_POSTAG(node) != EMPTY_NODE_POSTAG) {
+			vecHeads.push_back(TREENODE_HEAD(node) == -1 ? -1 : vecIds[TREENODE_HEAD(node)]);
+		}
+	}
+}
+
+// gold trees without their empty nodes, what the empty decoders parse
+inline void removeEmptyNodes(const std::vector<DependencyTree> & vecCorrects, std::vector<DependencyTree> & vecTrees) {
+	vecTrees.clear();
+	for (const auto & correct : vecCorrects) {
+		vecTrees.push_back(DependencyTree());
+		for (const auto & node : correct) {
+			if (TREENODE_POSTAG(node) != EMPTY_NODE_POSTAG) {
+				vecTrees.back().push_back(node);
+			}
+		}
+	}
+}
+
+// attachment score of the words and empty node f1 of parsed trees
+struct EmptyScores {
+	int nWords = 0, nCorrect = 0, nGoldEmpty = 0, nTrainEmpty = 0, nCorrectEmpty = 0;
+
+	void add(const DependencyTree & correct, const DependencyTree & tree) {
+		std::multiset<std::pair<int, ttoken>> setGoldEmpties, setTrainEmpties;
+		std::vector<int> vecGoldHeads, vecTrainHeads;
+		emptyNodes(correct, setGoldEmpties, vecGoldHeads);
+		emptyNodes(tree, setTrainEmpties, vecTrainHeads);
+		for (std::size_t i = 0; i < vecGoldHeads.size(); ++i) {
+			nCorrect += vecGoldHeads[i] == vecTrainHeads[i] ? 1 : 0;
+		}
+		nWords += vecGoldHeads.size();
+		nGoldEmpty += setGoldEmpties.size();
+		nTrainEmpty += setTrainEmpties.size();
+		for (const auto & empty : setTrainEmpties) {
+			auto itr = setGoldEmpties.find(empty);
+			if (itr != setGoldEmpties.end()) {
+				setGoldEmpties.erase(itr);
+				++nCorrectEmpty;
+			}
+		}
+	}
+
+	double uas() const { return nWords == 0 ? 0.0 : (double)nCorrect / nWords; }
+	double precision() const { return nTrainEmpty == 0 ? 0.0 : (double)nCorrectEmpty / nTrainEmpty; }
+	double recall() const { return nGoldEmpty == 0 ? 0.0 : (double)nCorrectEmpty / nGoldEmpty; }
+	double f() const { return precision() + recall() == 0.0 ? 0.0 : 2 * precision() * recall() / (precision() + recall()); }
+};
+
+// parse the words of every gold tree, visit(index, tree) sees each result
+// returns the seconds spent in the parser
+template<class DEP_PARSER, class VISIT_FUNC>
+double timeParse(DEP_PARSER * parser, const std::vector<DependencyTree> & vecTrees, VISIT_FUNC visit) {
+	Sentence sentence;
+	DependencyTree tree;
+	std::chrono::duration<double> seconds(0);
+	for (int i = 0; i < (int)vecTrees.size(); ++i) {
+		sentence.clear();
+		for (const auto & node : vecTrees[i]) {
+			sentence.push_back(TREENODE_POSTAGGEDWORD(node));
+		}
+		tree.clear();
+		auto time_begin = std::chrono::steady_clock::now();
+		parser->parse(sentence, &tree);
+		seconds += std::chrono::steady_clock::now() - time_begin;
+		visit(i, tree);
+	}
+	return seconds.count();
+}
+
+// speed/recall curve of an empty decoder gated by the detector
+// a negative threshold parses without it, for the others every row reports
+// the share of (gap, category) slots left open, the share of gold empty
+// nodes whose slot is open, the attachment score of the words, empty node
+// f1 and the decoding time
+template<class DEP_PARSER>
+void benchmarkEmptyDetector(DEP_PARSER * parser, const std::vector<DependencyTree> & vecCorrects, const std::shared_ptr<const EmptyDetector> & detector, const std::vector<double> & vecThresholds) {
+	std::vector<DependencyTree> sentences;
+	removeEmptyNodes(vecCorrects, sentences);
+
+	std::cout << "threshold\topen\tgold open\tUAS\tempty P\tempty R\tempty F\ttime(s)" << std::endl;
+	for (const auto & threshold : vecThresholds) {
+		bool gated = threshold >= 0.0 && detector;
+		parser->setEmptyDetector(gated ? detector : nullptr, threshold);
+
+		int nSlots = 0, nOpenSlots = 0, nGoldSlots = 0, nOpenGoldSlots = 0;
+		if (gated) {
+			Sentence sentence;
+			std::vector<std::pair<int, ttoken>> vecEmpties;
+			std::vector<double> vecProbabilities;
+			int nTags = detector->tags().size();
+			for (const auto & correct : vecCorrects) {
+				EmptyDetector::split(correct, sentence, vecEmpties);
+				detector->predict(sentence, vecProbabilities);
+				for (const auto & probability : vecProbabilities) {
+					nOpenSlots += probability >= threshold ? 1 : 0;
+				}
+				nSlots += vecProbabilities.size();
+				for (const auto & empty : vecEmpties) {
+					int t = std::find(detector->tags().begin(), detector->tags().end(), empty.second) - detector->tags().begin();
+					nOpenGoldSlots += t == nTags || vecProbabilities[empty.first * nTags + t] >= threshold ? 1 : 0;
+				}
+				nGoldSlots += vecEmpties.size();
+			}
+		}
+
+		EmptyScores scores;
+		double seconds = timeParse(parser, sentences, [&](const int & index, const DependencyTree & tree) {
+			scores.add(vecCorrects[index], tree);
+		});
+		if (gated) {
+			std::cout << threshold << "\t" << (nSlots == 0 ? 0.0 : (double)nOpenSlots / nSlots) << "\t" << (nGoldSlots == 0 ? 0.0 : (double)nOpenGoldSlots / nGoldSlots);
+		}
+		else {
+			std::cout << "off\t1\t1";
+		}
+		std::cout << "\t" << scores.uas() << "\t" << scores.precision() << "\t" << scores.recall() << "\t" << scores.f() << "\t" << seconds << std::endl;
+	}
+	parser->setEmptyDetector(nullptr, 0.0);
+}
+
+// decoding time of an empty decoder scoring its first-order empty beams,
+// filling a new cache with them (cold) and reading them back (warm)
+// sCacheFile is emptied first
+template<class DEP_PARSER>
+void benchmarkEmptyCache(DEP_PARSER * parser, const std::vector<DependencyTree> & vecCorrects, const std::string & sCacheFile, const std::string & sFingerprint) {
+	std::vector<DependencyTree> sentences;
+	removeEmptyNodes(vecCorrects, sentences);
+
+	std::remove(sCacheFile.c_str());
+	std::shared_ptr<ScoreCache> cache;
+	std::cout << "cache\tsentences\tUAS\tempty F\ttime(s)" << std::endl;
+	for (const std::string mode : { "off", "cold", "warm" }) {
+		if (mode == "cold") {
+			cache = ScoreCache::open(sCacheFile, sFingerprint);
+			if (cache == nullptr) {
+				std::cout << "cache " << sCacheFile << " can't be opened." << std::endl;
+				break;
+			}
+		}
+		parser->setEmptyCache(cache);
+
+		EmptyScores scores;
+		double seconds = timeParse(parser, sentences, [&](const int & index, const DependencyTree & tree) {
+			scores.add(vecCorrects[index], tree);
+		});
+		std::cout << mode << "\t" << (cache ? cache->size() : 0) << "\t" << scores.uas() << "\t" << scores.f() << "\t" << seconds << std::endl;
+	}
+	parser->setEmptyCache(nullptr);
+}
+
+// thresholds among the benchmark options, the curve starts without the detector
+inline void readThresholds(const std::vector<std::string> & vecOptions, std::vector<double> & vecThresholds) {
+	vecThresholds = { -1.0 };
+	for (const auto & option : vecOptions) {
+		// skip decoder options such as beam=k or detector=file
+		if (std::isdigit(option[0])) {
+			vecThresholds.push_back(std::atof(option.c_str()));
+		}
+	}
+	if (vecThresholds.size() == 1) {
+		vecThresholds.insert(vecThresholds.end(), { 0.5, 0.2, 0.1, 0.05, 0.02, 0.01 });
+	}
+}
+
+#endif
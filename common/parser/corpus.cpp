@@ -0,0 +1,426 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unordered_map>
+
+#include "corpus.h"
+#include "common/token/word.h"
+#include "common/token/pos.h"
+
+EncodedCorpus::EncodedCorpus() : m_vecOffsets(1, 0) {}
+
+EncodedCorpus::~EncodedCorpus() = default;
+
+void EncodedCorpus::clear() {
+	m_vecWords.clear();
+	m_vecPOSTags.clear();
+	m_vecHeads.clear();
+	m_vecOffsets.assign(1, 0);
+}
+
+void EncodedCorpus::push_back(const DependencyTree & tree) {
+	for (const auto & node : tree) {
+		m_vecWords.push_back(TWord::code(TREENODE_WORD(node)));
+		m_vecPOSTags.push_back(TPOSTag::code(TREENODE_POSTAG(node)));
+		m_vecHeads.push_back(TREENODE_HEAD(node));
+	}
+	m_vecOffsets.push_back(m_vecWords.size());
+}
+
+std::istream & operator>>(std::istream & input, EncodedCorpus & corpus) {
+	DependencyTree tree;
+	corpus.clear();
+	while (input >> tree) {
+		corpus.push_back(tree);
+	}
+	return input;
+}
+
+void EncodedCorpus::push_back(const int * words, const int * postags, const int * heads, const int & length) {
+	m_vecWords.insert(m_vecWords.end(), words, words + length);
+	m_vecPOSTags.insert(m_vecPOSTags.end(), postags, postags + length);
+	m_vecHeads.insert(m_vecHeads.end(), heads, heads + length);
+	m_vecOffsets.push_back(m_vecWords.size());
+}
+
+BinaryCorpus::BinaryCorpus() :
+	m_pData(nullptr), m_nBytes(0), m_bTree(false), m_nSentences(0), m_nTokens(0),
+	m_pOffsets(nullptr), m_pWords(nullptr), m_pPOSTags(nullptr), m_pHeads(nullptr), m_pLabels(nullptr) {}
+
+BinaryCorpus::~BinaryCorpus() {
+	close();
+}
+
+bool BinaryCorpus::open(const std::string & sFile) {
+	close();
+	int fd = ::open(sFile.c_str(), O_RDONLY);
+	if (fd == -1) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size < (off_t)(CORPUS_MAGIC_SIZE + 6 * sizeof(int))) {
+		::close(fd);
+		return false;
+	}
+	void * data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	m_pData = (char *)data;
+	m_nBytes = st.st_size;
+	if (memcmp(m_pData, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) != 0) {
+		close();
+		return false;
+	}
+
+	const int * header = (const int *)(m_pData + CORPUS_MAGIC_SIZE);
+	m_bTree = header[0] != 0;
+	m_nSentences = header[1];
+	m_nTokens = header[2];
+	int counts[3] = { header[3], header[4], header[5] };
+	std::vector<ttoken> * tables[3] = { &m_vecWords, &m_vecPOSTags, &m_vecLabels };
+
+	// a truncated or stale file must not make us read past the mapping
+	const char * ptr = (const char *)(header + 6);
+	const char * end = m_pData + m_nBytes;
+	auto fits = [&](const long long & bytes) { return bytes >= 0 && bytes <= end - ptr; };
+	if (m_nSentences < 0 || m_nTokens < 0 || counts[0] < 0 || counts[1] < 0 || counts[2] < 0) {
+		close();
+		return false;
+	}
+	for (int t = 0; t < 3; ++t) {
+		tables[t]->reserve(counts[t]);
+		for (int i = 0; i < counts[t]; ++i) {
+			if (!fits(sizeof(int))) {
+				close();
+				return false;
+			}
+			int length = *(const int *)ptr;
+			ptr += sizeof(int);
+			if (length < 0 || !fits(CORPUS_ALIGN((long long)length))) {
+				close();
+				return false;
+			}
+			tables[t]->push_back(ttoken(ptr, length));
+			ptr += CORPUS_ALIGN(length);
+		}
+	}
+	if (!fits(((long long)m_nSentences + 1 + 4LL * m_nTokens) * sizeof(int))) {
+		close();
+		return false;
+	}
+	m_pOffsets = (const int *)ptr;
+	m_pWords = m_pOffsets + m_nSentences + 1;
+	m_pPOSTags = m_pWords + m_nTokens;
+	m_pHeads = m_pPOSTags + m_nTokens;
+	m_pLabels = m_pHeads + m_nTokens;
+	if (m_pOffsets[0] != 0 || m_pOffsets[m_nSentences] != m_nTokens) {
+		close();
+		return false;
+	}
+	// nor may a mismatched one index past the sentences or the tables
+	for (int s = 0; s < m_nSentences; ++s) {
+		int begin = m_pOffsets[s], end = m_pOffsets[s + 1];
+		if (end < begin) {
+			close();
+			return false;
+		}
+		for (int i = begin; i < end; ++i) {
+			if (m_pWords[i] < 0 || m_pWords[i] >= counts[0] || m_pPOSTags[i] < 0 || m_pPOSTags[i] >= counts[1] ||
+				m_pLabels[i] < 0 || m_pLabels[i] >= counts[2] || m_pHeads[i] < -1 || m_pHeads[i] >= end - begin) {
+				close();
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void BinaryCorpus::close() {
+	if (m_pData != nullptr) {
+		munmap(m_pData, m_nBytes);
+	}
+	m_pData = nullptr;
+	m_nBytes = 0;
+	m_nSentences = m_nTokens = 0;
+	m_vecWords.clear();
+	m_vecPOSTags.clear();
+	m_vecLabels.clear();
+}
+
+void BinaryCorpus::tree(const int & index, DependencyTree & tree) const {
+	tree.clear();
+	for (int i = m_pOffsets[index], n = m_pOffsets[index + 1]; i < n; ++i) {
+		tree.push_back(DependencyTreeNode(POSTaggedWord(m_vecWords[m_pWords[i]], m_vecPOSTags[m_pPOSTags[i]]), m_pHeads[i], m_vecLabels[m_pLabels[i]]));
+	}
+}
+
+void BinaryCorpus::sentence(const int & index, Sentence & sentence) const {
+	sentence.clear();
+	for (int i = m_pOffsets[index], n = m_pOffsets[index + 1]; i < n; ++i) {
+		sentence.push_back(POSTaggedWord(m_vecWords[m_pWords[i]], m_vecPOSTags[m_pPOSTags[i]]));
+	}
+}
+
+void BinaryCorpus::encode(EncodedCorpus & corpus) const {
+	std::vector<int> words, postags;
+	for (const auto & word : m_vecWords) {
+		words.push_back(TWord::code(word));
+	}
+	for (const auto & postag : m_vecPOSTags) {
+		postags.push_back(TPOSTag::code(postag));
+	}
+
+	std::vector<int> vecWords, vecPOSTags;
+	corpus.clear();
+	for (int s = 0; s < m_nSentences; ++s) {
+		int offset = m_pOffsets[s], length = m_pOffsets[s + 1] - offset;
+		vecWords.resize(length);
+		vecPOSTags.resize(length);
+		for (int i = 0; i < length; ++i) {
+			vecWords[i] = words[m_pWords[offset + i]];
+			vecPOSTags[i] = postags[m_pPOSTags[offset + i]];
+		}
+		corpus.push_back(vecWords.data(), vecPOSTags.data(), m_pHeads + offset, length);
+	}
+}
+
+bool BinaryCorpus::isBinary(const std::string & sFile) {
+	char magic[CORPUS_MAGIC_SIZE];
+	std::ifstream input(sFile, std::ios::binary);
+	return input.read(magic, CORPUS_MAGIC_SIZE) && memcmp(magic, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) == 0;
+}
+
+bool BinaryCorpus::convert(const std::string & sInputFile, const std::string & sOutputFile, const bool & bTree) {
+	std::ifstream input(sInputFile);
+	if (!input) {
+		return false;
+	}
+
+	std::unordered_map<ttoken, int> maps[3];
+	std::vector<const ttoken *> tables[3];
+	std::vector<int> offsets(1, 0), words, postags, heads, labels;
+	auto lookup = [&maps, &tables](const int & t, const ttoken & key) {
+		auto itr = maps[t].find(key);
+		if (itr == maps[t].end()) {
+			itr = maps[t].insert(std::make_pair(key, (int)tables[t].size())).first;
+			tables[t].push_back(&itr->first);
+		}
+		return itr->second;
+	};
+
+	if (bTree) {
+		DependencyTree tree;
+		while (input >> tree) {
+			for (const auto & node : tree) {
+				words.push_back(lookup(0, TREENODE_WORD(node)));
+				postags.push_back(lookup(1, TREENODE_POSTAG(node)));
+				heads.push_back(TREENODE_HEAD(node));
+				labels.push_back(lookup(2, TREENODE_LABEL(node)));
+			}
+			offsets.push_back(words.size());
+		}
+	}
+	else {
+		Sentence sentence;
+		int null_label = lookup(2, NULL_LABEL);
+		while (input >> sentence) {
+			for (const auto & token : sentence) {
+				words.push_back(lookup(0, SENT_WORD(token)));
+				postags.push_back(lookup(1, SENT_POSTAG(token)));
+				heads.push_back(-1);
+				labels.push_back(null_label);
+			}
+			offsets.push_back(words.size());
+		}
+	}
+	input.close();
+
+	std::ofstream output(sOutputFile, std::ios::binary);
+	int header[6] = { bTree ? 1 : 0, (int)offsets.size() - 1, (int)words.size(), (int)tables[0].size(), (int)tables[1].size(), (int)tables[2].size() };
+	const char padding[sizeof(int)] = { 0 };
+	output.write(CORPUS_MAGIC, CORPUS_MAGIC_SIZE);
+	output.write((const char *)header, sizeof(header));
+	for (int t = 0; t < 3; ++t) {
+		for (const auto & key : tables[t]) {
+			int length = key->size();
+			output.write((const char *)&length, sizeof(int));
+			output.write(key->data(), length);
+			output.write(padding, CORPUS_ALIGN(length) - length);
+		}
+	}
+	for (const auto & vec : { &offsets, &words, &postags, &heads, &labels }) {
+		output.write((const char *)vec->data(), vec->size() * sizeof(int));
+	}
+	output.close();
+	return (bool)output;
+}
+
+CorpusReader::CorpusReader(const std::string & sFile) : m_bGood(false), m_bBinary(false), m_nIndex(0), m_pText(&m_iText) {
+	open(sFile);
+}
+
+CorpusReader::~CorpusReader() = default;
+
+void CorpusReader::open(const std::string & sFile) {
+	close();
+	if (sFile == CORPUS_STDIO) {
+		m_pText = &std::cin;
+		m_bGood = (bool)std::cin;
+		return;
+	}
+	m_pText = &m_iText;
+	m_bBinary = BinaryCorpus::isBinary(sFile);
+	if (m_bBinary) {
+		m_bGood = m_cBinary.open(sFile);
+		if (!m_bGood) {
+			std::cout << "binary corpus " << sFile << " is truncated or corrupt." << std::endl;
+		}
+	}
+	else {
+		m_iText.open(sFile);
+		m_bGood = (bool)m_iText;
+	}
+}
+
+void CorpusReader::close() {
+	m_iText.close();
+	m_iText.clear();
+	m_cBinary.close();
+	m_nIndex = 0;
+	m_bBinary = false;
+	m_bGood = false;
+}
+
+CorpusReader & operator>>(CorpusReader & input, Sentence & sentence) {
+	if (input.m_bBinary) {
+		if (input.m_nIndex < input.m_cBinary.size()) {
+			input.m_cBinary.sentence(input.m_nIndex++, sentence);
+		}
+		else {
+			input.m_bGood = false;
+		}
+	}
+	else {
+		input.m_bGood = (bool)(*input.m_pText >> sentence);
+	}
+	return input;
+}
+
+CorpusReader & operator>>(CorpusReader & input, DependencyTree & tree) {
+	if (input.m_bBinary) {
+		if (input.m_nIndex < input.m_cBinary.size()) {
+			input.m_cBinary.tree(input.m_nIndex++, tree);
+		}
+		else {
+			input.m_bGood = false;
+		}
+	}
+	else {
+		input.m_bGood = (bool)(*input.m_pText >> tree);
+	}
+	return input;
+}
+
+CorpusReader & operator>>(CorpusReader & input, EncodedCorpus & corpus) {
+	if (input.m_bBinary) {
+		input.m_cBinary.encode(corpus);
+	}
+	else {
+		*input.m_pText >> corpus;
+	}
+	input.m_bGood = false;
+	return input;
+}
+
+CorpusWriter::FileBuffer::FileBuffer() : m_nFile(-1) {}
+
+CorpusWriter::FileBuffer::~FileBuffer() {
+	close();
+}
+
+bool CorpusWriter::FileBuffer::open(const std::string & sFile, const int & nBufferSize) {
+	close();
+	if (sFile == CORPUS_STDIO) {
+		// trees keep stdout to themselves
+		std::cout.flush();
+		fflush(stdout);
+		m_nFile = dup(STDOUT_FILENO);
+		if (m_nFile != -1) {
+			dup2(STDERR_FILENO, STDOUT_FILENO);
+		}
+	}
+	else {
+		m_nFile = ::open(sFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+	m_vecBuffer.resize(std::max(nBufferSize, 1));
+	setp(m_vecBuffer.data(), m_vecBuffer.data() + m_vecBuffer.size());
+	return m_nFile != -1;
+}
+
+void CorpusWriter::FileBuffer::close() {
+	if (m_nFile != -1) {
+		writeOut();
+		::close(m_nFile);
+		m_nFile = -1;
+	}
+}
+
+bool CorpusWriter::FileBuffer::writeOut() {
+	const char * data = pbase();
+	while (data < pptr()) {
+		ssize_t n = ::write(m_nFile, data, pptr() - data);
+		if (n <= 0) {
+			if (n == -1 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += n;
+	}
+	setp(m_vecBuffer.data(), m_vecBuffer.data() + m_vecBuffer.size());
+	return true;
+}
+
+CorpusWriter::FileBuffer::int_type CorpusWriter::FileBuffer::overflow(int_type c) {
+	if (m_nFile == -1 || !writeOut()) {
+		return traits_type::eof();
+	}
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+	return traits_type::not_eof(c);
+}
+
+int CorpusWriter::FileBuffer::sync() {
+	return m_nFile != -1 && writeOut() ? 0 : -1;
+}
+
+CorpusWriter::CorpusWriter(const std::string & sFile, const int & nFlushTrees, const int & nBufferSize) : std::ostream(nullptr), m_nFlushTrees(nFlushTrees), m_nTrees(0) {
+	rdbuf(&m_cBuffer);
+	if (!m_cBuffer.open(sFile, nBufferSize)) {
+		setstate(std::ios::badbit);
+	}
+}
+
+CorpusWriter::~CorpusWriter() {
+	close();
+}
+
+void CorpusWriter::next() {
+	if (m_nFlushTrees > 0 && ++m_nTrees >= m_nFlushTrees) {
+		m_nTrees = 0;
+		flush();
+	}
+}
+
+void CorpusWriter::close() {
+	m_cBuffer.close();
+}
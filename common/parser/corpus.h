@@ -0,0 +1,196 @@
+#ifndef _CORPUS_H
+#define _CORPUS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+#include "macros_base.h"
+
+#define CORPUS_MAGIC		"XEBCORP1"
+#define CORPUS_MAGIC_SIZE	8
+#define CORPUS_ALIGN(X)		(((X) + 3) & ~3)
+// file name of stdin for readers and of stdout for writers
+#define CORPUS_STDIO		"-"
+#define CORPUS_FLUSH_TREES	1
+#define CORPUS_BUFFER_SIZE	(1 << 16)
+
+// view of one sentence stored in an EncodedCorpus
+class EncodedTree {
+private:
+	const int * m_pWords;
+	const int * m_pPOSTags;
+	const int * m_pHeads;
+	int m_nLength;
+
+public:
+	EncodedTree(const int * words, const int * postags, const int * heads, const int & length);
+	~EncodedTree();
+
+	const int & size() const;
+	const int & word(const int & i) const;
+	const int & postag(const int & i) const;
+	const int & head(const int & i) const;
+};
+
+// training trees with words and postags already coded by TWord / TPOSTag
+// must be filled after the model is loaded, or the tokenizer ids won't match
+class EncodedCorpus {
+private:
+	std::vector<int> m_vecWords;
+	std::vector<int> m_vecPOSTags;
+	std::vector<int> m_vecHeads;
+	std::vector<int> m_vecOffsets;
+
+public:
+	EncodedCorpus();
+	~EncodedCorpus();
+
+	void clear();
+	int size() const;
+	void push_back(const DependencyTree & tree);
+	void push_back(const int * words, const int * postags, const int * heads, const int & length);
+	EncodedTree operator[](const int & index) const;
+
+	friend std::istream & operator>>(std::istream & input, EncodedCorpus & corpus);
+};
+
+// pre-encoded corpus file written by convert()
+// the file keeps its own word / postag / label tables, every id is remapped
+// through the tokenizers once per type when the file is opened
+class BinaryCorpus {
+private:
+	char * m_pData;
+	std::size_t m_nBytes;
+
+	bool m_bTree;
+	int m_nSentences;
+	int m_nTokens;
+	const int * m_pOffsets;
+	const int * m_pWords;
+	const int * m_pPOSTags;
+	const int * m_pHeads;
+	const int * m_pLabels;
+
+	std::vector<ttoken> m_vecWords;
+	std::vector<ttoken> m_vecPOSTags;
+	std::vector<ttoken> m_vecLabels;
+
+public:
+	BinaryCorpus();
+	~BinaryCorpus();
+
+	bool open(const std::string & sFile);
+	void close();
+	int size() const;
+
+	void tree(const int & index, DependencyTree & tree) const;
+	void sentence(const int & index, Sentence & sentence) const;
+	void encode(EncodedCorpus & corpus) const;
+
+	static bool isBinary(const std::string & sFile);
+	static bool convert(const std::string & sInputFile, const std::string & sOutputFile, const bool & bTree);
+};
+
+// reads trees or sentences from either a text file, stdin or a binary corpus
+class CorpusReader {
+private:
+	bool m_bGood;
+	bool m_bBinary;
+	int m_nIndex;
+	std::ifstream m_iText;
+	std::istream * m_pText;
+	BinaryCorpus m_cBinary;
+
+public:
+	CorpusReader(const std::string & sFile);
+	~CorpusReader();
+
+	void open(const std::string & sFile);
+	void close();
+	explicit operator bool() const;
+
+	friend CorpusReader & operator>>(CorpusReader & input, Sentence & sentence);
+	friend CorpusReader & operator>>(CorpusReader & input, DependencyTree & tree);
+	friend CorpusReader & operator>>(CorpusReader & input, EncodedCorpus & corpus);
+};
+
+// writes trees to a text file, or to stdout for CORPUS_STDIO, through a
+// buffer of its own, the buffer goes out every nFlushTrees sentences (0 when
+// it is full only) so at most nBufferSize bytes of trees wait in memory
+// writing to stdout sends what the program logs there to stderr from then on
+class CorpusWriter : public std::ostream {
+private:
+	class FileBuffer : public std::streambuf {
+	private:
+		int m_nFile;
+		std::vector<char> m_vecBuffer;
+
+		bool writeOut();
+
+	protected:
+		int_type overflow(int_type c) override;
+		int sync() override;
+
+	public:
+		FileBuffer();
+		~FileBuffer();
+
+		bool open(const std::string & sFile, const int & nBufferSize);
+		void close();
+		bool good() const { return m_nFile != -1; }
+	};
+
+	FileBuffer m_cBuffer;
+	int m_nFlushTrees;
+	int m_nTrees;
+
+public:
+	CorpusWriter(const std::string & sFile, const int & nFlushTrees = CORPUS_FLUSH_TREES, const int & nBufferSize = CORPUS_BUFFER_SIZE);
+	~CorpusWriter();
+
+	// the trees of a sentence are written
+	void next();
+	void close();
+};
+
+inline EncodedTree::EncodedTree(const int * words, const int * postags, const int * heads, const int & length) :
+	m_pWords(words), m_pPOSTags(postags), m_pHeads(heads), m_nLength(length) {}
+
+inline EncodedTree::~EncodedTree() = default;
+
+inline const int & EncodedTree::size() const {
+	return m_nLength;
+}
+
+inline const int & EncodedTree::word(const int & i) const {
+	return m_pWords[i];
+}
+
+inline const int & EncodedTree::postag(const int & i) const {
+	return m_pPOSTags[i];
+}
+
+inline const int & EncodedTree::head(const int & i) const {
+	return m_pHeads[i];
+}
+
+inline int EncodedCorpus::size() const {
+	return m_vecOffsets.size() - 1;
+}
+
+inline EncodedTree EncodedCorpus::operator[](const int & index) const {
+	const int & offset = m_vecOffsets[index];
+	return EncodedTree(m_vecWords.data() + offset, m_vecPOSTags.data() + offset, m_vecHeads.data() + offset, m_vecOffsets[index + 1] - offset);
+}
+
+inline int BinaryCorpus::size() const {
+	return m_nSentences;
+}
+
+inline CorpusReader::operator bool() const {
+	return m_bGood;
+}
+
+#endif
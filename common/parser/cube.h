@@ -0,0 +1,50 @@
+#ifndef _CUBE_H
+#define _CUBE_H
+
+#include <queue>
+#include <tuple>
+#include <vector>
+
+#include "include/learning/perceptron/score.h"
+
+// one row of a beam combination: the items of a sorted beam on top of a base
+// score, split and type are left to the decoder
+template<typename BEAM>
+struct BeamRow {
+	int split;
+	int type;
+	tscore base;
+	const BEAM * beam;
+
+	BeamRow(const int & s, const int & t, const tscore & b, const BEAM * bm) : split(s), type(t), base(b), beam(bm) {}
+};
+
+// lazy best-first combination of beam rows (cube pruning)
+// every row enters the frontier with its best item, a popped candidate is
+// replaced by the next item of its row, and only nPop candidates are popped
+// so rows + nPop candidates are scored instead of every item of every row
+// score(row, index) gives the full score of an item, accept(row, index, score)
+// takes the popped ones
+template<typename ROW, typename SCORE_FUNC, typename ACCEPT_FUNC>
+void cubePrune(const std::vector<ROW> & vecRows, const int & nPop, SCORE_FUNC score, ACCEPT_FUNC accept) {
+	// (score, -row, index), ties go to the earlier row
+	std::priority_queue<std::tuple<tscore, int, int>> frontier;
+	for (int r = 0; r < (int)vecRows.size(); ++r) {
+		if (vecRows[r].beam->size() > 0) {
+			frontier.push(std::make_tuple(score(vecRows[r], 0), -r, 0));
+		}
+	}
+	for (int n = 0; n < nPop && !frontier.empty(); ++n) {
+		tscore best;
+		int r, index;
+		std::tie(best, r, index) = frontier.top();
+		frontier.pop();
+		const ROW & row = vecRows[-r];
+		accept(row, index, best);
+		if (index + 1 < row.beam->size()) {
+			frontier.push(std::make_tuple(score(row, index + 1), r, index + 1));
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef _DEADLINE_H
+#define _DEADLINE_H
+
+#include <chrono>
+
+// time budget of the sentence being decoded, in milliseconds, 0 for none
+// decoders ask expired() between the span widths of their chart and finish
+// a sentence whose budget is spent with a cheaper decoder
+class Deadline {
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	double m_dBudget;
+	bool m_bRunning;
+	bool m_bMissed;
+	Clock::time_point m_tEnd;
+
+public:
+	Deadline() : m_dBudget(0.0), m_bRunning(false), m_bMissed(false) {}
+	~Deadline() = default;
+
+	void setBudget(const double & dMilliseconds) { m_dBudget = dMilliseconds; }
+	const double & budget() const { return m_dBudget; }
+
+	// the budget of a sentence runs from start() to stop()
+	void start() {
+		m_bMissed = false;
+		m_bRunning = m_dBudget > 0.0;
+		if (m_bRunning) {
+			m_tEnd = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(m_dBudget));
+		}
+	}
+	void stop() { m_bRunning = false; }
+
+	// once true it stays true until the next start()
+	bool expired() {
+		if (m_bRunning && !m_bMissed && Clock::now() >= m_tEnd) {
+			m_bMissed = true;
+		}
+		return m_bRunning && m_bMissed;
+	}
+	// the last sentence ran out of its budget
+	const bool & missed() const { return m_bMissed; }
+};
+
+#endif
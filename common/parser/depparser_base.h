@@ -3,6 +3,7 @@
 
 #include "include/learning/perceptron/score.h"
 #include "common/parser/weight_base.h"
+#include "common/parser/deadline.h"
 
 enum ParserState {
 	TRAIN = 1,
@@ -13,6 +14,7 @@ enum ParserState {
 class DepParserBase {
 protected:
 	int m_nState;
+	Deadline m_cDeadline;
 
 public:
 	int m_nTotalErrors;
@@ -23,6 +25,12 @@ public:
 	DepParserBase(int nState) :
 		m_nState(nState), m_nTotalErrors(0), m_nScoreIndex(nState == ParserState::TRAIN ? ScoreType::eNonAverage : ScoreType::eAverage), m_nTrainingRound(0) {}
 	~DepParserBase() {};
+
+	// decoders with a cheaper fallback finish sentences taking longer than
+	// dMilliseconds with it, 0 lets every sentence take its time
+	void setBudget(const double & dMilliseconds) { m_cDeadline.setBudget(dMilliseconds); }
+	// the last sentence was finished by the fallback
+	bool degraded() const { return m_cDeadline.missed(); }
 };
 
 #endif
@@ -0,0 +1,130 @@
+#ifndef _EMPTY_BEAMS_H
+#define _EMPTY_BEAMS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "agenda.h"
+#include "score_cache.h"
+#include "macros_base.h"
+#include "common/token/emp.h"
+
+// first-order beams of empty node candidates, the (head, gap, category)
+// scores every empty decoder builds before decoding a sentence
+// with a fixed model they only depend on the words and tags, so when parsing
+// they are kept in a ScoreCache keyed by the sentence and read back instead
+// of scoring every slot again
+// a parser calls begin() per sentence, then for every beam in a fixed order
+// either read() when cached() or write() after scoring it, and end()
+// a record is the sentence length and the number of beams, then each beam
+// flattened as its size followed by (category, score) pairs
+// a record that doesn't fit the sentence, e.g. after a key collision or from
+// a truncated or stale file, is scored again and replaced, and a read() that
+// doesn't fit its beam fails and leaves the rest of the sentence to scoring
+class EmptyBeams {
+private:
+	std::shared_ptr<ScoreCache> m_pCache;
+	std::uint64_t m_nKey;
+	// next score to read, -1 while the beams are scored
+	int m_nIndex;
+	bool m_bRecord;
+	std::vector<tscore> m_vecScores;
+
+	// the beams of the record are all complete and the categories valid
+	bool valid(const int & nLength) const {
+		if (m_vecScores.size() < 2 || m_vecScores[0] != nLength || m_vecScores[1] < 0) {
+			return false;
+		}
+		tscore nBeams = m_vecScores[1], size = m_vecScores.size();
+		tscore index = 2;
+		for (tscore b = 0; b < nBeams; ++b) {
+			if (index >= size || m_vecScores[index] < 0 || m_vecScores[index] > (size - index - 1) / 2) {
+				return false;
+			}
+			for (tscore end = index + 1 + 2 * m_vecScores[index], i = index + 1; i < end; i += 2) {
+				if (m_vecScores[i] < TEmptyTag::start() || m_vecScores[i] >= TEmptyTag::end()) {
+					return false;
+				}
+			}
+			index += 1 + 2 * m_vecScores[index];
+		}
+		return index == size;
+	}
+
+public:
+	EmptyBeams() : m_nKey(0), m_nIndex(-1), m_bRecord(false) {}
+	~EmptyBeams() = default;
+
+	void setCache(const std::shared_ptr<ScoreCache> & pCache) { m_pCache = pCache; }
+
+	// bUse is false when the beams depend on more than the sentence,
+	// e.g. slots closed by an empty detector
+	void begin(const Sentence & sentence, const bool & bUse = true) {
+		m_nIndex = -1;
+		m_bRecord = false;
+		if (!m_pCache || !bUse) {
+			return;
+		}
+		m_nKey = SCORE_CACHE_HASH_SEED;
+		for (const auto & token : sentence) {
+			m_nKey = ScoreCache::hash(SENT_WORD(token), m_nKey);
+			m_nKey = ScoreCache::hash(SENT_POSTAG(token), m_nKey);
+		}
+		if (m_pCache->find(m_nKey, m_vecScores) && valid(sentence.size())) {
+			m_nIndex = 2;
+		}
+		else {
+			m_vecScores.assign(2, 0);
+			m_vecScores[0] = sentence.size();
+			m_bRecord = true;
+		}
+	}
+
+	bool cached() const { return m_nIndex >= 0; }
+
+	// false when the record has no such beam or it holds more than SIZE items
+	template<int SIZE>
+	bool read(AgendaBeam<ScoreWithType, SIZE> & beam) {
+		beam.clear();
+		if (m_nIndex < 0 || m_nIndex >= (int)m_vecScores.size() || m_vecScores[m_nIndex] > SIZE) {
+			m_nIndex = -1;
+			return false;
+		}
+		// items come sorted, inserting them in order keeps the order of ties
+		for (int size = m_vecScores[m_nIndex++]; size > 0; --size, m_nIndex += 2) {
+			beam.insertItem(ScoreWithType(m_vecScores[m_nIndex], m_vecScores[m_nIndex + 1]));
+		}
+		return true;
+	}
+
+	template<int SIZE>
+	void write(const AgendaBeam<ScoreWithType, SIZE> & beam) {
+		if (!m_bRecord) {
+			return;
+		}
+		++m_vecScores[1];
+		m_vecScores.push_back(beam.size());
+		for (const auto & item : beam) {
+			m_vecScores.push_back(item->getType());
+			m_vecScores.push_back(item->getScore());
+		}
+	}
+
+	void end() {
+		if (m_bRecord) {
+			// replacing the record of the key, if one didn't fit
+			m_pCache->insert(m_nKey, m_vecScores, true);
+			m_bRecord = false;
+		}
+		m_nIndex = -1;
+	}
+
+	// the beams depend on the model, the decoder scoring them and their width
+	static std::string fingerprint(const std::string & sDecoder, const std::string & sFeatureFile, const int & nSize) {
+		return sDecoder + "/" + std::to_string(nSize) + "/" + ScoreCache::fingerprint({ sFeatureFile });
+	}
+};
+
+#endif
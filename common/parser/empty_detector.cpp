@@ -0,0 +1,185 @@
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#include "corpus.h"
+#include "score_cache.h"
+#include "empty_detector.h"
+#include "common/token/emp.h"
+
+EmptyDetector::EmptyDetector() = default;
+
+EmptyDetector::~EmptyDetector() = default;
+
+void EmptyDetector::features(const Sentence & sentence, const int & gap, std::vector<std::uint64_t> & vecFeatures) const {
+	int n = sentence.size();
+	auto word = [&](const int & i) -> const ttoken & {
+		static const ttoken start = START_WORD, end = END_WORD;
+		return i < 0 ? start : i >= n ? end : SENT_WORD(sentence[i]);
+	};
+	auto tag = [&](const int & i) -> const ttoken & {
+		static const ttoken start = START_POSTAG, end = END_POSTAG;
+		return i < 0 ? start : i >= n ? end : SENT_POSTAG(sentence[i]);
+	};
+
+	vecFeatures.clear();
+	vecFeatures.push_back(ScoreCache::hash("b"));
+	vecFeatures.push_back(ScoreCache::hash(word(gap - 1), ScoreCache::hash("w-1")));
+	vecFeatures.push_back(ScoreCache::hash(word(gap), ScoreCache::hash("w0")));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap - 1), ScoreCache::hash("t-1")));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap), ScoreCache::hash("t0")));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap + 1), ScoreCache::hash("t1")));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap - 1), ScoreCache::hash(tag(gap - 2), ScoreCache::hash("t-2t-1"))));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap), ScoreCache::hash(tag(gap - 1), ScoreCache::hash("t-1t0"))));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap + 1), ScoreCache::hash(tag(gap), ScoreCache::hash("t0t1"))));
+	vecFeatures.push_back(ScoreCache::hash(tag(gap), ScoreCache::hash(word(gap - 1), ScoreCache::hash("w-1t0"))));
+	vecFeatures.push_back(ScoreCache::hash(word(gap), ScoreCache::hash(tag(gap - 1), ScoreCache::hash("t-1w0"))));
+}
+
+double EmptyDetector::probability(const std::vector<std::uint64_t> & vecFeatures, const int & tag) const {
+	double score = 0.0;
+	for (const auto & feature : vecFeatures) {
+		auto itr = m_mapWeights.find(feature);
+		if (itr != m_mapWeights.end()) {
+			score += itr->second[tag];
+		}
+	}
+	return 1.0 / (1.0 + std::exp(-score));
+}
+
+void EmptyDetector::train(const std::string & sInputFile, const int & nIterations) {
+	DependencyTree tree;
+	std::vector<Sentence> sentences;
+	std::vector<std::vector<std::pair<int, ttoken>>> empties;
+	std::unordered_map<ttoken, int> mapTags;
+
+	CorpusReader input(sInputFile);
+	while (input >> tree) {
+		sentences.push_back(Sentence());
+		empties.push_back(std::vector<std::pair<int, ttoken>>());
+		split(tree, sentences.back(), empties.back());
+		for (const auto & empty : empties.back()) {
+			if (mapTags.find(empty.second) == mapTags.end()) {
+				mapTags[empty.second] = m_vecTags.size();
+				m_vecTags.push_back(empty.second);
+			}
+		}
+	}
+	input.close();
+
+	std::vector<std::uint64_t> vecFeatures;
+	std::vector<bool> vecGold;
+	int nTags = m_vecTags.size();
+	for (int iteration = 0; iteration < nIterations; ++iteration) {
+		double rate = EMPTY_DETECTOR_RATE / (1 + iteration);
+		double loss = 0.0;
+		for (std::size_t i = 0; i < sentences.size(); ++i) {
+			int n = sentences[i].size();
+			vecGold.assign((n + 1) * nTags, false);
+			for (const auto & empty : empties[i]) {
+				vecGold[empty.first * nTags + mapTags[empty.second]] = true;
+			}
+			for (int gap = 0; gap <= n; ++gap) {
+				features(sentences[i], gap, vecFeatures);
+				for (int t = 0; t < nTags; ++t) {
+					double p = probability(vecFeatures, t);
+					double y = vecGold[gap * nTags + t] ? 1.0 : 0.0;
+					loss -= std::log(y > 0.5 ? p : 1.0 - p);
+					for (const auto & feature : vecFeatures) {
+						auto & weights = m_mapWeights[feature];
+						weights.resize(nTags, 0.0f);
+						weights[t] += rate * (y - p);
+					}
+				}
+			}
+		}
+		std::cout << "detector iteration " << iteration + 1 << " loss " << loss << std::endl;
+	}
+}
+
+bool EmptyDetector::load(const std::string & sFile) {
+	std::ifstream input(sFile);
+	int nTags = 0;
+	if (!(input >> nTags)) {
+		return false;
+	}
+	m_vecTags.resize(nTags);
+	for (auto & tag : m_vecTags) {
+		input >> tag;
+	}
+	std::uint64_t feature;
+	while (input >> feature) {
+		auto & weights = m_mapWeights[feature];
+		weights.resize(nTags);
+		for (auto & weight : weights) {
+			input >> weight;
+		}
+	}
+	return !m_vecTags.empty();
+}
+
+bool EmptyDetector::save(const std::string & sFile) const {
+	std::ofstream output(sFile);
+	output << m_vecTags.size() << std::endl;
+	for (const auto & tag : m_vecTags) {
+		output << tag << std::endl;
+	}
+	for (const auto & weights : m_mapWeights) {
+		output << weights.first;
+		for (const auto & weight : weights.second) {
+			output << " " << weight;
+		}
+		output << std::endl;
+	}
+	return (bool)output;
+}
+
+void EmptyDetector::predict(const Sentence & sentence, std::vector<double> & vecProbabilities) const {
+	std::vector<std::uint64_t> vecFeatures;
+	int n = sentence.size(), nTags = m_vecTags.size();
+	vecProbabilities.resize((n + 1) * nTags);
+	for (int gap = 0; gap <= n; ++gap) {
+		features(sentence, gap, vecFeatures);
+		for (int t = 0; t < nTags; ++t) {
+			vecProbabilities[gap * nTags + t] = probability(vecFeatures, t);
+		}
+	}
+}
+
+void EmptyDetector::gate(const Sentence & sentence, const double & dThreshold, std::vector<bool> & vecOpen) const {
+	std::vector<double> vecProbabilities;
+	predict(sentence, vecProbabilities);
+	int n = sentence.size(), nTags = m_vecTags.size();
+	vecOpen.assign((n + 1) * MAX_EMPTYTAG_SIZE, true);
+	for (int t = 0; t < nTags; ++t) {
+		int code = TEmptyTag::getTokenizer().find(m_vecTags[t], -1);
+		if (code < 0 || code >= MAX_EMPTYTAG_SIZE) {
+			continue;
+		}
+		for (int gap = 0; gap <= n; ++gap) {
+			vecOpen[gap * MAX_EMPTYTAG_SIZE + code] = vecProbabilities[gap * nTags + t] >= dThreshold;
+		}
+	}
+}
+
+void EmptyDetector::split(const DependencyTree & tree, Sentence & sentence, std::vector<std::pair<int, ttoken>> & vecEmpties) {
+	sentence.clear();
+	vecEmpties.clear();
+	for (const auto & node : tree) {
+		if (TREENODE_POSTAG(node) == EMPTY_NODE_POSTAG) {
+			vecEmpties.push_back(std::make_pair((int)sentence.size(), TREENODE_WORD(node)));
+		}
+		else {
+			sentence.push_back(TREENODE_POSTAGGEDWORD(node));
+		}
+	}
+}
+
+std::shared_ptr<const EmptyDetector> EmptyDetector::open(const std::string & sFile) {
+	std::shared_ptr<EmptyDetector> detector(new EmptyDetector());
+	if (!detector->load(sFile)) {
+		std::cout << "empty detector " << sFile << " can't be loaded." << std::endl;
+		return nullptr;
+	}
+	return detector;
+}
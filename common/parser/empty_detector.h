@@ -0,0 +1,53 @@
+#ifndef _EMPTY_DETECTOR_H
+#define _EMPTY_DETECTOR_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "macros_base.h"
+
+#define EMPTY_NODE_POSTAG			"EMCAT"
+#define EMPTY_DETECTOR_ITERATION	10
+#define EMPTY_DETECTOR_RATE			0.1
+#define EMPTY_DETECTOR_THRESHOLD	0.05
+
+// linear classifier telling which gaps of a sentence may host which empty
+// categories, so the empty decoders only open slots where it is likely
+// gap g lies before word g, gap n after the last word
+// every category has its own logistic regression over the words and tags
+// around the gap, trained on gold trees with EMPTY_NODE_POSTAG nodes
+class EmptyDetector {
+private:
+	std::vector<ttoken> m_vecTags;
+	// feature -> weight of every category
+	std::unordered_map<std::uint64_t, std::vector<float>> m_mapWeights;
+
+	void features(const Sentence & sentence, const int & gap, std::vector<std::uint64_t> & vecFeatures) const;
+	double probability(const std::vector<std::uint64_t> & vecFeatures, const int & tag) const;
+
+public:
+	EmptyDetector();
+	~EmptyDetector();
+
+	const std::vector<ttoken> & tags() const { return m_vecTags; }
+
+	void train(const std::string & sInputFile, const int & nIterations);
+	bool load(const std::string & sFile);
+	bool save(const std::string & sFile) const;
+
+	// probabilities[gap * tags().size() + tag]
+	void predict(const Sentence & sentence, std::vector<double> & vecProbabilities) const;
+	// vecOpen[gap * MAX_EMPTYTAG_SIZE + TEmptyTag code] is false where the
+	// probability is under dThreshold, categories the detector never saw stay open
+	void gate(const Sentence & sentence, const double & dThreshold, std::vector<bool> & vecOpen) const;
+
+	// words of a gold tree and its empty nodes as (gap, category)
+	static void split(const DependencyTree & tree, Sentence & sentence, std::vector<std::pair<int, ttoken>> & vecEmpties);
+	// nullptr if the file can't be read
+	static std::shared_ptr<const EmptyDetector> open(const std::string & sFile);
+};
+
+#endif
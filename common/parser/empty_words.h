@@ -0,0 +1,76 @@
+#ifndef _EMPTY_WORDS_H
+#define _EMPTY_WORDS_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "common/token/word.h"
+#include "common/token/pos.h"
+#include "common/token/emp.h"
+
+#define UNKNOWN_EMPTY_WORD	"-UNKNOWN-EMPTY-"
+
+// word and postag codes of empty nodes
+// the word of an empty node is a string built from its category and the
+// words around it, it is only built and looked up the first time a
+// (category, left, right) tuple is seen, later sentences stay on integers
+// without bGrow (parsing) tuples missing from the vocabulary share one
+// unknown code instead of adding words the model has no weights for
+// reserve() codes the unknown word and the postags of the empty categories
+// once the model has loaded, parsing then only looks codes up, so parsers on
+// several threads never add to the tokenizers they share
+class EmptyWords {
+private:
+	bool m_bGrow;
+	int m_nUnknown;
+	// per category, left << 32 | right -> word code
+	std::vector<std::unordered_map<std::uint64_t, int>> m_vecWords;
+	std::vector<int> m_vecPOSTags;
+
+public:
+	EmptyWords(const bool & bGrow) : m_bGrow(bGrow), m_nUnknown(0) {}
+	~EmptyWords() = default;
+
+	// left and right identify the neighbours, key() builds the word on a miss
+	template<class KEY_FUNC>
+	int word(const int & tag, const int & left, const int & right, KEY_FUNC key) {
+		if (tag >= (int)m_vecWords.size()) {
+			m_vecWords.resize(tag + 1);
+		}
+		std::uint64_t tuple = ((std::uint64_t)(std::uint32_t)left << 32) | (std::uint32_t)right;
+		auto itr = m_vecWords[tag].find(tuple);
+		if (itr == m_vecWords[tag].end()) {
+			int code;
+			if (m_bGrow) {
+				code = TWord::code(key());
+			}
+			else {
+				code = TWord::getTokenizer().find(key(), m_nUnknown);
+			}
+			itr = m_vecWords[tag].insert(std::make_pair(tuple, code)).first;
+		}
+		return itr->second;
+	}
+
+	void reserve() {
+		if (!m_bGrow) {
+			m_nUnknown = TWord::code(UNKNOWN_EMPTY_WORD);
+		}
+		for (int tag = TEmptyTag::start(), max_tag = TEmptyTag::end(); tag < max_tag; ++tag) {
+			postag(tag);
+		}
+	}
+
+	int postag(const int & tag) {
+		if (tag >= (int)m_vecPOSTags.size()) {
+			m_vecPOSTags.resize(tag + 1, 0);
+		}
+		if (m_vecPOSTags[tag] == 0) {
+			m_vecPOSTags[tag] = TPOSTag::code(TEmptyTag::key(tag));
+		}
+		return m_vecPOSTags[tag];
+	}
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef _EPOCHS_H
+#define _EPOCHS_H
+
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <random>
+#include <string>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+
+#define SHUFFLE_SEED	20160421
+
+// run several epochs over an in-memory corpus with one parser
+// rounds keep counting across epochs, so the averaged weights saved after
+// epoch i equal the ones the per-process training loop writes at iteration i
+// an empty output name means the epoch is not saved
+template<class DEP_PARSER, class CORPUS>
+void trainEpochs(DEP_PARSER * parser, const CORPUS & corpus, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle) {
+	int nRound = 0;
+	std::vector<int> vecOrder(corpus.size());
+	std::iota(vecOrder.begin(), vecOrder.end(), 0);
+	std::mt19937 generator(SHUFFLE_SEED);
+
+	for (std::size_t epoch = 0; epoch < vecFeatureOutput.size(); ++epoch) {
+		std::cout << "Training iteration " << epoch + 1 << " is started..." << std::endl;
+
+		auto time_begin = time(NULL);
+
+		if (bShuffle) {
+			std::shuffle(vecOrder.begin(), vecOrder.end(), generator);
+		}
+		parser->m_nTotalErrors = 0;
+		for (const auto & index : vecOrder) {
+			parser->train(corpus[index], ++nRound);
+		}
+		if (!vecFeatureOutput[epoch].empty()) {
+			parser->finishtraining(vecFeatureOutput[epoch]);
+		}
+		else {
+			std::cout << "Total number of training errors are: " << parser->m_nTotalErrors << std::endl;
+		}
+
+		auto time_end = time(NULL);
+
+		std::cout << "Iteration " << epoch + 1 << " has finished. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
+	}
+}
+
+// iterative parameter mixing over worker parsers
+// every nMixStep sentences (0 for once per epoch) the workers get a copy of the
+// shared model, train on interleaved shards in their own threads, and what
+// each of them learned is added back to the shared model
+// the sum is kept rather than the mean, weights are integers and dividing
+// them by the number of workers rounds most updates of a short period away
+// sentence i of a shard keeps the round it would have had sequentially, and
+// all copies are averaged to the last round before mixing, so the averaged
+// weights stay consistent with the round counter
+template<class DEP_PARSER, class CORPUS>
+void trainEpochs(DEP_PARSER * parser, std::vector<std::unique_ptr<DEP_PARSER>> & workers, const CORPUS & corpus, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nMixStep) {
+	int nRound = 0;
+	int nWorkers = workers.size();
+	int nSentences = corpus.size();
+	int nStep = nMixStep > 0 ? nMixStep : nSentences;
+	std::vector<int> vecOrder(nSentences);
+	std::iota(vecOrder.begin(), vecOrder.end(), 0);
+	std::mt19937 generator(SHUFFLE_SEED);
+
+	for (std::size_t epoch = 0; epoch < vecFeatureOutput.size(); ++epoch) {
+		std::cout << "Training iteration " << epoch + 1 << " is started with " << nWorkers << " workers..." << std::endl;
+
+		auto time_begin = time(NULL);
+
+		if (bShuffle) {
+			std::shuffle(vecOrder.begin(), vecOrder.end(), generator);
+		}
+		for (auto & worker : workers) {
+			worker->m_nTotalErrors = 0;
+		}
+		for (int begin = 0; begin < nSentences; begin += nStep) {
+			int end = std::min(nSentences, begin + nStep);
+
+			std::vector<std::thread> threads;
+			for (int t = 0; t < nWorkers; ++t) {
+				threads.push_back(std::thread([&, t]() {
+					workers[t]->referScores(*parser);
+					for (int i = begin + t; i < end; i += nWorkers) {
+						workers[t]->train(corpus[vecOrder[i]], nRound + i - begin + 1);
+					}
+				}));
+			}
+			for (auto & thread : threads) {
+				thread.join();
+			}
+
+			nRound += end - begin;
+			parser->averageScores(nRound);
+			for (auto & worker : workers) {
+				worker->averageScores(nRound);
+			}
+			for (int t = 1; t < nWorkers; ++t) {
+				workers[0]->mixScores(*parser, *workers[t]);
+			}
+			parser->referScores(*workers[0]);
+			parser->m_nTrainingRound = nRound;
+		}
+
+		parser->m_nTotalErrors = 0;
+		for (auto & worker : workers) {
+			parser->m_nTotalErrors += worker->m_nTotalErrors;
+		}
+		if (!vecFeatureOutput[epoch].empty()) {
+			parser->finishtraining(vecFeatureOutput[epoch]);
+		}
+		else {
+			std::cout << "Total number of training errors are: " << parser->m_nTotalErrors << std::endl;
+		}
+
+		auto time_end = time(NULL);
+
+		std::cout << "Iteration " << epoch + 1 << " has finished. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
+	}
+}
+
+#endif
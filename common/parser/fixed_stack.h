@@ -0,0 +1,32 @@
+#ifndef _FIXED_STACK_H
+#define _FIXED_STACK_H
+
+#include "macros_base.h"
+
+// pending spans of a backtrack hold interior-disjoint pieces of the
+// sentence, with empty nodes at most twice as many positions, so this bound
+// covers every decoder with room to spare
+#define BACKTRACK_STACK_SIZE	(MAX_SENTENCE_SIZE << 2)
+
+// stack of at most SIZE items stored inline, so backtracking a chart never
+// touches the heap, the interface is the part of std::stack decoders use
+template<typename T, int SIZE = BACKTRACK_STACK_SIZE>
+class FixedStack {
+private:
+	int m_nSize;
+	T m_lItems[SIZE];
+
+public:
+	FixedStack() : m_nSize(0) {}
+	~FixedStack() = default;
+
+	bool empty() const { return m_nSize == 0; }
+	int size() const { return m_nSize; }
+	void clear() { m_nSize = 0; }
+
+	void push(const T & item) { m_lItems[m_nSize++] = item; }
+	void pop() { --m_nSize; }
+	const T & top() const { return m_lItems[m_nSize - 1]; }
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include <cmath>
+#include <algorithm>
+#include <unordered_set>
+
+#include "cle_depparser.h"
+#include "common/token/word.h"
+#include "common/token/pos.h"
+
+namespace cle {
+	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
+		DepParserBase(nState), m_cEngine(*this) {
+
+		m_nSentenceLength = 0;
+
+		m_pWeight = new Weight1st(sFeatureInput, sFeatureOut, m_nScoreIndex);
+
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+
+		m_pWeight->init(empty_taggedword, start_taggedword, end_taggedword);
+	}
+
+	DepParser::~DepParser() {
+		delete m_pWeight;
+	}
+
+	void DepParser::train(const DependencyTree & correct, const int & round) {
+		// initialize
+		int idx = 0;
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		for (const auto & node : correct) {
+			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
+			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
+		}
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
+
+		if (m_nState == ParserState::GOLDTEST) {
+			m_setFirstGoldScore.clear();
+			for (const auto & arc : m_vecCorrectArcs) {
+				m_setFirstGoldScore.insert(BiGram<int>(arc.first() == -1 ? m_nSentenceLength : arc.first(), arc.second()));
+			}
+		}
+
+		// train
+		m_pWeight->referRound(round);
+		work(nullptr, correct);
+		if (m_nTrainingRound % OUTPUT_STEP == 0) {
+			std::cout << m_nTotalErrors << " / " << m_nTrainingRound << std::endl;
+		}
+	}
+
+	void DepParser::parse(const Sentence & sentence, DependencyTree * retval) {
+		int idx = 0;
+		m_nTrainingRound = 0;
+		DependencyTree correct;
+		m_nSentenceLength = sentence.size();
+		for (const auto & token : sentence) {
+			m_lSentence[idx++].refer(TWord::code(SENT_WORD(token)), TPOSTag::code(SENT_POSTAG(token)));
+			correct.push_back(DependencyTreeNode(token, -1, NULL_LABEL));
+		}
+		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		work(retval, correct);
+	}
+
+	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
+
+		decode();
+
+		decodeArcs();
+
+		switch (m_nState) {
+		case ParserState::TRAIN:
+			update();
+			break;
+		case ParserState::PARSE:
+			generate(retval, correct);
+			break;
+		case ParserState::GOLDTEST:
+			goldCheck();
+			break;
+		default:
+			break;
+		}
+	}
+
+	void DepParser::update() {
+		std::unordered_set<Arc> positiveArcs;
+		positiveArcs.insert(m_vecCorrectArcs.begin(), m_vecCorrectArcs.end());
+		for (const auto & arc : m_vecTrainArcs) {
+			positiveArcs.erase(arc);
+		}
+		std::unordered_set<Arc> negativeArcs;
+		negativeArcs.insert(m_vecTrainArcs.begin(), m_vecTrainArcs.end());
+		for (const auto & arc : m_vecCorrectArcs) {
+			negativeArcs.erase(arc);
+		}
+		if (!positiveArcs.empty() || !negativeArcs.empty()) {
+			++m_nTotalErrors;
+		}
+		for (const auto & arc : positiveArcs) {
+			getOrUpdateStackScore(arc.first() == -1 ? m_nSentenceLength : arc.first(), arc.second(), 1);
+		}
+
+		for (const auto & arc : negativeArcs) {
+			getOrUpdateStackScore(arc.first() == -1 ? m_nSentenceLength : arc.first(), arc.second(), -1);
+		}
+	}
+
+	void DepParser::generate(DependencyTree * retval, const DependencyTree & correct) {
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			retval->push_back(DependencyTreeNode(TREENODE_POSTAGGEDWORD(correct[i]), -1, NULL_LABEL));
+		}
+		for (const auto & arc : m_vecTrainArcs) {
+			TREENODE_HEAD(retval->at(arc.second())) = arc.first();
+		}
+	}
+
+	void DepParser::goldCheck() {
+		if (m_vecCorrectArcs.size() != m_vecTrainArcs.size() || m_cEngine.score() / GOLD_POS_SCORE != (tscore)m_vecTrainArcs.size()) {
+			std::cout << "gold parse len error at " << m_nTrainingRound << std::endl;
+			std::cout << "score is " << m_cEngine.score() << std::endl;
+			std::cout << "len is " << m_vecTrainArcs.size() << std::endl;
+			++m_nTotalErrors;
+		}
+		else {
+			int i = 0;
+			std::sort(m_vecCorrectArcs.begin(), m_vecCorrectArcs.end(), [](const Arc & arc1, const Arc & arc2){ return arc1 < arc2; });
+			std::sort(m_vecTrainArcs.begin(), m_vecTrainArcs.end(), [](const Arc & arc1, const Arc & arc2){ return arc1 < arc2; });
+			for (int n = m_vecCorrectArcs.size(); i < n; ++i) {
+				if (m_vecCorrectArcs[i].first() != m_vecTrainArcs[i].first() || m_vecCorrectArcs[i].second() != m_vecTrainArcs[i].second()) {
+					break;
+				}
+			}
+			if (i != (int)m_vecCorrectArcs.size()) {
+				std::cout << "gold parse tree error at " << m_nTrainingRound << std::endl;
+				++m_nTotalErrors;
+			}
+		}
+	}
+
+	tscore DepParser::arcScore(const int & p, const int & c) {
+		if (m_nState == ParserState::GOLDTEST) {
+			m_nRetval = m_setFirstGoldScore.find(BiGram<int>(p, c)) == m_setFirstGoldScore.end() ? GOLD_NEG_SCORE : GOLD_POS_SCORE;
+			return m_nRetval;
+		}
+		m_nRetval = 0;
+		getOrUpdateStackScore(p, c);
+		return m_nRetval;
+	}
+
+	void DepParser::getOrUpdateStackScore(const int & p, const int & c, const int & amount) {
+		m_pWeight->getOrUpdateArcScore(m_nRetval, p, c, amount, m_nSentenceLength, m_lSentence);
+
+	}
+}
@@ -0,0 +1,82 @@
+#ifndef _CLE_DEPPARSER_H
+#define _CLE_DEPPARSER_H
+
+#include <vector>
+#include <unordered_set>
+
+#include "cle_macros.h"
+#include "common/parser/graph_dp/engine/cle_engine.h"
+#include "common/parser/graph_dp/features/weight1st.h"
+#include "common/parser/corpus.h"
+#include "common/parser/depparser_base.h"
+
+namespace cle {
+	class DepParser : public DepParserBase {
+	private:
+		friend class CLEEngine<DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
+
+		Weight1st *m_pWeight;
+
+		CLEEngine<DepParser> m_cEngine;
+		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE];
+		std::vector<Arc> m_vecCorrectArcs;
+		std::vector<Arc> m_vecTrainArcs;
+		int m_nSentenceLength;
+
+		tscore m_nRetval;
+
+		std::unordered_set<BiGram<int>> m_setFirstGoldScore;
+
+		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
+		void generate(DependencyTree * retval, const DependencyTree & correct);
+		void goldCheck();
+
+		tscore arcScore(const int & p, const int & c);
+
+		void getOrUpdateStackScore(const int & p, const int & c, const int & amount = 0);
+
+	public:
+		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
+		~DepParser();
+
+		void decode() { m_cEngine.decode(m_nSentenceLength); }
+		void decodeArcs() { m_cEngine.decodeArcs(m_vecTrainArcs); }
+
+		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
+		void parse(const Sentence & sentence, DependencyTree * retval);
+		void work(DependencyTree * retval, const DependencyTree & correct);
+
+		void finishtraining() {
+			m_pWeight->computeAverageFeatureWeights(m_nTrainingRound);
+			m_pWeight->saveScores();
+			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
+		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
+	};
+}
+
+#endif
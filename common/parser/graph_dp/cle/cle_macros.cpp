@@ -0,0 +1,14 @@
+#include <stack>
+#include <unordered_set>
+
+#include "cle_macros.h"
+
+namespace cle {
+
+	bool operator<(const Arc & arc1, const Arc & arc2) {
+		if (arc1.first() != arc2.first()) {
+			return arc1.first() < arc2.first();
+		}
+		return arc1.second() < arc2.second();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef _CLE_MACROS_H
+#define _CLE_MACROS_H
+
+#include "common/parser/macros_base.h"
+#include "include/learning/perceptron/packed_score.h"
+
+namespace cle {
+#define OUTPUT_STEP 1000
+
+#define GOLD_POS_SCORE 10
+#define GOLD_NEG_SCORE -50
+
+	typedef BiGram<int> Arc;
+	bool operator<(const Arc & arc1, const Arc & arc2);
+}
+
+#endif
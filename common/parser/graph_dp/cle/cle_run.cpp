@@ -0,0 +1,174 @@
+#include <ctime>
+#include <memory>
+#include <fstream>
+#include <iostream>
+
+#include "cle_run.h"
+#include "cle_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
+#include "common/parser/benchmark.h"
+#include "common/parser/graph_dp/eisner/eisner_depparser.h"
+
+namespace cle {
+	Run::Run() = default;
+
+	Run::~Run() = default;
+
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) {
+		int nRound = 0;
+		EncodedCorpus corpus;
+
+		std::cout << "Training iteration is started..." << std::endl;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
+				++nRound;
+				parser->train(corpus[i], nRound);
+			}
+			parser->finishtraining();
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		EncodedCorpus corpus;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			if (nThreads > 1) {
+				// workers don't load the model, they copy it from the shared parser
+				std::vector<std::unique_ptr<DepParser>> workers;
+				for (int i = 0; i < nThreads; ++i) {
+					workers.push_back(std::unique_ptr<DepParser>(new DepParser("", vecFeatureOutput.back(), ParserState::TRAIN)));
+				}
+				trainEpochs(parser.get(), workers, corpus, vecFeatureOutput, bShuffle, nMixStep);
+			}
+			else {
+				trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+			}
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		return std::unique_ptr<SentenceParser>(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE)));
+	}
+
+	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
+
+		Sentence sentence;
+		DependencyTree tree;
+
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
+		std::cout << "Parsing started" << std::endl;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
+		CorpusReader input(sInputFile);
+		if (input) {
+			while (input >> sentence) {
+				if (sentence.size() < MAX_SENTENCE_SIZE) {
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
+					tree.clear();
+				}
+			}
+		}
+		input.close();
+		output.close();
+	}
+
+	void Run::goldtest(const std::string & sInputFile, const std::string & sFeatureInput) {
+		int nRound = 0;
+		EncodedCorpus corpus;
+
+		std::cout << "GoldTest iteration is started..." << std::endl;
+
+		auto time_begin = time(NULL);
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
+				++nRound;
+				parser->train(corpus[i], nRound);
+			}
+		}
+		input.close();
+
+		std::cout << "total " << nRound << " round" << std::endl;
+
+		auto time_end = time(NULL);
+
+		std::cout << "Done." << std::endl;
+
+		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
+	}
+
+	// parse gold trees with cle and the projective eisner decoder on the
+	// same first-order model, grouped by sentence length from every bound
+	// in vecOptions (default 0 10 20 30 40 50)
+	// nonproj is the share of gold trees eisner can't build
+	void Run::benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) {
+		std::vector<int> vecLengths;
+		for (const auto & option : vecOptions) {
+			if (std::isdigit(option[0])) {
+				vecLengths.push_back(std::atoi(option.c_str()));
+			}
+		}
+		if (vecLengths.empty()) {
+			vecLengths = { 0, 10, 20, 30, 40, 50 };
+		}
+		std::sort(vecLengths.begin(), vecLengths.end());
+		vecLengths.push_back(MAX_SENTENCE_SIZE);
+
+		std::vector<DependencyTree> corrects;
+		loadGoldTrees(sInputFile, corrects);
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE));
+		std::unique_ptr<eisner::DepParser> projective(new eisner::DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE));
+		std::cout << "length\tsentences\tnonproj\teisner UAS\tcle UAS\teisner(s)\tcle(s)" << std::endl;
+		for (std::size_t b = 0; b + 1 < vecLengths.size(); ++b) {
+			std::vector<DependencyTree> trees;
+			int nNonProjective = 0;
+			for (const auto & correct : corrects) {
+				int n = correct.size();
+				if (n < vecLengths[b] || n >= vecLengths[b + 1]) {
+					continue;
+				}
+				std::set<std::pair<int, int>> goldArcs;
+				for (int i = 0; i < n; ++i) {
+					goldArcs.insert(std::make_pair(TREENODE_HEAD(correct[i]) == -1 ? n : TREENODE_HEAD(correct[i]), i));
+				}
+				nNonProjective += hasNonProjectiveTree(goldArcs, n) ? 0 : 1;
+				trees.push_back(correct);
+			}
+			if (trees.empty()) {
+				continue;
+			}
+
+			int nWords = 0, nEisnerCorrect = 0, nCorrect = 0;
+			double eisner_seconds = timeParse(projective.get(), trees, [&](const int & index, const DependencyTree & tree) {
+				nEisnerCorrect += correctHeads(trees[index], tree);
+				nWords += trees[index].size();
+			});
+			double seconds = timeParse(parser.get(), trees, [&](const int & index, const DependencyTree & tree) {
+				nCorrect += correctHeads(trees[index], tree);
+			});
+			std::cout << vecLengths[b] << "-" << vecLengths[b + 1] - 1 << "\t" << trees.size() << "\t" << (double)nNonProjective / trees.size() << "\t"
+					<< (double)nEisnerCorrect / nWords << "\t" << (double)nCorrect / nWords << "\t" << eisner_seconds << "\t" << seconds << std::endl;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <cstring>
+#include <cstdlib>
+
+#include "decoders.h"
+#include "common/parser/empty_detector.h"
+#include "common/parser/graph_dp/eisner/eisner_run.h"
+#include "common/parser/graph_dp/cle/cle_run.h"
+#include "common/parser/graph_dp/eisner2nd/eisner2nd_run.h"
+#include "common/parser/graph_dp/eisner3rd/eisner3rd_run.h"
+#include "common/parser/graph_dp/eisnergc/eisnergc_run.h"
+#include "common/parser/graph_dp/eisnergc2nd/eisnergc2nd_run.h"
+#include "common/parser/graph_dp/eisnergc3rd/eisnergc3rd_run.h"
+#include "common/parser/graph_dp/emptyeisner2nd/emptyeisner2nd_run.h"
+#include "common/parser/graph_dp/emptyeisner3rd/emptyeisner3rd_run.h"
+#include "common/parser/graph_dp/emptyeisnergc2nd/emptyeisnergc2nd_run.h"
+#include "common/parser/graph_dp/emptyeisnergc3rd/emptyeisnergc3rd_run.h"
+
+std::unique_ptr<RunBase> createRun(const std::string & sDecoder, const std::vector<std::string> & vecOptions) {
+	int beam = -1, kbest = 1, grand = -1;
+	bool cube = false, relax = false;
+	std::string detector;
+	double threshold = EMPTY_DETECTOR_THRESHOLD;
+	std::string cache;
+	for (const auto & option : vecOptions) {
+		const char * arg = option.c_str();
+		if (strncmp(arg, "beam=", strlen("beam=")) == 0) {
+			beam = std::atoi(arg + strlen("beam="));
+		}
+		else if (strcmp(arg, "cube") == 0) {
+			cube = true;
+		}
+		else if (strncmp(arg, "detector=", strlen("detector=")) == 0) {
+			detector = arg + strlen("detector=");
+		}
+		else if (strncmp(arg, "threshold=", strlen("threshold=")) == 0) {
+			threshold = std::atof(arg + strlen("threshold="));
+		}
+		else if (strncmp(arg, "cache=", strlen("cache=")) == 0) {
+			cache = arg + strlen("cache=");
+		}
+		else if (strncmp(arg, "kbest=", strlen("kbest=")) == 0) {
+			kbest = std::atoi(arg + strlen("kbest="));
+		}
+		else if (strncmp(arg, "grand=", strlen("grand=")) == 0) {
+			grand = std::atoi(arg + strlen("grand="));
+		}
+		else if (strcmp(arg, "relax") == 0) {
+			relax = true;
+		}
+	}
+
+	RunBase * run = nullptr;
+	if (sDecoder == "eisner") {
+		run = new eisner::Run(kbest);
+	}
+	else if (sDecoder == "cle") {
+		run = new cle::Run();
+	}
+	else if (sDecoder == "eisner2nd") {
+		run = new eisner2nd::Run(kbest);
+	}
+	else if (sDecoder == "eisner3rd") {
+		run = new eisner3rd::Run(beam, cube);
+	}
+	else if (sDecoder == "eisnergc") {
+		run = new eisnergc::Run(grand);
+	}
+	else if (sDecoder == "eisnergc2nd") {
+		run = new eisnergc2nd::Run();
+	}
+	else if (sDecoder == "eisnergc3rd") {
+		run = new eisnergc3rd::Run();
+	}
+	else if (sDecoder == "emptyeisner2nd") {
+		run = new emptyeisner2nd::Run(relax);
+	}
+	else if (sDecoder == "emptyeisner3rd") {
+		run = new emptyeisner3rd::Run(beam, cube, detector, threshold, cache);
+	}
+	else if (sDecoder == "emptyeisnergc2nd") {
+		run = new emptyeisnergc2nd::Run(detector, threshold, cache);
+	}
+	else if (sDecoder == "emptyeisnergc3rd") {
+		run = new emptyeisnergc3rd::Run(detector, threshold, cache);
+	}
+	return std::unique_ptr<RunBase>(run);
+}
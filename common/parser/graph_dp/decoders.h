@@ -0,0 +1,24 @@
+#ifndef _DECODERS_H
+#define _DECODERS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/parser/run_base.h"
+
+// Run of the decoder named sDecoder, configured by the options of the
+// command line that concern it, nullptr for an unknown decoder
+// beam=k sets the span beam width of the third-order decoders, cube combines
+// their beams with cube pruning
+// detector=file gates the empty decoders with an empty detector model,
+// threshold=p is the lowest probability of a slot they still try
+// cache=file keeps the first-order empty beams of the sentences they parse
+// kbest=k makes eisner and eisner2nd parse the k best trees of every sentence
+// grand=k keeps the k best heads of every word as grandparent candidates
+// of eisnergc, 0 keeps all
+// relax makes emptyeisner2nd decode without the empty count dimension, empty
+// nodes pay a tuned penalty
+std::unique_ptr<RunBase> createRun(const std::string & sDecoder, const std::vector<std::string> & vecOptions);
+
+#endif
@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
@@ -8,26 +7,19 @@
 #include "common/token/pos.h"
 
 namespace eisner {
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
 	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+		DepParserBase(nState), m_cEngine(*this) {
 
 		m_nSentenceLength = 0;
 
 		m_pWeight = new Weight1st(sFeatureInput, sFeatureOut, m_nScoreIndex);
 
-		for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
-			m_lItems[1][i].init(i, i);
-		}
-
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 
-		m_pWeight->init(DepParser::empty_taggedword, DepParser::start_taggedword, DepParser::end_taggedword);
+		m_pWeight->init(empty_taggedword, start_taggedword, end_taggedword);
 	}
 
 	DepParser::~DepParser() {
@@ -38,13 +30,28 @@ namespace eisner {
 		// initialize
 		int idx = 0;
 		m_vecCorrectArcs.clear();
-		m_nTrainingRound = round;
 		m_nSentenceLength = correct.size();
 		for (const auto & node : correct) {
 			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
 		}
-		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
 
 		if (m_nState == ParserState::GOLDTEST) {
 			m_setFirstGoldScore.clear();
@@ -74,6 +81,31 @@ namespace eisner {
 		work(retval, correct);
 	}
 
+	void DepParser::parse(const Sentence & sentence, const int & nKBest, std::vector<DependencyTree> & vecTrees, std::vector<tscore> & vecScores) {
+		int idx = 0;
+		m_nTrainingRound = 0;
+		m_nSentenceLength = sentence.size();
+		for (const auto & token : sentence) {
+			m_lSentence[idx++].refer(TWord::code(SENT_WORD(token)), TPOSTag::code(SENT_POSTAG(token)));
+		}
+		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+
+		m_cEngine.setKBest(true);
+		decode();
+		m_cEngine.decodeKBest(nKBest, m_vecKBestArcs, vecScores);
+
+		vecTrees.clear();
+		for (const auto & arcs : m_vecKBestArcs) {
+			vecTrees.push_back(DependencyTree());
+			for (const auto & token : sentence) {
+				vecTrees.back().push_back(DependencyTreeNode(token, -1, NULL_LABEL));
+			}
+			for (const auto & arc : arcs) {
+				TREENODE_HEAD(vecTrees.back()[arc.second()]) = arc.first();
+			}
+		}
+	}
+
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
 		decode();
@@ -95,118 +127,6 @@ namespace eisner {
 		}
 	}
 
-	void DepParser::decode() {
-		for (int d = 2; d <= m_nSentenceLength + 1; ++d) {
-
-			initFirstOrderScore(d);
-
-			for (int i = 0, n = m_nSentenceLength - d + 1; i < n; ++i) {
-
-				StateItem & item = m_lItems[d][i];
-
-				item.init(i, i + d - 1);
-
-				const tscore & l2r_arc_score = m_lFirstOrderScore[ENCODE_L2R(i)];
-				const tscore & r2l_arc_score = m_lFirstOrderScore[ENCODE_R2L(i)];
-
-				for (int s = i, j = i + d; s < j - 1; ++s) {
-
-					StateItem & litem = m_lItems[s - i + 1][i];
-					StateItem & ritem = m_lItems[j - s - 1][s + 1];
-					tscore partial_im_complete_score = litem.l2r.getScore() + ritem.r2l.getScore();
-
-					item.updateL2RIm(s, partial_im_complete_score + l2r_arc_score);
-					item.updateR2LIm(s, partial_im_complete_score + r2l_arc_score);
-				}
-
-				item.updateL2R(item.right, item.l2r_im.getScore());
-				item.updateR2L(item.left, item.r2l_im.getScore());
-
-				for (int s = i + 1, j = i + d; s < j - 1; ++s) {
-
-					StateItem & litem = m_lItems[s - i + 1][i];
-					StateItem & ritem = m_lItems[j - s][s];
-
-					item.updateL2R(s, litem.l2r_im.getScore() + ritem.l2r.getScore());
-					item.updateR2L(s, ritem.r2l_im.getScore() + litem.r2l.getScore());
-				}
-			}
-
-			StateItem & item = m_lItems[d][m_nSentenceLength - d + 1];
-
-			item.init(m_nSentenceLength - d + 1, m_nSentenceLength);
-
-			item.updateR2LIm(m_nSentenceLength - 1, m_lItems[d - 1][item.left].l2r.getScore() + m_lFirstOrderScore[ENCODE_R2L(item.left)]);
-
-			item.updateR2L(item.left, item.r2l_im.getScore());
-
-			for (int i = item.left, s = item.left + 1, j = m_nSentenceLength + 1; s < j - 1; ++s) {
-				item.updateR2L(s, m_lItems[j - s][s].r2l_im.getScore() + m_lItems[s - i + 1][i].r2l.getScore());
-			}
-		}
-	}
-
-	void DepParser::decodeArcs() {
-		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int>> stack;
-		stack.push(std::tuple<int, int>(m_nSentenceLength + 1, 0));
-		m_lItems[m_nSentenceLength + 1][0].type = R2L_COMP;
-
-		while (!stack.empty()) {
-			int s = -1;
-			std::tuple<int, int> span = stack.top();
-			stack.pop();
-			StateItem & item = m_lItems[std::get<0>(span)][std::get<1>(span)];
-
-			if (item.left == item.right) {
-				continue;
-			}
-			switch (item.type) {
-			case L2R_COMP:
-				s = item.l2r.getSplit();
-				m_vecTrainArcs.push_back(BiGram<int>(item.left, s));
-
-				if (item.left < item.right - 1) {
-					m_lItems[s - item.left + 1][item.left].type = L2R_IM_COMP;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-					m_lItems[item.right - s + 1][s].type = L2R_COMP;
-					stack.push(std::tuple<int, int>(item.right - s + 1, s));
-				}
-				break;
-			case R2L_COMP:
-				s = item.r2l.getSplit();
-				m_vecTrainArcs.push_back(BiGram<int>(item.right == m_nSentenceLength ? -1 : item.right, s));
-
-				if (item.left < item.right - 1) {
-					m_lItems[item.right - s + 1][s].type = R2L_IM_COMP;
-					stack.push(std::tuple<int, int>(item.right - s + 1, s));
-					m_lItems[s - item.left + 1][item.left].type = R2L_COMP;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-				}
-				break;
-			case L2R_IM_COMP:
-				s = item.l2r_im.getSplit();
-
-				m_lItems[s - item.left + 1][item.left].type = L2R_COMP;
-				stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-				m_lItems[item.right - s][s + 1].type = R2L_COMP;
-				stack.push(std::tuple<int, int>(item.right - s, s + 1));
-				break;
-			case R2L_IM_COMP:
-				s = item.r2l_im.getSplit();
-
-				m_lItems[s - item.left + 1][item.left].type = L2R_COMP;
-				stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-				m_lItems[item.right - s][s + 1].type = R2L_COMP;
-				stack.push(std::tuple<int, int>(item.right - s, s + 1));
-				break;
-			default:
-				break;
-			}
-		}
-
-	}
-
 	void DepParser::update() {
 		std::unordered_set<Arc> positiveArcs;
 		positiveArcs.insert(m_vecCorrectArcs.begin(), m_vecCorrectArcs.end());
@@ -240,9 +160,9 @@ namespace eisner {
 	}
 
 	void DepParser::goldCheck() {
-		if (m_vecCorrectArcs.size() != m_vecTrainArcs.size() || m_lItems[m_nSentenceLength + 1][0].r2l.getScore() / GOLD_POS_SCORE != m_vecTrainArcs.size()) {
+		if (m_vecCorrectArcs.size() != m_vecTrainArcs.size() || m_cEngine.score() / GOLD_POS_SCORE != m_vecTrainArcs.size()) {
 			std::cout << "gold parse len error at " << m_nTrainingRound << std::endl;
-			std::cout << "score is " << m_lItems[m_nSentenceLength + 1][0].r2l.getScore() << std::endl;
+			std::cout << "score is " << m_cEngine.score() << std::endl;
 			std::cout << "len is " << m_vecTrainArcs.size() << std::endl;
 			++m_nTotalErrors;
 		}
@@ -272,15 +192,6 @@ namespace eisner {
 		return m_nRetval;
 	}
 
-	void DepParser::initFirstOrderScore(const int & d) {
-		for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
-			m_lFirstOrderScore[ENCODE_L2R(i)] = arcScore(i, i + d - 1);
-			m_lFirstOrderScore[ENCODE_R2L(i)] = arcScore(i + d - 1, i);
-		}
-		int i = m_nSentenceLength - d + 1;
-		m_lFirstOrderScore[ENCODE_R2L(i)] = arcScore(m_nSentenceLength, i);
-	}
-
 	void DepParser::getOrUpdateStackScore(const int & p, const int & c, const int & amount) {
 		m_pWeight->getOrUpdateArcScore(m_nRetval, p, c, amount, m_nSentenceLength, m_lSentence);
 
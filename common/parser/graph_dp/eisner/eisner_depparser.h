@@ -4,36 +4,41 @@
 #include <vector>
 #include <unordered_set>
 
-#include "eisner_state.h"
+#include "eisner_macros.h"
+#include "common/parser/graph_dp/engine/eisner_engine.h"
 #include "common/parser/graph_dp/features/weight1st.h"
+#include "common/parser/corpus.h"
 #include "common/parser/depparser_base.h"
 
 namespace eisner {
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
 
 		Weight1st *m_pWeight;
 
-		StateItem m_lItems[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
+		EisnerEngine<ARC_FACTOR, DepParser> m_cEngine;
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE];
 		std::vector<Arc> m_vecCorrectArcs;
 		std::vector<Arc> m_vecTrainArcs;
+		std::vector<std::vector<Arc>> m_vecKBestArcs;
 		int m_nSentenceLength;
 
 		tscore m_nRetval;
-		tscore m_lFirstOrderScore[MAX_SENTENCE_SIZE << 1];
 
 		std::unordered_set<BiGram<int>> m_setFirstGoldScore;
 
 		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck();
 
 		tscore arcScore(const int & p, const int & c);
-		void initFirstOrderScore(const int & d);
 
 		void getOrUpdateStackScore(const int & p, const int & c, const int & amount = 0);
 
@@ -41,11 +46,14 @@ namespace eisner {
 		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
 		~DepParser();
 
-		void decode();
-		void decodeArcs();
+		void decode() { m_cEngine.decode(m_nSentenceLength); }
+		void decodeArcs() { m_cEngine.decodeArcs(m_vecTrainArcs); }
 
 		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
 		void parse(const Sentence & sentence, DependencyTree * retval);
+		// at most nKBest trees with their scores, best first
+		void parse(const Sentence & sentence, const int & nKBest, std::vector<DependencyTree> & vecTrees, std::vector<tscore> & vecScores);
 		void work(DependencyTree * retval, const DependencyTree & correct);
 
 		void finishtraining() {
@@ -53,6 +61,24 @@ namespace eisner {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
 	};
 }
 
@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <queue>
 #include <algorithm>
 #include <unordered_set>
@@ -7,6 +6,7 @@
 #include "eceisner2nd_depparser.h"
 #include "common/token/word.h"
 #include "common/token/pos.h"
+#include "common/parser/fixed_stack.h"
 
 typedef std::pair<double, std::vector<WordPOSTag>> tSent;
 bool operator<(const tSent& s1, const tSent& s2) {
@@ -26,10 +26,6 @@ bool operator>=(const tSent& s1, const tSent& s2) {
 
 namespace eisner2nd {
 
-	WordPOSTag ECDepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag ECDepParser::start_taggedword = WordPOSTag();
-	WordPOSTag ECDepParser::end_taggedword = WordPOSTag();
-
 	ECDepParser::ECDepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
 		DepParserBase(nState) {
 
@@ -41,11 +37,11 @@ namespace eisner2nd {
 			m_lItems[1][i].init(i, i);
 		}
 
-		ECDepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		ECDepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		ECDepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
 
-		m_pWeight->init(ECDepParser::empty_taggedword, ECDepParser::start_taggedword, ECDepParser::end_taggedword);
+		m_pWeight->init(empty_taggedword, start_taggedword, end_taggedword);
 	}
 
 	ECDepParser::~ECDepParser() {
@@ -235,7 +231,7 @@ namespace eisner2nd {
 	void ECDepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int>> stack;
+		FixedStack<std::tuple<int, int>> stack;
 		m_lItems[m_nSentenceLength + 1][0].type = R2L;
 		stack.push(std::tuple<int, int>(m_nSentenceLength + 1, 0));
 
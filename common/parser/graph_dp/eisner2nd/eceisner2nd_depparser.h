@@ -12,9 +12,9 @@ namespace eisner2nd {
 
 	class ECDepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
 
 		Weight2nd *m_pWeight;
 
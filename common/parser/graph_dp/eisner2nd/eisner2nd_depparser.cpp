@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
@@ -9,26 +8,20 @@
 
 namespace eisner2nd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
 	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+		DepParserBase(nState), m_cEngine(*this), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
 
 		m_pWeight = new Weight2nd(sFeatureInput, sFeatureOut, m_nScoreIndex);
 
-		for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
-			m_lItems[1][i].init(i, i);
-		}
-
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 
-		m_pWeight->init(DepParser::empty_taggedword, DepParser::start_taggedword, DepParser::end_taggedword);
+		m_pWeight->init(empty_taggedword, start_taggedword, end_taggedword);
+		m_cEngine.setDeadline(&m_cDeadline);
 	}
 
 	DepParser::~DepParser() {
@@ -39,14 +32,30 @@ namespace eisner2nd {
 		// initialize
 		int idx = 0;
 		m_vecCorrectArcs.clear();
-		m_nTrainingRound = round;
 		m_nSentenceLength = correct.size();
 		// for normal sentence
 		for (const auto & node : correct) {
 			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
 		}
-		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		// for normal sentence
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
 		Arcs2BiArcs(m_vecCorrectArcs, m_vecCorrectBiArcs);
 
 		if (m_nState == ParserState::GOLDTEST) {
@@ -77,11 +86,42 @@ namespace eisner2nd {
 		work(retval, correct);
 	}
 
+	void DepParser::parse(const Sentence & sentence, const int & nKBest, std::vector<DependencyTree> & vecTrees, std::vector<tscore> & vecScores) {
+		int idx = 0;
+		m_nSentenceLength = sentence.size();
+		for (const auto & token : sentence) {
+			m_lSentence[idx++].refer(TWord::code(SENT_WORD(token)), TPOSTag::code(SENT_POSTAG(token)));
+		}
+		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+
+		m_cEngine.setKBest(true);
+		decode();
+		m_cEngine.decodeKBest(nKBest, m_vecKBestArcs, vecScores);
+
+		vecTrees.clear();
+		for (const auto & arcs : m_vecKBestArcs) {
+			vecTrees.push_back(DependencyTree());
+			for (const auto & token : sentence) {
+				vecTrees.back().push_back(DependencyTreeNode(token, -1, NULL_LABEL));
+			}
+			for (const auto & arc : arcs) {
+				TREENODE_HEAD(vecTrees.back()[arc.second()]) = arc.first();
+			}
+		}
+	}
+
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -98,155 +138,6 @@ namespace eisner2nd {
 		}
 	}
 
-	void DepParser::decode() {
-
-		for (int d = 2; d <= m_nSentenceLength + 1; ++d) {
-
-			initFirstOrderScore(d);
-			initSecondOrderScore(d);
-
-			for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
-
-				int l = i + d - 1;
-				StateItem & item = m_lItems[d][i];
-				const tscore & l2r_arc_score = m_lFirstOrderScore[ENCODE_L2R(i)];
-				const tscore & r2l_arc_score = m_lFirstOrderScore[ENCODE_R2L(i)];
-
-				// initialize
-				item.init(i, l);
-
-				// jux
-				for (int s = i; s < l; ++s) {
-					item.updateJUX(s, m_lItems[s - i + 1][i].l2r.getScore() + m_lItems[l - s][s + 1].r2l.getScore());
-				}
-
-				for (int k = i + 1; k < l; ++k) {
-
-					StateItem & litem = m_lItems[k - i + 1][i];
-					StateItem & ritem = m_lItems[l - k + 1][k];
-
-					// solid both
-					item.updateL2RSolidBoth(k, ritem.jux.getScore() + litem.l2r_solid_both.getScore() + l2r_arc_score + m_lSecondOrderScore[ENCODE_2ND_L2R(i, k)]);
-					item.updateR2LSolidBoth(k, litem.jux.getScore() + ritem.r2l_solid_both.getScore() + r2l_arc_score + m_lSecondOrderScore[ENCODE_2ND_R2L(i, k)]);
-
-					// complete
-					item.updateL2R(k, litem.l2r_solid_both.getScore() + ritem.l2r.getScore());
-					item.updateR2L(k, ritem.r2l_solid_both.getScore() + litem.r2l.getScore());
-				}
-				// solid both
-				item.updateL2RSolidBoth(i, m_lItems[d - 1][i + 1].r2l.getScore() + l2r_arc_score + m_lSecondOrderScore[ENCODE_2ND_L2R(i, i)]);
-				item.updateR2LSolidBoth(l, m_lItems[d - 1][i].l2r.getScore() + r2l_arc_score + m_lSecondOrderScore[ENCODE_2ND_R2L(i, i)]);
-				// complete
-				item.updateL2R(l, item.l2r_solid_both.getScore());
-				item.updateR2L(i, item.r2l_solid_both.getScore());
-			}
-			// root
-			StateItem & item = m_lItems[d][m_nSentenceLength - d + 1];
-			item.init(m_nSentenceLength - d + 1, m_nSentenceLength);
-			// solid both
-			item.updateR2LSolidBoth(m_nSentenceLength, m_lItems[d - 1][item.left].l2r.getScore() +
-				m_lFirstOrderScore[ENCODE_R2L(item.left)] +
-				m_lSecondOrderScore[ENCODE_2ND_R2L(item.left, item.left)]);
-			// complete
-			item.updateR2L(item.left, item.r2l_solid_both.getScore());
-			for (int i = item.left, s = item.left + 1, j = m_nSentenceLength + 1; s < j - 1; ++s) {
-				item.updateR2L(s, m_lItems[j - s][s].r2l_solid_both.getScore() + m_lItems[s - i + 1][i].r2l.getScore());
-			}
-		}
-	}
-
-	void DepParser::decodeArcs() {
-
-		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int>> stack;
-		m_lItems[m_nSentenceLength + 1][0].type = R2L;
-		stack.push(std::tuple<int, int>(m_nSentenceLength + 1, 0));
-
-		while (!stack.empty()) {
-
-			auto span = stack.top();
-			stack.pop();
-
-			int s = -1;
-			StateItem & item = m_lItems[std::get<0>(span)][std::get<1>(span)];
-
-			if (item.left == item.right) {
-				continue;
-			}
-			switch (item.type) {
-			case JUX:
-				if (item.left < item.right - 1) {
-					s = item.jux.getSplit();
-					m_lItems[s - item.left + 1][item.left].type = L2R;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-					m_lItems[item.right - s][s + 1].type = R2L;
-					stack.push(std::tuple<int, int>(item.right - s, s + 1));
-				}
-				break;
-			case L2R:
-				s = item.l2r.getSplit();
-
-				if (item.left < item.right - 1) {
-					m_lItems[s - item.left + 1][item.left].type = L2R_SOLID_BOTH;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-					m_lItems[item.right - s + 1][s].type = L2R;
-					stack.push(std::tuple<int, int>(item.right - s + 1, s));
-				}
-				else {
-					m_vecTrainArcs.push_back(BiGram<int>(item.left, item.right));
-				}
-				break;
-			case R2L:
-				s = item.r2l.getSplit();
-
-				if (item.left < item.right - 1) {
-					m_lItems[item.right - s + 1][s].type = R2L_SOLID_BOTH;
-					stack.push(std::tuple<int, int>(item.right - s + 1, s));
-					m_lItems[s - item.left + 1][item.left].type = R2L;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-				}
-				else {
-					m_vecTrainArcs.push_back(BiGram<int>(item.right == m_nSentenceLength ? -1 : item.right, item.left));
-				}
-				break;
-			case L2R_SOLID_BOTH:
-				m_vecTrainArcs.push_back(BiGram<int>(item.left, item.right));
-
-				s = item.l2r_solid_both.getSplit();
-
-				if (s == item.left) {
-					m_lItems[item.right - s][s + 1].type = R2L;
-					stack.push(std::tuple<int, int>(item.right - s, s + 1));
-				}
-				else {
-					m_lItems[s - item.left + 1][item.left].type = L2R_SOLID_BOTH;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-					m_lItems[item.right - s + 1][s].type = JUX;
-					stack.push(std::tuple<int, int>(item.right - s + 1, s));
-				}
-				break;
-			case R2L_SOLID_BOTH:
-				m_vecTrainArcs.push_back(BiGram<int>(item.right == m_nSentenceLength ? -1 : item.right, item.left));
-
-				s = item.r2l_solid_both.getSplit();
-
-				if (s == item.right) {
-					m_lItems[s - item.left][item.left].type = L2R;
-					stack.push(std::tuple<int, int>(s - item.left, item.left));
-				}
-				else {
-					m_lItems[item.right - s + 1][s].type = R2L_SOLID_BOTH;
-					stack.push(std::tuple<int, int>(item.right - s + 1, s));
-					m_lItems[s - item.left + 1][item.left].type = JUX;
-					stack.push(std::tuple<int, int>(s - item.left + 1, item.left));
-				}
-				break;
-			default:
-				break;
-			}
-		}
-	}
-
 	void DepParser::update() {
 		Arcs2BiArcs(m_vecTrainArcs, m_vecTrainBiArcs);
 
@@ -284,9 +175,9 @@ namespace eisner2nd {
 
 	void DepParser::goldCheck() {
 		Arcs2BiArcs(m_vecTrainArcs, m_vecTrainBiArcs);
-		if (m_vecCorrectArcs.size() != m_vecTrainArcs.size() || m_lItems[m_nSentenceLength + 1][0].r2l.getScore() / GOLD_POS_SCORE != 2 * m_vecTrainArcs.size()) {
+		if (m_vecCorrectArcs.size() != m_vecTrainArcs.size() || m_cEngine.score() / GOLD_POS_SCORE != 2 * m_vecTrainArcs.size()) {
 			std::cout << "gold parse len error at " << m_nTrainingRound << std::endl;
-			std::cout << "score is " << m_lItems[m_nSentenceLength + 1][0].r2l.getScore() << std::endl;
+			std::cout << "score is " << m_cEngine.score() << std::endl;
 			std::cout << "len is " << m_vecTrainArcs.size() << std::endl;
 			++m_nTotalErrors;
 		}
@@ -326,29 +217,6 @@ namespace eisner2nd {
 		return m_nRetval;
 	}
 
-	void DepParser::initFirstOrderScore(const int & d) {
-		for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
-			m_lFirstOrderScore[ENCODE_L2R(i)] = arcScore(i, i + d - 1);
-			m_lFirstOrderScore[ENCODE_R2L(i)] = arcScore(i + d - 1, i);
-		}
-		int i = m_nSentenceLength - d + 1;
-		m_lFirstOrderScore[ENCODE_R2L(i)] = arcScore(m_nSentenceLength, i);
-	}
-
-	void DepParser::initSecondOrderScore(const int & d) {
-		for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
-			int l = i + d - 1;
-			m_lSecondOrderScore[ENCODE_2ND_L2R(i, i)] = twoArcScore(i, -1, l);
-			m_lSecondOrderScore[ENCODE_2ND_R2L(i, i)] = twoArcScore(l, -1, i);
-			for (int k = i + 1, l = i + d - 1; k < l; ++k) {
-				m_lSecondOrderScore[ENCODE_2ND_L2R(i, k)] = twoArcScore(i, k, l);
-				m_lSecondOrderScore[ENCODE_2ND_R2L(i, k)] = twoArcScore(l, k, i);
-			}
-		}
-		int i = m_nSentenceLength - d + 1;
-		m_lSecondOrderScore[ENCODE_2ND_R2L(i, i)] = twoArcScore(m_nSentenceLength, -1, i);
-	}
-
 	void DepParser::getOrUpdateStackScore(const int & p, const int & c, const int & amount) {
 		m_pWeight->getOrUpdateArcScore(m_nRetval, p, c, amount, m_nSentenceLength, m_lSentence);
 	}
@@ -4,43 +4,49 @@
 #include <vector>
 #include <unordered_set>
 
-#include "eisner2nd_state.h"
+#include "eisner2nd_macros.h"
+#include "common/parser/corpus.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/eisner_engine.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
 #include "common/parser/graph_dp/features/weight2nd.h"
 
 namespace eisner2nd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<SIBLING_FACTOR, DepParser>;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
 
 		Weight2nd *m_pWeight;
 
-		StateItem m_lItems[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
+		EisnerEngine<SIBLING_FACTOR, DepParser> m_cEngine;
+		FallbackEngine<DepParser> m_cFallback;
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE];
 		std::vector<Arc> m_vecCorrectArcs;
 		std::vector<BiArc> m_vecCorrectBiArcs;
 		std::vector<Arc> m_vecTrainArcs;
+		std::vector<std::vector<Arc>> m_vecKBestArcs;
 		std::vector<BiArc> m_vecTrainBiArcs;
 		int m_nSentenceLength;
 
 		tscore m_nRetval;
-		tscore m_lFirstOrderScore[MAX_SENTENCE_SIZE << 1];
-		tscore m_lSecondOrderScore[(MAX_SENTENCE_SIZE << MAX_SENTENCE_BITS) << 1];
 
 		std::unordered_set<BiGram<int>> m_setFirstGoldScore;
 		std::unordered_set<TriGram<int>> m_setSecondGoldScore;
 
 		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck();
 
 		const tscore & arcScore(const int & p, const int & c);
 		const tscore & twoArcScore(const int & p, const int & c, const int & c2);
-		void initFirstOrderScore(const int & d);
-		void initSecondOrderScore(const int & d);
 
 		void getOrUpdateStackScore(const int & p, const int & c, const int & amount);
 		void getOrUpdateStackScore(const int & p, const int & c, const int & c2, const int & amount);
@@ -49,11 +55,14 @@ namespace eisner2nd {
 		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
 		~DepParser();
 
-		void decode();
-		void decodeArcs();
+		void decode() { m_cEngine.decode(m_nSentenceLength); }
+		void decodeArcs() { m_cEngine.decodeArcs(m_vecTrainArcs); }
 
 		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
 		void parse(const Sentence & sentence, DependencyTree * retval);
+		// at most nKBest trees with their scores, best first
+		void parse(const Sentence & sentence, const int & nKBest, std::vector<DependencyTree> & vecTrees, std::vector<tscore> & vecScores);
 		void work(DependencyTree * retval, const DependencyTree & correct);
 
 		void finishtraining() {
@@ -61,6 +70,24 @@ namespace eisner2nd {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
 	};
 }
 
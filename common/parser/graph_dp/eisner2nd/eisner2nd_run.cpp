@@ -6,27 +6,30 @@
 
 #include "eisner2nd_run.h"
 #include "eisner2nd_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
 #include "eceisner2nd_depparser.h"
 
 namespace eisner2nd {
-	Run::Run() = default;
+	Run::Run(const int & nKBest) : m_nKBest(nKBest) {}
 
 	Run::~Run() = default;
 
 	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "Training iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 			parser->finishtraining();
 		}
@@ -39,23 +42,65 @@ namespace eisner2nd {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		EncodedCorpus corpus;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			if (nThreads > 1) {
+				// workers don't load the model, they copy it from the shared parser
+				std::vector<std::unique_ptr<DepParser>> workers;
+				for (int i = 0; i < nThreads; ++i) {
+					workers.push_back(std::unique_ptr<DepParser>(new DepParser("", vecFeatureOutput.back(), ParserState::TRAIN)));
+				}
+				trainEpochs(parser.get(), workers, corpus, vecFeatureOutput, bShuffle, nMixStep);
+			}
+			else {
+				trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+			}
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		return std::unique_ptr<SentenceParser>(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE)));
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
+		std::vector<DependencyTree> trees;
+		std::vector<tscore> scores;
+
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
 
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					if (m_nKBest > 1) {
+						// every tree follows a line with its rank and score
+						parser->parse(sentence, m_nKBest, trees, scores);
+						for (std::size_t i = 0; i < trees.size(); ++i) {
+							output << "# " << i + 1 << " " << scores[i] << "\n";
+							write(output, trees[i]);
+						}
+						output.next();
+						continue;
+					}
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -70,18 +115,19 @@ namespace eisner2nd {
 
 	void Run::goldtest(const std::string & sInputFile, const std::string & sFeatureInput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "GoldTest iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 		}
 		input.close();
@@ -5,12 +5,18 @@
 
 namespace eisner2nd {
 	class Run : public RunBase {
+	private:
+		int m_nKBest;
+
 	public:
-		Run();
+		// parse writes the nKBest best trees of every sentence
+		Run(const int & nKBest = 1);
 		~Run();
 
 		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) override;
+		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) override;
 		void parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) override;
+		std::unique_ptr<SentenceParser> load(const std::string & sFeatureFile) override;
 		void goldtest(const std::string & sInputFile, const std::string & sFeatureInput) override;
 	};
 }
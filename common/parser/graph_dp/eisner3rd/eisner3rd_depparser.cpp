@@ -1,50 +1,74 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
 #include "eisner3rd_depparser.h"
 #include "common/token/word.h"
 #include "common/token/pos.h"
+#include "common/parser/fixed_stack.h"
 
 namespace eisner3rd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
-	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const int & nBeamSize, const bool & bCubePruning) :
+		DepParserBase(nState), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
 
 		m_pWeight = new Weight(sFeatureInput, sFeatureOut);
 
+		setBeamSize(nBeamSize, bCubePruning);
 		for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
 			m_lItems[1][i].init(i, i);
 		}
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 	}
 
 	DepParser::~DepParser() {
 		delete m_pWeight;
 	}
 
+	void DepParser::setBeamSize(const int & nBeamSize, const bool & bCubePruning) {
+		m_nBeamSize = nBeamSize;
+		m_bCubePruning = bCubePruning;
+		for (int d = 0; d < MAX_SENTENCE_SIZE; ++d) {
+			for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
+				m_lItems[d][i].setBeamSize(m_nBeamSize);
+			}
+		}
+	}
+
 	void DepParser::train(const DependencyTree & correct, const int & round) {
 		// initialize
 		int idx = 0;
 		m_vecCorrectArcs.clear();
-		m_nTrainingRound = round;
 		m_nSentenceLength = correct.size();
 		// for normal sentence
 		for (const auto & node : correct) {
 			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
 		}
-		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		// for normal sentence
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
 		Arcs2TriArcs(m_vecCorrectArcs, m_vecCorrectTriArcs);
 
 		if (m_nState == ParserState::GOLDTEST) {
@@ -79,9 +103,16 @@ namespace eisner3rd {
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -102,6 +133,10 @@ namespace eisner3rd {
 
 		for (int d = 2; d <= m_nSentenceLength + 1; ++d) {
 
+			if (m_cDeadline.expired()) {
+				return;
+			}
+
 			initFirstOrderScore(d);
 			initSecondOrderScore(d);
 
@@ -120,6 +155,8 @@ namespace eisner3rd {
 					item.updateJUX(s, m_lItems[s - i + 1][i].l2r.getScore() + m_lItems[l - s][s + 1].r2l.getScore());
 				}
 
+				m_vecL2RRows.clear();
+				m_vecR2LRows.clear();
 				for (int k = i + 1; k < l; ++k) {
 
 					StateItem & litem = m_lItems[k - i + 1][i];
@@ -131,26 +168,51 @@ namespace eisner3rd {
 					// solid both
 					tscore l_base_score = ritem.jux.getScore() + l2r_arc_score + m_lSecondOrderScore[ENCODE_2ND_L2R(i, k)];
 
-					for (const auto & sws : l_solid_both_beam) {
-						const int & j = sws->getSplit();
-						item.updateL2RSolidBoth(k, j, l_base_score +
-							sws->getScore() +
-							triArcScore(i, j == i ? -1 : j, k, l));
+					if (m_bCubePruning) {
+						m_vecL2RRows.push_back(ScoreRow(k, 0, l_base_score, &l_solid_both_beam));
+					}
+					else {
+						for (const auto & sws : l_solid_both_beam) {
+							const int & j = sws->getSplit();
+							item.updateL2RSolidBoth(k, j, l_base_score +
+								sws->getScore() +
+								triArcScore(i, j == i ? -1 : j, k, l));
+						}
 					}
 
 					tscore r_base_score = litem.jux.getScore() + r2l_arc_score + m_lSecondOrderScore[ENCODE_2ND_R2L(i, k)];
 
-					for (const auto & sws : r_solid_both_beam) {
-						const int & j = sws->getSplit();
-						item.updateR2LSolidBoth(k, j, r_base_score +
-							sws->getScore() +
-							triArcScore(l, j == l ? -1 : j, k, i));
+					if (m_bCubePruning) {
+						m_vecR2LRows.push_back(ScoreRow(k, 0, r_base_score, &r_solid_both_beam));
+					}
+					else {
+						for (const auto & sws : r_solid_both_beam) {
+							const int & j = sws->getSplit();
+							item.updateR2LSolidBoth(k, j, r_base_score +
+								sws->getScore() +
+								triArcScore(l, j == l ? -1 : j, k, i));
+						}
 					}
 
 					// complete
 					item.updateL2R(k, litem.l2r_solid_both.bestItem().getScore() + ritem.l2r.getScore());
 					item.updateR2L(k, ritem.r2l_solid_both.bestItem().getScore() + litem.r2l.getScore());
 				}
+				if (m_bCubePruning) {
+					// solid both
+					cubePrune(m_vecL2RRows, m_nBeamSize, [&](const ScoreRow & row, const int & index) -> tscore {
+						const int & j = (*row.beam)[index].getSplit();
+						return row.base + (*row.beam)[index].getScore() + triArcScore(i, j == i ? -1 : j, row.split, l);
+					}, [&item](const ScoreRow & row, const int & index, const tscore & score) {
+						item.updateL2RSolidBoth(row.split, (*row.beam)[index].getSplit(), score);
+					});
+					cubePrune(m_vecR2LRows, m_nBeamSize, [&](const ScoreRow & row, const int & index) -> tscore {
+						const int & j = (*row.beam)[index].getSplit();
+						return row.base + (*row.beam)[index].getScore() + triArcScore(l, j == l ? -1 : j, row.split, i);
+					}, [&item](const ScoreRow & row, const int & index, const tscore & score) {
+						item.updateR2LSolidBoth(row.split, (*row.beam)[index].getSplit(), score);
+					});
+				}
 				// solid both
 				item.updateL2RSolidBoth(i, i, m_lItems[d - 1][i + 1].r2l.getScore() +
 					l2r_arc_score +
@@ -183,7 +245,7 @@ namespace eisner3rd {
 	void DepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int>> stack;
 		m_lItems[m_nSentenceLength + 1][0].type = R2L;
 		stack.push(std::tuple<int, int, int>(m_nSentenceLength + 1, -1, 0));
 
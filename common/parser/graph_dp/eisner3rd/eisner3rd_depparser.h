@@ -6,17 +6,28 @@
 
 #include "eisner3rd_state.h"
 #include "eisner3rd_weight.h"
+#include "common/parser/corpus.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
 
 namespace eisner3rd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
 
 		Weight *m_pWeight;
+		FallbackEngine<DepParser> m_cFallback;
+
+		int m_nBeamSize;
+		bool m_bCubePruning;
+		std::vector<ScoreRow> m_vecL2RRows;
+		std::vector<ScoreRow> m_vecR2LRows;
 
 		StateItem m_lItems[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE];
@@ -57,6 +68,7 @@ namespace eisner3rd {
 		std::unordered_set<QuarGram<int>> m_setThirdGoldScore;
 
 		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck();
 
@@ -71,13 +83,18 @@ namespace eisner3rd {
 		void getOrUpdateStackScore(const int & p, const int & c, const int & c2, const int & c3, const int & amount);
 
 	public:
-		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
+		// nBeamSize items are kept per span, bCubePruning pops only nBeamSize
+		// candidates per span instead of scoring every beam item
+		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const int & nBeamSize = AGENDA_SIZE, const bool & bCubePruning = false);
 		~DepParser();
 
+		void setBeamSize(const int & nBeamSize, const bool & bCubePruning);
+
 		void decode();
 		void decodeArcs();
 
 		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
 		void parse(const Sentence & sentence, DependencyTree * retval);
 		void work(DependencyTree * retval, const DependencyTree & correct);
 
@@ -86,6 +103,24 @@ namespace eisner3rd {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
 	};
 }
 
@@ -1,6 +1,7 @@
 #ifndef _EISNER3RD_MACROS_H
 #define _EISNER3RD_MACROS_H
 
+#include "common/parser/cube.h"
 #include "common/parser/agenda.h"
 #include "common/parser/macros_base.h"
 #include "include/learning/perceptron/packed_score.h"
@@ -8,7 +9,9 @@
 namespace eisner3rd {
 #define OUTPUT_STEP 100
 
+// default and largest beam width, beams allocate room for the width in use
 #define AGENDA_SIZE 4
+#define MAX_AGENDA_SIZE 32
 
 #define GOLD_POS_SCORE 10
 #define GOLD_NEG_SCORE -50
@@ -33,7 +36,8 @@ namespace eisner3rd {
 	typedef PackedScoreMap<WordWordPOSTagPOSTagInt> WordWordPOSTagPOSTagIntMap;
 	typedef PackedScoreMap<WordPOSTagPOSTagPOSTagInt> WordPOSTagPOSTagPOSTagIntMap;
 
-	typedef AgendaBeam<ScoreWithBiSplit, AGENDA_SIZE> ScoreAgenda;
+	typedef AgendaBeam<ScoreWithBiSplit, 0> ScoreAgenda;
+	typedef BeamRow<ScoreAgenda> ScoreRow;
 
 	typedef BiGram<int> Arc;
 	typedef QuarGram<int> TriArc;
@@ -1,4 +1,5 @@
 #include <ctime>
+#include <cctype>
 #include <memory>
 #include <fstream>
 #include <sstream>
@@ -6,26 +7,35 @@
 
 #include "eisner3rd_run.h"
 #include "eisner3rd_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
+#include "common/parser/benchmark.h"
 
 namespace eisner3rd {
-	Run::Run() = default;
+	Run::Run(const int & nBeamSize, const bool & bCubePruning) : m_nBeamSize(nBeamSize < 0 ? AGENDA_SIZE : nBeamSize), m_bCubePruning(bCubePruning) {
+		if (m_nBeamSize < 1 || m_nBeamSize > MAX_AGENDA_SIZE) {
+			std::cout << "beam width " << m_nBeamSize << " is not in 1.." << MAX_AGENDA_SIZE << ", " << AGENDA_SIZE << " is used." << std::endl;
+			m_nBeamSize = AGENDA_SIZE;
+		}
+	}
 
 	Run::~Run() = default;
 
 	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "Training iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
-		std::ifstream input(sInputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN, m_nBeamSize, m_bCubePruning));
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 			parser->finishtraining();
 		}
@@ -38,23 +48,53 @@ namespace eisner3rd {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		EncodedCorpus corpus;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN, m_nBeamSize, m_bCubePruning));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			if (nThreads > 1) {
+				// workers don't load the model, they copy it from the shared parser
+				std::vector<std::unique_ptr<DepParser>> workers;
+				for (int i = 0; i < nThreads; ++i) {
+					workers.push_back(std::unique_ptr<DepParser>(new DepParser("", vecFeatureOutput.back(), ParserState::TRAIN, m_nBeamSize, m_bCubePruning)));
+				}
+				trainEpochs(parser.get(), workers, corpus, vecFeatureOutput, bShuffle, nMixStep);
+			}
+			else {
+				trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+			}
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		return std::unique_ptr<SentenceParser>(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_nBeamSize, m_bCubePruning)));
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
 
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_nBeamSize, m_bCubePruning));
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -69,18 +109,19 @@ namespace eisner3rd {
 	
 	void Run::goldtest(const std::string & sInputFile, const std::string & sFeatureInput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "GoldTest iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST, m_nBeamSize, m_bCubePruning));
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 		}
 		input.close();
@@ -93,4 +134,41 @@ namespace eisner3rd {
 
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
+
+	// parse gold trees with every beam width in vecOptions (default 4 8 16 32),
+	// scoring all beam items and with cube pruning
+	void Run::benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) {
+		std::vector<int> vecBeamSizes;
+		for (const auto & option : vecOptions) {
+			// skip decoder options such as beam=k or grand=k
+			if (std::isdigit(option[0])) {
+				int k = std::atoi(option.c_str());
+				if (k < 1 || k > MAX_AGENDA_SIZE) {
+					std::cout << "beam width " << k << " is not in 1.." << MAX_AGENDA_SIZE << ", skipped." << std::endl;
+					continue;
+				}
+				vecBeamSizes.push_back(k);
+			}
+		}
+		if (vecBeamSizes.empty()) {
+			vecBeamSizes = { 4, 8, 16, 32 };
+		}
+
+		std::vector<DependencyTree> corrects;
+		loadGoldTrees(sInputFile, corrects);
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE));
+		std::cout << "beam\tcombine\tUAS\ttime(s)" << std::endl;
+		for (const auto & k : vecBeamSizes) {
+			for (const auto & cube : { false, true }) {
+				parser->setBeamSize(k, cube);
+				int nWords = 0, nCorrect = 0;
+				double seconds = timeParse(parser.get(), corrects, [&](const int & index, const DependencyTree & tree) {
+					nCorrect += correctHeads(corrects[index], tree);
+					nWords += corrects[index].size();
+				});
+				std::cout << k << "\t" << (cube ? "cube" : "all") << "\t" << (double)nCorrect / nWords << "\t" << seconds << std::endl;
+			}
+		}
+	}
 }
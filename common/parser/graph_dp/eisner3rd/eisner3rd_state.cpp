@@ -14,4 +14,9 @@ namespace eisner3rd {
 		l2r.reset();
 		r2l.reset();
 	}
-}
\ No newline at end of file
+
+	void StateItem::setBeamSize(const int & nBeamSize) {
+		l2r_solid_both.setLimit(nBeamSize);
+		r2l_solid_both.setLimit(nBeamSize);
+	}
+}
@@ -29,6 +29,7 @@ namespace eisner3rd {
 		~StateItem();
 
 		void init(const int & l, const int & r);
+		void setBeamSize(const int & nBeamSize);
 
 		void updateJUX(const int & split, const tscore & score);
 		void updateL2RSolidBoth(const int & split, const int & innersplit, const tscore & score);
@@ -248,4 +248,55 @@ namespace eisner3rd {
 		m_mapC3wC1p.computeAverage(round);
 		m_mapC1pC3p.computeAverage(round);
 	}
+
+	void Weight::mixScores(const Weight & base, const Weight & worker) {
+		m_mapPw.mixScores(base.m_mapPw, worker.m_mapPw);
+		m_mapPp.mixScores(base.m_mapPp, worker.m_mapPp);
+		m_mapPwp.mixScores(base.m_mapPwp, worker.m_mapPwp);
+
+		m_mapCw.mixScores(base.m_mapCw, worker.m_mapCw);
+		m_mapCp.mixScores(base.m_mapCp, worker.m_mapCp);
+		m_mapCwp.mixScores(base.m_mapCwp, worker.m_mapCwp);
+		m_mapPwpCwp.mixScores(base.m_mapPwpCwp, worker.m_mapPwpCwp);
+		m_mapPpCwp.mixScores(base.m_mapPpCwp, worker.m_mapPpCwp);
+		m_mapPwpCp.mixScores(base.m_mapPwpCp, worker.m_mapPwpCp);
+		m_mapPwCwp.mixScores(base.m_mapPwCwp, worker.m_mapPwCwp);
+		m_mapPwpCw.mixScores(base.m_mapPwpCw, worker.m_mapPwpCw);
+		m_mapPwCw.mixScores(base.m_mapPwCw, worker.m_mapPwCw);
+		m_mapPpCp.mixScores(base.m_mapPpCp, worker.m_mapPpCp);
+		m_mapPpBpCp.mixScores(base.m_mapPpBpCp, worker.m_mapPpBpCp);
+		m_mapPpPp1Cp_1Cp.mixScores(base.m_mapPpPp1Cp_1Cp, worker.m_mapPpPp1Cp_1Cp);
+		m_mapPp_1PpCp_1Cp.mixScores(base.m_mapPp_1PpCp_1Cp, worker.m_mapPp_1PpCp_1Cp);
+		m_mapPpPp1CpCp1.mixScores(base.m_mapPpPp1CpCp1, worker.m_mapPpPp1CpCp1);
+		m_mapPp_1PpCpCp1.mixScores(base.m_mapPp_1PpCpCp1, worker.m_mapPp_1PpCpCp1);
+
+		m_mapC1pC2p.mixScores(base.m_mapC1pC2p, worker.m_mapC1pC2p);
+		m_mapPpC1pC2p.mixScores(base.m_mapPpC1pC2p, worker.m_mapPpC1pC2p);
+		m_mapC1wC2w.mixScores(base.m_mapC1wC2w, worker.m_mapC1wC2w);
+		m_mapC1wC2p.mixScores(base.m_mapC1wC2p, worker.m_mapC1wC2p);
+		m_mapC2wC1p.mixScores(base.m_mapC2wC1p, worker.m_mapC2wC1p);
+
+		m_mapPwC1pC2pC3p.mixScores(base.m_mapPwC1pC2pC3p, worker.m_mapPwC1pC2pC3p);
+		m_mapC1wPpC2pC3p.mixScores(base.m_mapC1wPpC2pC3p, worker.m_mapC1wPpC2pC3p);
+		m_mapC2wPpC1pC3p.mixScores(base.m_mapC2wPpC1pC3p, worker.m_mapC2wPpC1pC3p);
+		m_mapC3wPpC1pC2p.mixScores(base.m_mapC3wPpC1pC2p, worker.m_mapC3wPpC1pC2p);
+		m_mapPwC1wC2pC3p.mixScores(base.m_mapPwC1wC2pC3p, worker.m_mapPwC1wC2pC3p);
+		m_mapPwC2wC1pC3p.mixScores(base.m_mapPwC2wC1pC3p, worker.m_mapPwC2wC1pC3p);
+		m_mapPwC3wC1pC2p.mixScores(base.m_mapPwC3wC1pC2p, worker.m_mapPwC3wC1pC2p);
+		m_mapC1wC2wPpC3p.mixScores(base.m_mapC1wC2wPpC3p, worker.m_mapC1wC2wPpC3p);
+		m_mapC1wC3wPpC2p.mixScores(base.m_mapC1wC3wPpC2p, worker.m_mapC1wC3wPpC2p);
+		m_mapC2wC3wPpC1p.mixScores(base.m_mapC2wC3wPpC1p, worker.m_mapC2wC3wPpC1p);
+		m_mapPpC1pC2pC3p.mixScores(base.m_mapPpC1pC2pC3p, worker.m_mapPpC1pC2pC3p);
+		m_mapC1wC2pC3p.mixScores(base.m_mapC1wC2pC3p, worker.m_mapC1wC2pC3p);
+		m_mapC2wC1pC3p.mixScores(base.m_mapC2wC1pC3p, worker.m_mapC2wC1pC3p);
+		m_mapC3wC1pC2p.mixScores(base.m_mapC3wC1pC2p, worker.m_mapC3wC1pC2p);
+		m_mapC1wC2wC3p.mixScores(base.m_mapC1wC2wC3p, worker.m_mapC1wC2wC3p);
+		m_mapC1wC3wC2p.mixScores(base.m_mapC1wC3wC2p, worker.m_mapC1wC3wC2p);
+		m_mapC2wC3wC1p.mixScores(base.m_mapC2wC3wC1p, worker.m_mapC2wC3wC1p);
+		m_mapC1pC2pC3p.mixScores(base.m_mapC1pC2pC3p, worker.m_mapC1pC2pC3p);
+		m_mapC1wC3w.mixScores(base.m_mapC1wC3w, worker.m_mapC1wC3w);
+		m_mapC1wC3p.mixScores(base.m_mapC1wC3p, worker.m_mapC1wC3p);
+		m_mapC3wC1p.mixScores(base.m_mapC3wC1p, worker.m_mapC3wC1p);
+		m_mapC1pC3p.mixScores(base.m_mapC1pC3p, worker.m_mapC1pC3p);
+	}
 }
\ No newline at end of file
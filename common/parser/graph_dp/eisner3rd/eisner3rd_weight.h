@@ -64,6 +64,7 @@ namespace eisner3rd {
 		void loadScores();
 		void saveScores() const;
 		void computeAverageFeatureWeights(const int & round);
+		void mixScores(const Weight & base, const Weight & worker);
 	};
 }
 
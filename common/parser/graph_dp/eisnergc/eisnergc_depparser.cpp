@@ -1,6 +1,5 @@
 #include <set>
 #include <cmath>
-#include <stack>
 #include <cstring>
 #include <algorithm>
 #include <unordered_set>
@@ -8,15 +7,12 @@
 #include "eisnergc_depparser.h"
 #include "common/token/word.h"
 #include "common/token/pos.h"
+#include "common/parser/fixed_stack.h"
 
 namespace eisnergc {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
-	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const int & nGrandSize) :
+		DepParserBase(nState), m_nGrandSize(nGrandSize), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
 
@@ -30,9 +26,10 @@ namespace eisnergc {
 		m_nIteration = atoi(sItr.c_str());
 		std::cout << "Iteration " << m_nIteration << std::endl;
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 	}
 
 	DepParser::~DepParser() {
@@ -44,14 +41,30 @@ namespace eisnergc {
 		// initialize
 		int idx = 0;
 		m_vecCorrectArcs.clear();
-		m_nTrainingRound = round;
 		m_nSentenceLength = correct.size();
 		// for normal sentence
 		for (const auto & node : correct) {
 			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
 		}
-		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		// for normal sentence
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
 		Arcs2BiArcs(m_vecCorrectArcs, m_vecCorrectBiArcs);
 
 		if (m_nState == ParserState::GOLDTEST) {
@@ -87,9 +100,16 @@ namespace eisnergc {
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -109,8 +129,8 @@ namespace eisnergc {
 	void DepParser::decode() {
 
 		initArcScore();
+		initGrands();
 		initGrandChildScore();
-		for (int level = 0; !initGrands(level); ++level);
 
 		for (int i = 0; i < m_nSentenceLength; ++i) {
 			StateItem & item = m_lItems[1][i];
@@ -130,6 +150,9 @@ namespace eisnergc {
 		}
 
 		for (int d = 2; d <= m_nSentenceLength; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 			for (int l = 0, n = m_nSentenceLength - d + 1; l < n; ++l) {
 				int r = l + d - 1;
 				StateItem & item = m_lItems[d][l];
@@ -226,7 +249,7 @@ namespace eisnergc {
 	void DepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int>> stack;
 
 		int s = m_lItems[m_nSentenceLength + 1][0].r2l[0].getSplit();
 		m_vecTrainArcs.push_back(Arc(-1, s));
@@ -404,8 +427,9 @@ namespace eisnergc {
 			for (int j = 0; j < m_nSentenceLength; ++j) {
 				std::vector<tscore> vecScores;
 				if (j != i) {
+					// only arcs g -> i -> j left by the pruner are scored
 					for (int g = 0; g <= m_nSentenceLength; ++g) {
-						vecScores.push_back(g == i || g == j ? 0 : biArcScore(g, i, j));
+						vecScores.push_back(g == i || g == j || !m_vecGrandMask[i][j] || !m_vecGrandMask[g][i] ? 0 : biArcScore(g, i, j));
 					}
 				}
 				vecVecScores.push_back(vecScores);
@@ -414,96 +438,62 @@ namespace eisnergc {
 		}
 	}
 
-	bool DepParser::initGrands(int level) {
-//		std::cout << "level is " << level << std::endl;
+	void DepParser::initGrands() {
+		int n = m_nSentenceLength;
+		m_vecGrandMask.assign(n + 1, std::vector<bool>(n, m_nGrandSize <= 0 || m_nGrandSize >= n));
 
-		std::vector<std::vector<int>> vecGrands;
-		m_vecGrandsAsLeft.clear();
-		m_vecGrandsAsRight.clear();
-
-		if (level < 0) {
-			return false;
-		}
-//		if (level > GRAND_MAX_LEVEL) {
-			for (int p = 0; p < m_nSentenceLength; ++p) {
-				vecGrands.push_back(std::vector<int>());
-				for (int h = 0; h <= m_nSentenceLength; ++h) {
+		if (m_nGrandSize > 0 && m_nGrandSize < n) {
+			// heads scored by the first-order models
+			std::vector<std::vector<tscore>> vecScores(n + 1, std::vector<tscore>(n, 0));
+			for (int h = 0; h <= n; ++h) {
+				for (int p = 0; p < n; ++p) {
 					if (h != p) {
-						vecGrands[p].push_back(h);
+						vecScores[h][p] = m_nState == ParserState::TRAIN ?
+								arc1stScore(h, p) + m_vecArcScore[h][p] * 8237 * 20 :
+								arc1stScore(h, p) * m_nIteration + m_vecArcScore[h][p] * 20;
 					}
 				}
 			}
-			m_vecGrandsAsLeft = vecGrands;
-			m_vecGrandsAsRight = vecGrands;
-			return true;
-//		}
-
-		tscore score;
-		std::unordered_map<int, std::set<int>> grands;
-		for (int p = 0; p < m_nSentenceLength; ++p) {
-			GrandAgendaA gaA;
-			GrandAgendaB gaGC;
-			for (int h = 0; h <= m_nSentenceLength; ++h) {
-				if (h != p) {
-					if (m_nState == ParserState::TRAIN) {
-						score = arc1stScore(h, p) + m_vecArcScore[h][p] * 8237 * 20;
-					}
-					else {
-						score = arc1stScore(h, p) * m_nIteration + m_vecArcScore[h][p] * 20;
-					}
-					if (score >= 0) {
-						gaA.insertItem(ScoreWithSplit(h, score));
-					}
-					for (int m = 0; m < m_nSentenceLength; ++m) {
-						if (m != p && m != h) {
-							score = m_vecArcScore[p][m] + m_vecGrandChildScore[p][m][h];
-							if (score >= 0) {
-								gaGC.insertItem(ScoreWithBiSplit(h, m, score));
-							}
-						}
+			// top k heads of every word
+			std::vector<int> vecHeads;
+			for (int p = 0; p < n; ++p) {
+				vecHeads.clear();
+				for (int h = 0; h <= n; ++h) {
+					if (h != p) {
+						vecHeads.push_back(h);
 					}
 				}
-			}
-			// sort items
-			gaA.sortItems();
-			gaGC.sortItems();
-			int size = (GRAND_AGENDA_SIZE << level);
-			int i = 0;
-			for (const auto & agenda :gaA) {
-				grands[p].insert(agenda->getSplit());
-				if (++i >= size) {
-					break;
+				std::partial_sort(vecHeads.begin(), vecHeads.begin() + m_nGrandSize, vecHeads.end(), [&vecScores, &p](const int & h1, const int & h2) {
+					return vecScores[h1][p] > vecScores[h2][p] || (vecScores[h1][p] == vecScores[h2][p] && h1 < h2);
+				});
+				for (int i = 0; i < m_nGrandSize; ++i) {
+					m_vecGrandMask[vecHeads[i]][p] = true;
 				}
 			}
-			i = 0;
-			for (const auto & agenda : gaGC) {
-				grands[p].insert(agenda->getSplit());
-				grands[agenda->getInnerSplit()].insert(p);
-				if (++i >= size) {
-					break;
+			// the first-order tree keeps the candidates feasible
+			decodeProjectiveHeads(vecScores, n, vecHeads);
+			for (int p = 0; p < n; ++p) {
+				m_vecGrandMask[vecHeads[p]][p] = true;
+			}
+			// so does the gold tree in training
+			if (m_nState != ParserState::PARSE) {
+				for (const auto & arc : m_vecCorrectArcs) {
+					m_vecGrandMask[arc.first() == -1 ? n : arc.first()][arc.second()] = true;
 				}
 			}
-			vecGrands.push_back(std::vector<int>());
 		}
-		std::set<std::pair<int, int>> goldArcs;
-		// generate grand candidate
-		for (const auto & grand : grands) {
-			for (const auto & g : grand.second) {
-				vecGrands[grand.first].push_back(g);
-				goldArcs.insert(std::pair<int, int>(g, grand.first));
+
+		m_vecGrandsAsLeft.assign(n, std::vector<int>());
+		for (int p = 0; p < n; ++p) {
+			for (int h = 0; h <= n; ++h) {
+				if (m_vecGrandMask[h][p]) {
+					m_vecGrandsAsLeft[p].push_back(h);
+				}
 			}
 		}
-		// check if grand candidate can generate a 'non-projective' tree
-		if (!hasNonProjectiveTree(goldArcs, m_nSentenceLength)) {
-			return false;
-		}
-		m_vecGrandsAsLeft = vecGrands;
-		m_vecGrandsAsRight = vecGrands;
-
-		return true;
+		m_vecGrandsAsRight = m_vecGrandsAsLeft;
 	}
 
-
 	void DepParser::get1stStackScore(const int & h, const int & m) {
 		m_pWeight1st->getOrUpdateArcScore(m_nRetval, h, m, 0, m_nSentenceLength, m_lSentence);
 	}
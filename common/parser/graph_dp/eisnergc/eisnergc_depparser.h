@@ -5,20 +5,27 @@
 #include <unordered_set>
 
 #include "eisnergc_state.h"
+#include "common/parser/corpus.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
 #include "common/parser/graph_dp/features/weight1st.h"
 #include "common/parser/graph_dp/features/weightgc.h"
 
 namespace eisnergc {
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
 
 		int m_nIteration;
+		int m_nGrandSize;
 		Weightgc *m_pWeight;
 		Weight1st *m_pWeight1st;
+		FallbackEngine<DepParser> m_cFallback;
 
 		StateItem m_lItems[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE];
@@ -33,6 +40,8 @@ namespace eisnergc {
 		std::vector<std::vector<std::vector<tscore>>> m_vecGrandChildScore;
 		std::vector<std::vector<int>> m_vecGrandsAsLeft;
 		std::vector<std::vector<int>> m_vecGrandsAsRight;
+		// m_vecGrandMask[g][p] if g is kept as a head of p
+		std::vector<std::vector<bool>> m_vecGrandMask;
 
 		int m_nDis, m_nDir;
 
@@ -59,6 +68,7 @@ namespace eisnergc {
 		std::unordered_set<TriGram<int>> m_setSecondGoldScore;
 
 		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck();
 
@@ -67,28 +77,56 @@ namespace eisnergc {
 		const tscore & biArcScore(const int & g, const int & h, const int & m);
 		void initArcScore();
 		void initGrandChildScore();
-		bool initGrands(int level);
+		void initGrands();
 
 		void get1stStackScore(const int & h, const int & m);
 		void getOrUpdateStackScore(const int & h, const int & m, const int & amount);
 		void getOrUpdateStackScore(const int & g, const int & h, const int & m, const int & amount);
 
 	public:
-		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
+		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const int & nGrandSize = GRAND_AGENDA_SIZE);
 		~DepParser();
 
 		void decode();
 		void decodeArcs();
 
 		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
 		void parse(const Sentence & sentence, DependencyTree * retval);
 		void work(DependencyTree * retval, const DependencyTree & correct);
 
+		void setGrandSize(const int & nGrandSize) {
+			m_nGrandSize = nGrandSize;
+		}
+
+		// grandparent candidates of the last decoded sentence
+		bool hasGrand(const int & g, const int & p) const {
+			return m_vecGrandMask[g][p];
+		}
+
 		void finishtraining() {
 			m_pWeight->computeAverageFeatureWeights(m_nTrainingRound);
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut.substr(0, sFeatureOut.find('#')));
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
 	};
 }
 
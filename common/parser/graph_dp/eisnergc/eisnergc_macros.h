@@ -11,8 +11,8 @@ namespace eisnergc {
 #define GOLD_POS_SCORE 10
 #define GOLD_NEG_SCORE -50
 
+// heads kept per word as grandparent candidates, 0 keeps all
 #define GRAND_AGENDA_SIZE 8
-#define GRAND_MAX_LEVEL 2
 
 #define ENCODE_L2R(X)			((X) << 1)
 #define ENCODE_R2L(X)			(((X) << 1) + 1)
@@ -37,9 +37,6 @@ namespace eisnergc {
 	typedef BiGram<int> Arc;
 	typedef TriGram<int> BiArc;
 
-	typedef AgendaBeam<ScoreWithSplit, GRAND_AGENDA_SIZE << GRAND_MAX_LEVEL> GrandAgendaA;
-	typedef AgendaBeam<ScoreWithBiSplit, GRAND_AGENDA_SIZE << GRAND_MAX_LEVEL> GrandAgendaB;
-
 	bool operator<(const Arc & arc1, const Arc & arc2);
 	void Arcs2BiArcs(std::vector<Arc> & arcs, std::vector<BiArc> & biarcs);
 }
@@ -1,4 +1,5 @@
 #include <ctime>
+#include <cctype>
 #include <memory>
 #include <fstream>
 #include <sstream>
@@ -6,26 +7,30 @@
 
 #include "eisnergc_run.h"
 #include "eisnergc_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
+#include "common/parser/benchmark.h"
 
 namespace eisnergc {
-	Run::Run() = default;
+	Run::Run(const int & nGrandSize) : m_nGrandSize(nGrandSize < 0 ? GRAND_AGENDA_SIZE : nGrandSize) {}
 
 	Run::~Run() = default;
 
 	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "Training iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
-		std::ifstream input(sInputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN, m_nGrandSize));
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 			parser->finishtraining();
 		}
@@ -38,23 +43,56 @@ namespace eisnergc {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		EncodedCorpus corpus;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN, m_nGrandSize));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			if (nThreads > 1) {
+				// workers don't load the model, they copy it from the shared parser,
+				// they only load the pruning model, which is the whole input when
+				// it has no '#', as in the constructor
+				std::string sPruning = "#" + sFeatureInput.substr(sFeatureInput.find('#') + 1);
+				std::vector<std::unique_ptr<DepParser>> workers;
+				for (int i = 0; i < nThreads; ++i) {
+					workers.push_back(std::unique_ptr<DepParser>(new DepParser(sPruning, vecFeatureOutput.back(), ParserState::TRAIN, m_nGrandSize)));
+				}
+				trainEpochs(parser.get(), workers, corpus, vecFeatureOutput, bShuffle, nMixStep);
+			}
+			else {
+				trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+			}
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		return std::unique_ptr<SentenceParser>(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_nGrandSize)));
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
 
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_nGrandSize));
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -71,18 +109,19 @@ namespace eisnergc {
 
 	void Run::goldtest(const std::string & sInputFile, const std::string & sFeatureInput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "GoldTest iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST, m_nGrandSize));
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 		}
 		input.close();
@@ -95,4 +134,43 @@ namespace eisnergc {
 
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
+
+	// parse gold trees with every grandparent beam in vecOptions (default 0 1 2 4 8 16)
+	// and report how many gold heads survive pruning, the accuracy and the decoding time
+	void Run::benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) {
+		std::vector<int> vecGrandSizes;
+		for (const auto & option : vecOptions) {
+			// skip decoder options such as beam=k or grand=k
+			if (std::isdigit(option[0])) {
+				vecGrandSizes.push_back(std::atoi(option.c_str()));
+			}
+		}
+		if (vecGrandSizes.empty()) {
+			vecGrandSizes = { 0, 1, 2, 4, 8, 16 };
+		}
+
+		std::vector<DependencyTree> corrects;
+		loadGoldTrees(sInputFile, corrects);
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE));
+		std::cout << "k\tgrands/word\toracle\tUAS\ttime(s)" << std::endl;
+		for (const auto & k : vecGrandSizes) {
+			parser->setGrandSize(k);
+			int nWords = 0, nGrands = 0, nOracle = 0, nCorrect = 0;
+			double seconds = timeParse(parser.get(), corrects, [&](const int & index, const DependencyTree & tree) {
+				const DependencyTree & correct = corrects[index];
+				int n = correct.size();
+				for (int p = 0; p < n; ++p) {
+					int head = TREENODE_HEAD(correct[p]);
+					for (int h = 0; h <= n; ++h) {
+						nGrands += parser->hasGrand(h, p) ? 1 : 0;
+					}
+					nOracle += parser->hasGrand(head == -1 ? n : head, p) ? 1 : 0;
+				}
+				nCorrect += correctHeads(correct, tree);
+				nWords += n;
+			});
+			std::cout << k << "\t" << (double)nGrands / nWords << "\t" << (double)nOracle / nWords << "\t" << (double)nCorrect / nWords << "\t" << seconds << std::endl;
+		}
+	}
 }
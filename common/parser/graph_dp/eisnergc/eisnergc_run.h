@@ -5,13 +5,21 @@
 
 namespace eisnergc {
 	class Run : public RunBase {
+	private:
+		int m_nGrandSize;
+
 	public:
-		Run();
+		// nGrandSize heads are kept per word as grandparent candidates, -1 for the default
+		Run(const int & nGrandSize = -1);
 		~Run();
 
 		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) override;
+		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) override;
 		void parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) override;
+		std::unique_ptr<SentenceParser> load(const std::string & sFeatureFile) override;
+		int timeExponent() const override { return 4; }
 		void goldtest(const std::string & sInputFile, const std::string & sFeatureInput) override;
+		void benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) override;
 	};
 }
 
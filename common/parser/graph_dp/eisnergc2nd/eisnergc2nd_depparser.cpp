@@ -1,61 +1,109 @@
 #include <set>
 #include <cmath>
-#include <stack>
 #include <cstring>
 #include <algorithm>
 #include <unordered_set>
 
+#include <fstream>
+
 #include "eisnergc2nd_depparser.h"
 #include "common/token/word.h"
 #include "common/token/pos.h"
+#include "common/parser/fixed_stack.h"
 
-namespace eisnergc2nd {
+// layout of m_vecPruningScore
+#define PRUNING_ARC(H,P)		((H) * m_nSentenceLength + (P))
+#define PRUNING_BIARC(H,P)		((m_nSentenceLength + 1 + (H)) * m_nSentenceLength + (P))
+#define PRUNING_TRIARC(H,M,P)	((2 * (m_nSentenceLength + 1) + (H) * m_nSentenceLength + (M)) * m_nSentenceLength + (P))
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
+namespace eisnergc2nd {
 
 	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+		DepParserBase(nState), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
 		m_nTrainingRound = 0;
 
 		std::string sFeature = sFeatureInput.substr(0, sFeatureInput.find('#'));
-		std::string sFeature1st = sFeatureInput.substr(sFeatureInput.find('#') + 1) + "eisner.feat";
-		std::string sFeature2nd = sFeatureInput.substr(sFeatureInput.find('#') + 1) + "eisner2nd.feat";
-		std::string sFeaturegc = sFeatureInput.substr(sFeatureInput.find('#') + 1) + "eisnergc.feat";
+		std::string sPruning = sFeatureInput.substr(sFeatureInput.find('#') + 1);
 		std::string sFeatureO = sFeatureOut.substr(0, sFeatureOut.find('#'));
-		m_Weight1st = m_nState == ParserState::GOLDTEST ? nullptr : new Weight1st(sFeature1st, sFeature1st);
-		m_Weight2nd = m_nState == ParserState::GOLDTEST ? nullptr : new Weight2nd(sFeature2nd, sFeature2nd);
-		m_Weightgc = m_nState == ParserState::GOLDTEST ? nullptr : new Weightgc(sFeaturegc, sFeaturegc);
+		m_sFeature1st = sPruning + "eisner.feat";
+		m_sFeature2nd = sPruning + "eisner2nd.feat";
+		m_sFeaturegc = sPruning + "eisnergc.feat";
+		m_Weight1st = nullptr;
+		m_Weight2nd = nullptr;
+		m_Weightgc = nullptr;
+		// pruning models never change in training, their scores are cached per sentence
+		// and the models are only loaded when a sentence misses the cache
+		if (m_nState == ParserState::TRAIN) {
+			m_pPruningCache = ScoreCache::open(sPruning + "eisnergc2nd.cache", ScoreCache::fingerprint({ m_sFeature1st, m_sFeature2nd, m_sFeaturegc }));
+		}
+		if (m_pPruningCache) {
+			// keep the token ids the pruning models were trained with
+			for (const auto & sFile : { m_sFeature1st, m_sFeature2nd, m_sFeaturegc }) {
+				std::ifstream input(sFile);
+				if (input) {
+					input >> TWord::getTokenizer();
+					input >> TPOSTag::getTokenizer();
+				}
+			}
+		}
+		else if (m_nState != ParserState::GOLDTEST) {
+			loadPruningWeights();
+		}
 		m_pWeight = m_nState == ParserState::GOLDTEST ? nullptr : new Weight(sFeature, sFeatureO);
 		std::string sItr = sFeatureO.substr(sFeatureO.find("eisnergc2nd") + strlen("eisnergc2nd")).substr(0, 2);
 		if (!isdigit(sItr[1])) sItr = sItr.substr(0, 1);
 		m_nIteration = atoi(sItr.c_str());
 		std::cout << "Iteration " << m_nIteration << std::endl;
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 	}
 
 	DepParser::~DepParser() {
 		delete m_pWeight;
+		delete m_Weight1st;
+		delete m_Weight2nd;
+		delete m_Weightgc;
+	}
+
+	void DepParser::loadPruningWeights() {
+		m_Weight1st = new Weight1st(m_sFeature1st, m_sFeature1st);
+		m_Weight2nd = new Weight2nd(m_sFeature2nd, m_sFeature2nd);
+		m_Weightgc = new Weightgc(m_sFeaturegc, m_sFeaturegc);
 	}
 
 	void DepParser::train(const DependencyTree & correct, const int & round) {
 		// initialize
 		int idx = 0;
 		m_vecCorrectArcs.clear();
-		m_nTrainingRound = round;
 		m_nSentenceLength = correct.size();
 		// for normal sentence
 		for (const auto & node : correct) {
 			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
 		}
-		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		// for normal sentence
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
 		Arcs2TriArcs(m_vecCorrectArcs, m_vecCorrectTriArcs);
 
 		if (m_nState == ParserState::GOLDTEST) {
@@ -100,9 +148,16 @@ namespace eisnergc2nd {
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -128,6 +183,7 @@ namespace eisnergc2nd {
 		initArcScore();
 		initBiSiblingArcScore();
 		initGrandSiblingArcScore();
+		initPruningScore();
 		for (int level = 0; !initGrands(level); ++level);
 
 		for (int i = 0; i < m_nSentenceLength; ++i) {
@@ -151,6 +207,9 @@ namespace eisnergc2nd {
 		}
 
 		for (int d = 2; d <= m_nSentenceLength; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 			for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
 
 				m_lItems[d].push_back(StateItem());
@@ -313,7 +372,7 @@ namespace eisnergc2nd {
 	void DepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int>> stack;
 
 		int s = m_lItems[m_nSentenceLength + 1][0].r2l[m_nSentenceLength].getSplit();
 		m_vecTrainArcs.push_back(Arc(-1, s));
@@ -598,6 +657,49 @@ namespace eisnergc2nd {
 		}
 	}
 
+	void DepParser::initPruningScore() {
+		int n = m_nSentenceLength, size = (2 * (n + 1) + n * n) * n;
+		m_vecPruningScore.assign(size, 0);
+		if (m_nState == ParserState::GOLDTEST) {
+			return;
+		}
+
+		std::uint64_t key = SCORE_CACHE_HASH_SEED;
+		if (m_pPruningCache) {
+			for (int i = 0; i <= n; ++i) {
+				key = ScoreCache::hash(TWord::key(m_lSentence[i].first()), key);
+				key = ScoreCache::hash(TPOSTag::key(m_lSentence[i].second()), key);
+			}
+			if (m_pPruningCache->find(key, m_vecPruningScore) && (int)m_vecPruningScore.size() == size) {
+				return;
+			}
+			m_vecPruningScore.assign(size, 0);
+			if (m_Weight1st == nullptr) {
+				loadPruningWeights();
+			}
+		}
+
+		for (int p = 0; p < n; ++p) {
+			for (int h = 0; h <= n; ++h) {
+				if (h != p) {
+					m_vecPruningScore[PRUNING_ARC(h, p)] = arc1stScore(h, p);
+					m_vecPruningScore[PRUNING_BIARC(h, p)] = arc2ndScore(h, -1, p);
+					if (h != n) {
+						for (int m = 0; m < n; ++m) {
+							if (m != p && m != h) {
+								m_vecPruningScore[PRUNING_TRIARC(h, m, p)] = arc2ndScore(h, m, p);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		if (m_pPruningCache) {
+			m_pPruningCache->insert(key, m_vecPruningScore);
+		}
+	}
+
 	bool DepParser::initGrands(int level) {
 
 		std::vector<std::vector<int>> vecGrands;
@@ -630,23 +732,20 @@ namespace eisnergc2nd {
 			for (int h = 0; h <= m_nSentenceLength; ++h) {
 				if (h != p) {
 					score = (m_nState == ParserState::TRAIN ?
-							(arc1stScore(h, p) + m_vecArcScore[h][p] * 8237 * 20) :
-							(arc1stScore(h, p) * m_nIteration + m_vecArcScore[h][p] * 20));
+							(m_vecPruningScore[PRUNING_ARC(h, p)] + m_vecArcScore[h][p] * 8237 * 20) :
+							(m_vecPruningScore[PRUNING_ARC(h, p)] * m_nIteration + m_vecArcScore[h][p] * 20));
 					if (score >= 0) gaArc.insertItem(ScoreWithSplit(h, score));
 					score = (m_nState == ParserState::TRAIN ?
-							(arc2ndScore(h, -1, p) + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][h]) * 8237 * 20) :
-							(arc2ndScore(h, -1, p) * m_nIteration + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][h]) * 20));
+							(m_vecPruningScore[PRUNING_BIARC(h, p)] + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][h]) * 8237 * 20) :
+							(m_vecPruningScore[PRUNING_BIARC(h, p)] * m_nIteration + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][h]) * 20));
 					if (score >= 0) gaBiArc.insertItem(ScoreWithBiSplit(h, h, score));
 					for (int m = 0; m < m_nSentenceLength; ++m) {
 						if (m != p && m != h) {
-							score = (m_nState == ParserState::TRAIN ?
-									(arcgcScore(h, p, m) + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][m]) * 8237 * 20) :
-									(arcgcScore(h, p, m) * m_nIteration + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][m]) * 20));
 							gaGC.insertItem(ScoreWithBiSplit(h, m, m_vecGrandChildScore[p][m][h]));
 							if (h != m_nSentenceLength) {
 								score = (m_nState == ParserState::TRAIN ?
-										(arc2ndScore(h, m, p) + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][m]) * 8237 * 20) :
-										(arc2ndScore(h, m, p) * m_nIteration + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][m]) * 20));
+										(m_vecPruningScore[PRUNING_TRIARC(h, m, p)] + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][m]) * 8237 * 20) :
+										(m_vecPruningScore[PRUNING_TRIARC(h, m, p)] * m_nIteration + (m_vecArcScore[h][p] + m_vecBiSiblingScore[h][p][m]) * 20));
 								gaBiArc.insertItem(ScoreWithBiSplit(h, m, score));
 							}
 						}
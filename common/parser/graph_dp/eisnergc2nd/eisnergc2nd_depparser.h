@@ -1,6 +1,7 @@
 #ifndef _EISNERGC2ND_DEPPARSER_H
 #define _EISNERGC2ND_DEPPARSER_H
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
@@ -9,15 +10,21 @@
 #include "eisnergc2nd_1stweight.h"
 #include "eisnergc2nd_2ndweight.h"
 #include "eisnergc2nd_gcweight.h"
+#include "common/parser/corpus.h"
+#include "common/parser/score_cache.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
 
 namespace eisnergc2nd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
 
 		int m_nIteration;
 
@@ -25,6 +32,12 @@ namespace eisnergc2nd {
 		Weight1st *m_Weight1st;
 		Weight2nd *m_Weight2nd;
 		Weightgc *m_Weightgc;
+		std::string m_sFeature1st;
+		std::string m_sFeature2nd;
+		std::string m_sFeaturegc;
+		std::shared_ptr<ScoreCache> m_pPruningCache;
+		// scores of the pruning models for the current sentence
+		std::vector<tscore> m_vecPruningScore;
 
 		std::vector<StateItem> m_lItems[MAX_SENTENCE_SIZE];
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE];
@@ -33,6 +46,7 @@ namespace eisnergc2nd {
 		std::vector<Arc> m_vecTrainArcs;
 		std::vector<TriArc> m_vecTrainTriArcs;
 		int m_nSentenceLength;
+		FallbackEngine<DepParser> m_cFallback;
 
 		tscore m_nRetval;
 		std::vector<std::vector<tscore>> m_vecArcScore;
@@ -72,6 +86,7 @@ namespace eisnergc2nd {
 		std::unordered_set<QuarGram<int>> m_setGrandBiSiblingArcGoldScore;
 
 		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck();
 
@@ -86,6 +101,8 @@ namespace eisnergc2nd {
 		void initArcScore();
 		void initBiSiblingArcScore();
 		void initGrandSiblingArcScore();
+		void loadPruningWeights();
+		void initPruningScore();
 		bool initGrands(int level);
 
 		void getArcScore(const int & p, const int & c);
@@ -105,6 +122,7 @@ namespace eisnergc2nd {
 		void decodeArcs();
 
 		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
 		void parse(const Sentence & sentence, DependencyTree * retval);
 		void work(DependencyTree * retval, const DependencyTree & correct);
 
@@ -113,6 +131,24 @@ namespace eisnergc2nd {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut.substr(0, sFeatureOut.find('#')));
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
 	};
 }
 
@@ -6,6 +6,8 @@
 
 #include "eisnergc2nd_run.h"
 #include "eisnergc2nd_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
 
 namespace eisnergc2nd {
 	Run::Run() = default;
@@ -14,18 +16,19 @@ namespace eisnergc2nd {
 
 	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "Training iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 				if (nRound % 1000 == 0) {
 					std::cout << std::endl;
 					parser->finishtraining();
@@ -43,23 +46,56 @@ namespace eisnergc2nd {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		EncodedCorpus corpus;
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN));
+		CorpusReader input(sInputFile);
+		if (input) {
+			input >> corpus;
+			if (nThreads > 1) {
+				// workers don't load the model, they copy it from the shared parser,
+				// they only load the pruning model, which is the whole input when
+				// it has no '#', as in the constructor
+				std::string sPruning = "#" + sFeatureInput.substr(sFeatureInput.find('#') + 1);
+				std::vector<std::unique_ptr<DepParser>> workers;
+				for (int i = 0; i < nThreads; ++i) {
+					workers.push_back(std::unique_ptr<DepParser>(new DepParser(sPruning, vecFeatureOutput.back(), ParserState::TRAIN)));
+				}
+				trainEpochs(parser.get(), workers, corpus, vecFeatureOutput, bShuffle, nMixStep);
+			}
+			else {
+				trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+			}
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		return std::unique_ptr<SentenceParser>(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE)));
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
 
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -72,18 +108,19 @@ namespace eisnergc2nd {
 
 	void Run::goldtest(const std::string & sInputFile, const std::string & sFeatureInput) {
 		int nRound = 0;
-		DependencyTree ref_sent;
+		EncodedCorpus corpus;
 
 		std::cout << "GoldTest iteration is started..." << std::endl;
 
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
-			while (input >> ref_sent) {
+			input >> corpus;
+			for (int i = 0; i < corpus.size(); ++i) {
 				++nRound;
-				parser->train(ref_sent, nRound);
+				parser->train(corpus[i], nRound);
 			}
 		}
 		input.close();
@@ -10,7 +10,10 @@ namespace eisnergc2nd {
 		~Run();
 
 		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) override;
+		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) override;
 		void parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) override;
+		std::unique_ptr<SentenceParser> load(const std::string & sFeatureFile) override;
+		int timeExponent() const override { return 4; }
 		void goldtest(const std::string & sInputFile, const std::string & sFeatureInput) override;
 	};
 }
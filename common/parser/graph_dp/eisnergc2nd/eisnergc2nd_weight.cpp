@@ -249,4 +249,56 @@ namespace eisnergc2nd {
 		m_mapCwC2wGp.computeAverage(round);
 		m_mapGpCpC2p.computeAverage(round);
 	}
+
+	void Weight::mixScores(const Weight & base, const Weight & worker) {
+		m_mapPw.mixScores(base.m_mapPw, worker.m_mapPw);
+		m_mapPp.mixScores(base.m_mapPp, worker.m_mapPp);
+		m_mapPwp.mixScores(base.m_mapPwp, worker.m_mapPwp);
+		m_mapCw.mixScores(base.m_mapCw, worker.m_mapCw);
+		m_mapCp.mixScores(base.m_mapCp, worker.m_mapCp);
+		m_mapCwp.mixScores(base.m_mapCwp, worker.m_mapCwp);
+		m_mapPwpCwp.mixScores(base.m_mapPwpCwp, worker.m_mapPwpCwp);
+		m_mapPpCwp.mixScores(base.m_mapPpCwp, worker.m_mapPpCwp);
+		m_mapPwpCp.mixScores(base.m_mapPwpCp, worker.m_mapPwpCp);
+		m_mapPwCwp.mixScores(base.m_mapPwCwp, worker.m_mapPwCwp);
+		m_mapPwpCw.mixScores(base.m_mapPwpCw, worker.m_mapPwpCw);
+		m_mapPwCw.mixScores(base.m_mapPwCw, worker.m_mapPwCw);
+		m_mapPpCp.mixScores(base.m_mapPpCp, worker.m_mapPpCp);
+		m_mapPpBpCp.mixScores(base.m_mapPpBpCp, worker.m_mapPpBpCp);
+		m_mapPpPp1Cp_1Cp.mixScores(base.m_mapPpPp1Cp_1Cp, worker.m_mapPpPp1Cp_1Cp);
+		m_mapPp_1PpCp_1Cp.mixScores(base.m_mapPp_1PpCp_1Cp, worker.m_mapPp_1PpCp_1Cp);
+		m_mapPpPp1CpCp1.mixScores(base.m_mapPpPp1CpCp1, worker.m_mapPpPp1CpCp1);
+		m_mapPp_1PpCpCp1.mixScores(base.m_mapPp_1PpCpCp1, worker.m_mapPp_1PpCpCp1);
+
+		m_mapC1pC2p.mixScores(base.m_mapC1pC2p, worker.m_mapC1pC2p);
+		m_mapPpC1pC2p.mixScores(base.m_mapPpC1pC2p, worker.m_mapPpC1pC2p);
+		m_mapC1wC2w.mixScores(base.m_mapC1wC2w, worker.m_mapC1wC2w);
+		m_mapC1wC2p.mixScores(base.m_mapC1wC2p, worker.m_mapC1wC2p);
+		m_mapC2wC1p.mixScores(base.m_mapC2wC1p, worker.m_mapC2wC1p);
+
+		m_mapGpPpCp.mixScores(base.m_mapGpPpCp, worker.m_mapGpPpCp);
+		m_mapGpCp.mixScores(base.m_mapGpCp, worker.m_mapGpCp);
+		m_mapGwCw.mixScores(base.m_mapGwCw, worker.m_mapGwCw);
+		m_mapGwCp.mixScores(base.m_mapGwCp, worker.m_mapGwCp);
+		m_mapCwGp.mixScores(base.m_mapCwGp, worker.m_mapCwGp);
+
+		m_mapGwPpCpC2p.mixScores(base.m_mapGwPpCpC2p, worker.m_mapGwPpCpC2p);
+		m_mapPwGpCpC2p.mixScores(base.m_mapPwGpCpC2p, worker.m_mapPwGpCpC2p);
+		m_mapCwGpPpC2p.mixScores(base.m_mapCwGpPpC2p, worker.m_mapCwGpPpC2p);
+		m_mapC2wGpPpCp.mixScores(base.m_mapC2wGpPpCp, worker.m_mapC2wGpPpCp);
+		m_mapGwPwCpC2p.mixScores(base.m_mapGwPwCpC2p, worker.m_mapGwPwCpC2p);
+		m_mapGwCwPpC2p.mixScores(base.m_mapGwCwPpC2p, worker.m_mapGwCwPpC2p);
+		m_mapGwC2wPpCp.mixScores(base.m_mapGwC2wPpCp, worker.m_mapGwC2wPpCp);
+		m_mapPwCwGpC2p.mixScores(base.m_mapPwCwGpC2p, worker.m_mapPwCwGpC2p);
+		m_mapPwC2wGpCp.mixScores(base.m_mapPwC2wGpCp, worker.m_mapPwC2wGpCp);
+		m_mapCwC2wGpPp.mixScores(base.m_mapCwC2wGpPp, worker.m_mapCwC2wGpPp);
+		m_mapGpPpCpC2p.mixScores(base.m_mapGpPpCpC2p, worker.m_mapGpPpCpC2p);
+		m_mapGwCpC2p.mixScores(base.m_mapGwCpC2p, worker.m_mapGwCpC2p);
+		m_mapCwGpC2p.mixScores(base.m_mapCwGpC2p, worker.m_mapCwGpC2p);
+		m_mapC2wGpCp.mixScores(base.m_mapC2wGpCp, worker.m_mapC2wGpCp);
+		m_mapGwCwC2p.mixScores(base.m_mapGwCwC2p, worker.m_mapGwCwC2p);
+		m_mapGwC2wCp.mixScores(base.m_mapGwC2wCp, worker.m_mapGwC2wCp);
+		m_mapCwC2wGp.mixScores(base.m_mapCwC2wGp, worker.m_mapCwC2wGp);
+		m_mapGpCpC2p.mixScores(base.m_mapGpCpC2p, worker.m_mapGpCpC2p);
+	}
 }
\ No newline at end of file
@@ -69,6 +69,7 @@ namespace eisnergc2nd {
 		void loadScores();
 		void saveScores() const;
 		void computeAverageFeatureWeights(const int & round);
+		void mixScores(const Weight & base, const Weight & worker);
 	};
 }
 
@@ -1,30 +1,27 @@
 #include <set>
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
 #include "eisnergc3rd_depparser.h"
 #include "common/token/word.h"
 #include "common/token/pos.h"
+#include "common/parser/fixed_stack.h"
 
 namespace eisnergc3rd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
 	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+		DepParserBase(nState), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
 		m_nTrainingRound = 0;
 
 		m_pWeight = new Weight(sFeatureInput, sFeatureOut);
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		root_taggedword.refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 	}
 
 	DepParser::~DepParser() {
@@ -35,14 +32,30 @@ namespace eisnergc3rd {
 		// initialize
 		int idx = 0;
 		m_vecCorrectArcs.clear();
-		m_nTrainingRound = round;
 		m_nSentenceLength = correct.size();
 		// for normal sentence
 		for (const auto & node : correct) {
 			m_lSentence[idx].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 			m_vecCorrectArcs.push_back(Arc(TREENODE_HEAD(node), idx++));
 		}
-		m_lSentence[idx].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
+		trainSentence(correct, round);
+	}
+
+	void DepParser::train(const EncodedTree & correct, const int & round) {
+		// initialize
+		m_vecCorrectArcs.clear();
+		m_nSentenceLength = correct.size();
+		// for normal sentence
+		for (int i = 0; i < m_nSentenceLength; ++i) {
+			m_lSentence[i].refer(correct.word(i), correct.postag(i));
+			m_vecCorrectArcs.push_back(Arc(correct.head(i), i));
+		}
+		trainSentence(DependencyTree(), round);
+	}
+
+	void DepParser::trainSentence(const DependencyTree & correct, const int & round) {
+		m_nTrainingRound = round;
+		m_lSentence[m_nSentenceLength].refer(root_taggedword.first(), root_taggedword.second());
 		Arcs2QuarArcs(m_vecCorrectArcs, m_vecCorrectQuarArcs);
 
 		if (m_nState == ParserState::GOLDTEST) {
@@ -91,9 +104,16 @@ namespace eisnergc3rd {
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -142,6 +162,9 @@ namespace eisnergc3rd {
 		}
 
 		for (int d = 2; d <= m_nSentenceLength; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 			for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
 
 				m_lItems[d].push_back(StateItem());
@@ -336,7 +359,7 @@ namespace eisnergc3rd {
 	void DepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int, int>> stack;
 
 		int s = m_lItems[m_nSentenceLength + 1][0].r2l[m_nSentenceLength].getSplit();
 		m_vecTrainArcs.push_back(Arc(-1, s));
@@ -6,15 +6,20 @@
 
 #include "eisnergc3rd_state.h"
 #include "eisnergc3rd_weight.h"
+#include "common/parser/corpus.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
 
 namespace eisnergc3rd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
+		WordPOSTag root_taggedword;
 
 		Weight *m_pWeight;
 
@@ -25,6 +30,7 @@ namespace eisnergc3rd {
 		std::vector<Arc> m_vecTrainArcs;
 		std::vector<QuarArc> m_vecTrainQuarArcs;
 		int m_nSentenceLength;
+		FallbackEngine<DepParser> m_cFallback;
 
 		tscore m_nRetval;
 		std::vector<std::vector<tscore>> m_vecArcScore;
@@ -66,6 +72,7 @@ namespace eisnergc3rd {
 		std::unordered_set<QuinGram<int>> m_setGrandTriSiblingArcGoldScore;
 
 		void update();
+		void trainSentence(const DependencyTree & correct, const int & round);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck();
 
@@ -95,6 +102,7 @@ namespace eisnergc3rd {
 		void decodeArcs();
 
 		void train(const DependencyTree & correct, const int & round);
+		void train(const EncodedTree & correct, const int & round);
 		void parse(const Sentence & sentence, DependencyTree * retval);
 		void work(DependencyTree * retval, const DependencyTree & correct);
 
@@ -103,6 +111,24 @@ namespace eisnergc3rd {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
+
+		// used by parameter mixing
+		void averageScores(const int & round) {
+			m_pWeight->computeAverageFeatureWeights(round);
+		}
+
+		void referScores(const DepParser & parser) {
+			*m_pWeight = *parser.m_pWeight;
+		}
+
+		void mixScores(const DepParser & base, const DepParser & worker) {
+			m_pWeight->mixScores(*base.m_pWeight, *worker.m_pWeight);
+		}
 	};
 }
 
@@ -106,6 +106,7 @@ namespace eisnergc3rd {
 		void loadScores();
 		void saveScores() const;
 		void computeAverageFeatureWeights(const int & round);
+		void mixScores(const Weight & base, const Weight & worker);
 	};
 }
 
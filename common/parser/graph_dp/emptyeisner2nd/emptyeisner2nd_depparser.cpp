@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
@@ -7,28 +6,26 @@
 #include "common/token/pos.h"
 #include "common/token/emp.h"
 #include "emptyeisner2nd_depparser.h"
+#include "common/parser/fixed_stack.h"
 
 namespace emptyeisner2nd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
-	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const bool & bRelaxed) :
+		DepParserBase(nState), m_cEmptyWords(nState != ParserState::PARSE), m_bRelaxed(bRelaxed), m_nEmptyPenalty(0) {
 
 		m_nSentenceLength = 0;
 		m_nSentenceCount = 0;
+		m_nEmptyStride = 1;
+		m_nDistance = 1;
 
 		m_pWeight = new Weightec2nd(sFeatureInput, sFeatureOut, m_nScoreIndex);
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
-
-		m_vecCorrectEmpty = {0, 0, 2, 3, 2, 2, 1, 0, 1, 0, 2, 4, 3, 2, 0, 1, 1, 2, 0, 2, 5, 0, 2, 0, 4, 0, 5, 5, 6, 3, 0, 1, 0, 1, 0, 0, 1, 5, 2, 2, 2, 1, 3, 2, 0, 2, 0, 4, 2, 2, 0, 3, 1, 0, 0, 2, 0, 2, 0, 2, 0, 5, 2, 0, 0, 0, 2, 0, 0, 3, 0, 3, 0, 2, 0, 0, 0, 5, 2, 0, 2, 2, 0, 2, 0, 0, 0, 0, 0, 0, 3, 6, 8, 0, 0, 2, 2, 1, 3, 0, 4, 0, 0, 0, 2, 4, 0, 0, 0, 0, 0, 4, 2, 0, 4, 2, 0, 0, 0, 0, 0, 6, 1, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 2, 4, 2, 2, 0, 1, 0, 1, 4, 3, 2, 0, 3, 2, 1, 2, 0, 3, 0, 1, 5, 0, 0, 0, 2, 2, 4, 1, 0, 1, 3, 3, 1, 4, 4, 4, 3, 4, 2, 2, 0, 0, 0, 0, 1, 0, 0, 2, 0, 3, 2, 2, 3, 0, 4, 4, 0, 0, 0, 4, 0, 1, 7, 2, 0, 1, 0, 2, 1, 2, 0, 0, 0, 4, 0, 5, 2, 2, 1, 0, 0, 0, 1, 0, 3, 3, 1, 2, 0, 0, 2, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 2, 2, 0, 0, 3, 0, 1, 0, 1, 1, 2, 1, 0, 0, 0, 0, 5, 0, 3, 0, 3, 0, 0, 0, 2, 0, 0, 1, 2, 2, 0, 0, 0, 0, 2, 0, 0, 1, 6, 6, 0, 4, 2, 0, 5, 3, 3, 2, 1, 2, 0, 0, 0, 0, 8, 0, 1, 2, 0, 0, 0, 0, 1, 0, 2, 1, 0, 0, 0, 5, 0, 1, 0, 2, 2, 1, 0, 0, 0, 0, 0, 5, 5, 3, 0, 1, 0, 2, 2, 0, 2, 2, 0, 0, 0, 0, 0, 0, 3, 3, 3, 4, 0, 1, 3, 1, 0, 1, 2, 2, 3, 1, 0, 0, 0, 0, 0, 5, 4, 2, 1, 3, 0, 0, 1, 2, 2, 3, 0, 2, 0, 4, 2, 5, 2, 0, 1, 0, 0, 0, 0, 5, 5, 5, 1, 6, 0, 0, 1, 1, 5, 0, 0, 0, 2, 0, 1, 1, 3, 0, 1, 0, 2, 0, 3, 3, 0, 0, 0, 0, 1, 0, 4, 0, 4, 1, 1, 3, 1, 0, 4, 4, 0, 0, 0, 3, 4, 1, 5, 2, 0, 1, 0, 1, 0, 0, 2, 0, 0, 0, 5, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 0, 1, 2, 0, 3, 0, 3, 0, 0, 5, 4, 3, 7, 0, 2, 0, 0, 2, 4, 3, 1, 0, 0, 0, 0, 0, 0, 1, 0, 4, 4, 5, 4, 6, 3, 0, 4, 1, 2, 1, 0, 0, 0, 1, 0, 3, 0, 1, 0, 3, 1, 0, 0, 0, 1, 2, 0, 0, 0, 1, 0, 0, 2, 1, 2, 0};
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		m_cEmptyWords.reserve();
 
-		m_pWeight->init(DepParser::empty_taggedword, DepParser::start_taggedword, DepParser::end_taggedword);
+		m_pWeight->init(empty_taggedword, start_taggedword, end_taggedword);
 	}
 
 	DepParser::~DepParser() {
@@ -36,18 +33,20 @@ namespace emptyeisner2nd {
 	}
 
 	int DepParser::encodeEmptyWord(int i, int ec) {
-		ttoken token =
-//			(i > 0 ? TPOSTag::key(m_lSentence[i - 1][0].second()) : START_WORD) +
-			TEmptyTag::key(ec);
-//			(i < m_nSentenceLength ? TPOSTag::key(m_lSentence[i][0].second()) : END_WORD) +
-			// position information
-			std::to_string(round((double)i / (double)m_nSentenceLength * 1000.0) / 1000.0);
-		return TWord::code(token);
+		// the word only depends on the category and the relative position
+		return m_cEmptyWords.word(ec, i, m_nSentenceLength, [&]() {
+			ttoken token =
+//				(i > 0 ? TPOSTag::key(m_lSentence[i - 1][0].second()) : START_WORD) +
+				TEmptyTag::key(ec);
+//				(i < m_nSentenceLength ? TPOSTag::key(m_lSentence[i][0].second()) : END_WORD) +
+				// position information
+				std::to_string(round((double)i / (double)m_nSentenceLength * 1000.0) / 1000.0);
+			return token;
+		});
 	}
 
 	int DepParser::encodeEmptyPOSTag(int i, int ec) {
-		ttoken token = TEmptyTag::key(ec);
-		return TPOSTag::code(token);
+		return m_cEmptyWords.postag(ec);
 	}
 
 	void DepParser::readEmptySentAndArcs(const DependencyTree & correct) {
@@ -151,13 +150,28 @@ namespace emptyeisner2nd {
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		if (m_bRelaxed && m_nState == ParserState::PARSE) {
+			relax();
+			generate(retval, correct);
+			return;
+		}
+
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
+
+		// the relaxed decoder finishes what the time budget didn't allow
+		if (m_cDeadline.missed() && m_nState == ParserState::PARSE) {
+			relax();
+			generate(retval, correct);
+			return;
+		}
 
 		// find best average tree
 		int maxEC = m_nRealEmpty;
-		double maxScore = (double)m_lItems[0][m_nSentenceLength][maxEC].states[R2L].score / (double)(m_nSentenceLength + maxEC);
+		double maxScore = (double)spanItems(0, m_nSentenceLength)[maxEC].states[R2L].score / (double)(m_nSentenceLength + maxEC);
 		for (int ec = 0; ec <= m_nMaxEmpty; ++ec) {
-			double averageScore = (double)m_lItems[0][m_nSentenceLength][ec].states[R2L].score / (double)(m_nSentenceLength + ec);
+			double averageScore = (double)spanItems(0, m_nSentenceLength)[ec].states[R2L].score / (double)(m_nSentenceLength + ec);
 			if (averageScore > maxScore) {
 				maxEC = ec;
 				maxScore = averageScore;
@@ -171,8 +185,8 @@ namespace emptyeisner2nd {
 //			std::cout << "real empty node is " << m_nRealEmpty << " train empty node is " << maxEC << std::endl;
 			break;
 		case ParserState::PARSE:
-//			std::cout << "score is " << m_lItems[0][m_nSentenceLength][maxEC].states[R2L].score << std::endl; //debug
-			decodeArcs(m_vecCorrectEmpty[maxEC]);
+//			std::cout << "score is " << spanItems(0, m_nSentenceLength)[maxEC].states[R2L].score << std::endl; //debug
+			decodeArcs(maxEC);
 			generate(retval, correct);
 			break;
 		case ParserState::GOLDTEST:
@@ -186,75 +200,89 @@ namespace emptyeisner2nd {
 		}
 	}
 
+	void DepParser::initChart() {
+		int n = m_nSentenceLength;
+		m_nEmptyStride = m_nMaxEmpty + 1;
+		// l <= r <= n
+		m_vecItems.resize((n + 1) * (n + 2) / 2 * m_nEmptyStride);
+		m_vecArcScores.assign((n + 1) * 2 * (MAX_EMPTY_SIZE + 1) * m_nEmptyStride, 0);
+		// distance d has n - d + 2 heads with d splits each
+		int blocks = 0;
+		for (int d = 1; d <= n + 1; ++d) {
+			blocks = std::max(blocks, (n - d + 2) * d);
+		}
+		m_vecBiSiblingScores.assign(blocks * 2 * (MAX_EMPTY_SIZE + 1) * (MAX_EMPTY_SIZE + 1) * m_nEmptyStride, 0);
+	}
+
 	void DepParser::initArcScore(const int & d) {
 		for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
 			tscore l2r_base_empty_score = getOrUpdateInnerEmptyScore(i, i + d - 1, 0);
 			tscore r2l_base_empty_score = getOrUpdateInnerEmptyScore(i + d - 1, i, 0);
 			for (int nec = 0; nec <= m_nMaxEmpty; ++nec) {
 				if (d > 1) {
-					m_lArcScore[i][0][0][nec] = baseArcScore(i, i + d - 1, nec) + l2r_base_empty_score * nec;
-					m_lArcScore[i][1][0][nec] = baseArcScore(i + d - 1, i, nec) + r2l_base_empty_score * nec;
-//					if (i == 7 && d == 7 && nec == 0) std::cout << m_lArcScore[i][1][0][nec] << std::endl;
+					arcScores(i, 0, 0)[nec] = baseArcScore(i, i + d - 1, nec) + l2r_base_empty_score * nec;
+					arcScores(i, 1, 0)[nec] = baseArcScore(i + d - 1, i, nec) + r2l_base_empty_score * nec;
+//					if (i == 7 && d == 7 && nec == 0) std::cout << arcScores(i, 1, 0)[nec] << std::endl;
 				}
 			}
 			for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
 				l2r_base_empty_score = getOrUpdateInnerEmptyScore(i, ENCODE_EMPTY(i + d, ec), 0);
 				r2l_base_empty_score = getOrUpdateInnerEmptyScore(i + d - 1, ENCODE_EMPTY(i, ec), 0);
 				for (int nec = 0; nec <= m_nMaxEmpty; ++nec) {
-					m_lArcScore[i][0][ec][nec] = baseArcScore(i, ENCODE_EMPTY(i + d, ec), nec) + l2r_base_empty_score * nec;
-					m_lArcScore[i][1][ec][nec] = baseArcScore(i + d - 1, ENCODE_EMPTY(i, ec), nec) + r2l_base_empty_score * nec;
+					arcScores(i, 0, ec)[nec] = baseArcScore(i, ENCODE_EMPTY(i + d, ec), nec) + l2r_base_empty_score * nec;
+					arcScores(i, 1, ec)[nec] = baseArcScore(i + d - 1, ENCODE_EMPTY(i, ec), nec) + r2l_base_empty_score * nec;
 				}
 			}
 		}
 		if (d > 1) {
 			tscore r2l_base_empty_score = getOrUpdateInnerEmptyScore(m_nSentenceLength, m_nSentenceLength - d + 1, 0);
 			for (int nec = 0; nec <= m_nMaxEmpty; ++nec) {
-				m_lArcScore[m_nSentenceLength - d + 1][1][0][nec] = baseArcScore(m_nSentenceLength, m_nSentenceLength - d + 1, nec) + r2l_base_empty_score * nec;
+				arcScores(m_nSentenceLength - d + 1, 1, 0)[nec] = baseArcScore(m_nSentenceLength, m_nSentenceLength - d + 1, nec) + r2l_base_empty_score * nec;
 			}
 		}
 	}
 
-	void DepParser::initBiSiblingArcScore(const int & d) {
-		for (int nec = 0; nec <= m_nMaxEmpty; ++nec) {
+	void DepParser::initBiSiblingArcScore(const int & d, const int & nMaxEmpty) {
+		for (int nec = 0; nec <= nMaxEmpty; ++nec) {
 			for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
 				int l = i + d - 1;
 				if (d > 1) {
-					m_lBiSiblingScore[i][0][i][0][0][nec] = biSiblingArcScore(i, -1, l, nec);
-					m_lBiSiblingScore[i][1][i][0][0][nec] = biSiblingArcScore(l, -1, i, nec);
+					biSiblingScores(i, 0, i, 0, 0)[nec] = biSiblingArcScore(i, -1, l, nec);
+					biSiblingScores(i, 1, i, 0, 0)[nec] = biSiblingArcScore(l, -1, i, nec);
 				}
 				if (d == 1) {
 					for (int out_ec = 1; out_ec <= MAX_EMPTY_SIZE; ++out_ec) {
-						m_lBiSiblingScore[i][0][i][0][out_ec][nec] = biSiblingArcScore(i, -1, ENCODE_EMPTY(l + 1, out_ec), nec);
-						m_lBiSiblingScore[i][1][i][0][out_ec][nec] = biSiblingArcScore(l, -1, ENCODE_EMPTY(i, out_ec), nec);
+						biSiblingScores(i, 0, i, 0, out_ec)[nec] = biSiblingArcScore(i, -1, ENCODE_EMPTY(l + 1, out_ec), nec);
+						biSiblingScores(i, 1, i, 0, out_ec)[nec] = biSiblingArcScore(l, -1, ENCODE_EMPTY(i, out_ec), nec);
 					}
 				}
 				else {
 					for (int out_ec = 1; out_ec <= MAX_EMPTY_SIZE; ++out_ec) {
-						m_lBiSiblingScore[i][0][i][0][out_ec][nec] = biSiblingArcScore(i, l, ENCODE_EMPTY(l + 1, out_ec), nec);
-						m_lBiSiblingScore[i][1][i][0][out_ec][nec] = biSiblingArcScore(l, i, ENCODE_EMPTY(i, out_ec), nec);
+						biSiblingScores(i, 0, i, 0, out_ec)[nec] = biSiblingArcScore(i, l, ENCODE_EMPTY(l + 1, out_ec), nec);
+						biSiblingScores(i, 1, i, 0, out_ec)[nec] = biSiblingArcScore(l, i, ENCODE_EMPTY(i, out_ec), nec);
 					}
 				}
 				for (int mid_ec = 1; mid_ec <= MAX_EMPTY_SIZE; ++mid_ec) {
-					m_lBiSiblingScore[i][0][i][mid_ec][0][nec] = biSiblingArcScore(i, ENCODE_EMPTY(i + 1, mid_ec), l, nec);
-					m_lBiSiblingScore[i][1][i][mid_ec][0][nec] = biSiblingArcScore(l, ENCODE_EMPTY(i + 1, mid_ec), i, nec);
+					biSiblingScores(i, 0, i, mid_ec, 0)[nec] = biSiblingArcScore(i, ENCODE_EMPTY(i + 1, mid_ec), l, nec);
+					biSiblingScores(i, 1, i, mid_ec, 0)[nec] = biSiblingArcScore(l, ENCODE_EMPTY(i + 1, mid_ec), i, nec);
 					//if (i == 30 && l == 31) std::cout << "l2r inside score = " << m_lBiSiblingScore[i][0][i][mid_ec][0] << std::endl;
 				}
 				for (int k = i + 1, l = i + d - 1; k < l; ++k) {
 					if (d > 1) {
-						m_lBiSiblingScore[i][0][k][0][0][nec] = biSiblingArcScore(i, k, l, nec);
-						m_lBiSiblingScore[i][1][k][0][0][nec] = biSiblingArcScore(l, k, i, nec);
+						biSiblingScores(i, 0, k, 0, 0)[nec] = biSiblingArcScore(i, k, l, nec);
+						biSiblingScores(i, 1, k, 0, 0)[nec] = biSiblingArcScore(l, k, i, nec);
 					}
 					for (int mid_ec = 1; mid_ec <= MAX_EMPTY_SIZE; ++mid_ec) {
-						m_lBiSiblingScore[i][0][k][mid_ec][0][nec] = biSiblingArcScore(i, ENCODE_EMPTY(k + 1, mid_ec), l, nec);
-						m_lBiSiblingScore[i][1][k][mid_ec][0][nec] = biSiblingArcScore(l, ENCODE_EMPTY(k + 1, mid_ec), i, nec);
+						biSiblingScores(i, 0, k, mid_ec, 0)[nec] = biSiblingArcScore(i, ENCODE_EMPTY(k + 1, mid_ec), l, nec);
+						biSiblingScores(i, 1, k, mid_ec, 0)[nec] = biSiblingArcScore(l, ENCODE_EMPTY(k + 1, mid_ec), i, nec);
 					}
 					for (int out_ec = 1; out_ec <= MAX_EMPTY_SIZE; ++out_ec) {
-						m_lBiSiblingScore[i][0][k][0][out_ec][nec] = biSiblingArcScore(i, k, ENCODE_EMPTY(l + 1, out_ec), nec);
-						m_lBiSiblingScore[i][1][k][0][out_ec][nec] = biSiblingArcScore(l, k, ENCODE_EMPTY(i, out_ec), nec);
+						biSiblingScores(i, 0, k, 0, out_ec)[nec] = biSiblingArcScore(i, k, ENCODE_EMPTY(l + 1, out_ec), nec);
+						biSiblingScores(i, 1, k, 0, out_ec)[nec] = biSiblingArcScore(l, k, ENCODE_EMPTY(i, out_ec), nec);
 					}
 				}
 			}
-			m_lBiSiblingScore[m_nSentenceLength - d + 1][1][m_nSentenceLength - d + 1][0][0][nec] = biSiblingArcScore(m_nSentenceLength, -1, m_nSentenceLength - d + 1, nec);
+			biSiblingScores(m_nSentenceLength - d + 1, 1, m_nSentenceLength - d + 1, 0, 0)[nec] = biSiblingArcScore(m_nSentenceLength, -1, m_nSentenceLength - d + 1, nec);
 		}
 	}
 
@@ -262,22 +290,15 @@ namespace emptyeisner2nd {
 		for (int l = left; l < right; ++l) {
 
 			int r = l + distance - 1;
-			StateItem (&items)[MAX_EMPTY_COUNT] = m_lItems[l][r];
-			const tscore (&l2r_arc_scores_list)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = m_lArcScore[l][0];
-			const tscore (&r2l_arc_scores_list)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = m_lArcScore[l][1];
-			const tscore (&l2r_bi_arc_scores_list)[MAX_SENTENCE_SIZE][MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = m_lBiSiblingScore[l][0];
-			const tscore (&r2l_bi_arc_scores_list)[MAX_SENTENCE_SIZE][MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = m_lBiSiblingScore[l][1];
+			StateItem * items = spanItems(l, r);
 
 			// initialize
 			for (int nec = 0; nec <= m_nMaxEmpty; ++nec) items[nec].init(l, r);
 
 			for (int s = l; s < r; ++s) {
 
-				const tscore (&l2r_bi_arc_scores)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = l2r_bi_arc_scores_list[s];
-				const tscore (&r2l_bi_arc_scores)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = r2l_bi_arc_scores_list[s];
-
-				StateItem (&litems)[MAX_EMPTY_COUNT] = m_lItems[l][s];
-				StateItem (&ritems)[MAX_EMPTY_COUNT] = m_lItems[s + 1][r];
+				StateItem * litems = spanItems(l, s);
+				StateItem * ritems = spanItems(s + 1, r);
 				int lnec = 0;
 				while (lnec <= m_nMaxEmpty) {
 					int rnec = 0;
@@ -297,11 +318,11 @@ namespace emptyeisner2nd {
 						// l2r_empty_inside
 						// split point would be encode as an empty point
 						if (litem.states[L2R_EMPTY_OUTSIDE].split != -1 && ritem.states[R2L].split != -1) {
-							tscore l_empty_inside_base_score = l2r_arc_scores_list[0][lnec + rnec] + ritem.states[R2L].score;
+							tscore l_empty_inside_base_score = arcScores(l, 0, 0)[lnec + rnec] + ritem.states[R2L].score;
 							for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
 								item.updateStates(
 										// bi-sibling arc score
-										l2r_bi_arc_scores[ec][0][rnec] +
+										biSiblingScores(l, 0, s, ec, 0)[rnec] +
 										// left part score
 										litem.states[L2R_EMPTY_OUTSIDE + ec - 1].score +
 										// arc score + right part score
@@ -313,11 +334,11 @@ namespace emptyeisner2nd {
 						// r2l_empty_inside
 						// split point would be encode as an empty point
 						if (litem.states[L2R].split != -1 && ritem.states[R2L_EMPTY_OUTSIDE].split != -1) {
-							tscore r_empty_inside_base_score = r2l_arc_scores_list[0][lnec + rnec] + litem.states[L2R].score;
+							tscore r_empty_inside_base_score = arcScores(l, 1, 0)[lnec + rnec] + litem.states[L2R].score;
 							for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
 								item.updateStates(
 										// bi-sibling arc score
-										r2l_bi_arc_scores[ec][0][lnec] +
+										biSiblingScores(l, 1, s, ec, 0)[lnec] +
 										// right part score
 										ritem.states[R2L_EMPTY_OUTSIDE + ec - 1].score +
 										// arc score + left part score
@@ -334,13 +355,10 @@ namespace emptyeisner2nd {
 
 			for (int s = l + 1; s < r; ++s) {
 
-				StateItem (&litems)[MAX_EMPTY_COUNT] = m_lItems[l][s];
-				StateItem (&ritems)[MAX_EMPTY_COUNT] = m_lItems[s][r];
+				StateItem * litems = spanItems(l, s);
+				StateItem * ritems = spanItems(s, r);
 				int lnec = 0;
 
-				const tscore (&l2r_bi_arc_scores)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = l2r_bi_arc_scores_list[s];
-				const tscore (&r2l_bi_arc_scores)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = r2l_bi_arc_scores_list[s];
-
 				while (lnec <= m_nMaxEmpty) {
 					int rnec = 0;
 					StateItem & litem = litems[lnec];
@@ -356,9 +374,9 @@ namespace emptyeisner2nd {
 										// left part + right part
 										litem.states[L2R_SOLID_OUTSIDE].score + ritem.states[JUX].score +
 										// arc score
-										l2r_arc_scores_list[0][lnec + rnec] +
+										arcScores(l, 0, 0)[lnec + rnec] +
 										// bi-sibling arc score
-										l2r_bi_arc_scores[0][0][rnec],
+										biSiblingScores(l, 0, s, 0, 0)[rnec],
 										s, lnec, L2R_SOLID_BOTH);
 							}
 							if (ritem.states[L2R].split != -1) {
@@ -377,14 +395,14 @@ namespace emptyeisner2nd {
 										// left part + right part
 										litem.states[JUX].score + ritem.states[R2L_SOLID_OUTSIDE].score +
 										//arc score
-										r2l_arc_scores_list[0][lnec + rnec] +
+										arcScores(l, 1, 0)[lnec + rnec] +
 										// bi-sibling arc score
-										r2l_bi_arc_scores[0][0][lnec],
+										biSiblingScores(l, 1, s, 0, 0)[lnec],
 										s, lnec, R2L_SOLID_BOTH);
 //								if (l == 4 && r == 13 && s == 7 && lnec + rnec == 0) {
 //									std::cout << "jux score is " << litem.states[JUX].score << std::endl;
 //									std::cout << "r2l_solid outside score is " << ritem.states[R2L_SOLID_OUTSIDE].score << std::endl;
-//									std::cout << "arc score is " << r2l_arc_scores_list[0][lnec + rnec] << std::endl;
+//									std::cout << "arc score is " << arcScores(l, 1, 0)[lnec + rnec] << std::endl;
 //									std::cout << "bi arc scores is " << r2l_bi_arc_scores[0][0] << std::endl;
 //									std::cout << "score is " << solidItem.states[R2L_SOLID_BOTH].score << std::endl;
 //								}
@@ -406,9 +424,9 @@ namespace emptyeisner2nd {
 									// l2r_empty_outside
 									emptyItem.updateStates(
 											// bi-sibling arc score
-											l2r_bi_arc_scores[0][ec][rnec] +
+											biSiblingScores(l, 0, s, 0, ec)[rnec] +
 											// arc score
-											l2r_arc_scores_list[ec][lnec + rnec] +
+											arcScores(l, 0, ec)[lnec + rnec] +
 											// left part + right part
 											base_score,
 											s, lnec, L2R_EMPTY_OUTSIDE + ec - 1);
@@ -421,9 +439,9 @@ namespace emptyeisner2nd {
 									// r2l_empty_outside
 									emptyItem.updateStates(
 											// bi-sibling arc score
-											r2l_bi_arc_scores[0][ec][lnec] +
+											biSiblingScores(l, 1, s, 0, ec)[lnec] +
 											// arc score
-											r2l_arc_scores_list[ec][lnec + rnec] +
+											arcScores(l, 1, ec)[lnec + rnec] +
 											// left part + right part
 											base_score,
 											s, lnec, R2L_EMPTY_OUTSIDE + ec - 1);
@@ -437,11 +455,8 @@ namespace emptyeisner2nd {
 			}
 
 			if (distance > 1) {
-				StateItem (&litems)[MAX_EMPTY_COUNT] = m_lItems[l][r - 1];
-				StateItem (&ritems)[MAX_EMPTY_COUNT] = m_lItems[l + 1][r];
-
-				const tscore (&l2r_bi_arc_scores)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = l2r_bi_arc_scores_list[l];
-				const tscore (&r2l_bi_arc_scores)[MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT] = r2l_bi_arc_scores_list[l];
+				StateItem * litems = spanItems(l, r - 1);
+				StateItem * ritems = spanItems(l + 1, r);
 
 				int rnec = 0;
 				while (rnec <= m_nMaxEmpty && ritems[rnec].states[R2L].split != -1) {
@@ -450,9 +465,9 @@ namespace emptyeisner2nd {
 							// right part score
 							ritems[rnec].states[R2L].score +
 							// arc score
-							l2r_arc_scores_list[0][rnec] +
+							arcScores(l, 0, 0)[rnec] +
 							// bi-sibling arc score
-							l2r_bi_arc_scores[0][0][rnec],
+							biSiblingScores(l, 0, l, 0, 0)[rnec],
 							// left part is a point, 0 ec
 							l, 0, L2R_SOLID_BOTH);
 					++rnec;
@@ -465,9 +480,9 @@ namespace emptyeisner2nd {
 							// left part score
 							litems[lnec].states[L2R].score +
 							// arc score
-							r2l_arc_scores_list[0][lnec] +
+							arcScores(l, 1, 0)[lnec] +
 							// bi-sibling arc score
-							r2l_bi_arc_scores[0][0][lnec],
+							biSiblingScores(l, 1, l, 0, 0)[lnec],
 							// left part is L2R, lnec ec
 							r, lnec, R2L_SOLID_BOTH);
 					++lnec;
@@ -526,7 +541,7 @@ namespace emptyeisner2nd {
 				rnec = 0;
 				while (rnec <= 1) {
 					lnec = 0;
-					StateItem & ritem = m_lItems[r][r][rnec];
+					StateItem & ritem = spanItems(r, r)[rnec];
 					while (lnec + rnec <= m_nMaxEmpty) {
 						StateItem & litem = items[lnec];
 						if (litem.states[L2R_SOLID_OUTSIDE].split != -1) {
@@ -538,9 +553,9 @@ namespace emptyeisner2nd {
 											// left part + right part
 											litem.states[L2R_SOLID_OUTSIDE].score + ritem.states[L2R].score +
 											// arc score
-											l2r_arc_scores_list[ec][lnec + rnec] +
+											arcScores(l, 0, ec)[lnec + rnec] +
 											// bi-sibling arc score
-											l2r_bi_arc_scores[0][ec][rnec],
+											biSiblingScores(l, 0, l, 0, ec)[rnec],
 											r, lnec, L2R_EMPTY_OUTSIDE + ec - 1);
 								}
 							}
@@ -574,7 +589,7 @@ namespace emptyeisner2nd {
 				lnec = 0;
 				while (lnec <= 1) {
 					rnec = 0;
-					StateItem & litem = m_lItems[l][l][lnec];
+					StateItem & litem = spanItems(l, l)[lnec];
 					while (rnec + lnec < m_nMaxEmpty) {
 						StateItem & ritem = items[rnec];
 						if (ritem.states[R2L_SOLID_OUTSIDE].split != -1) {
@@ -585,9 +600,9 @@ namespace emptyeisner2nd {
 										// left part + right part
 										ritem.states[R2L_SOLID_OUTSIDE].score + litem.states[R2L].score +
 										// arc score
-										r2l_arc_scores_list[ec][rnec + lnec] +
+										arcScores(l, 1, ec)[rnec + lnec] +
 										// bi-sibling arc score
-										r2l_bi_arc_scores[0][ec][lnec],
+										biSiblingScores(l, 1, l, 0, ec)[lnec],
 										l, lnec, R2L_EMPTY_OUTSIDE + ec - 1);
 							}
 							StateItem & item = items[rnec + lnec];
@@ -620,8 +635,8 @@ namespace emptyeisner2nd {
 				for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
 					// l2r_empty_ouside
 					items[1].updateStates(
-							l2r_bi_arc_scores_list[l][0][ec][0] +
-							l2r_arc_scores_list[ec][0],
+							biSiblingScores(l, 0, l, 0, ec)[0] +
+							arcScores(l, 0, ec)[0],
 							r, 1, L2R_EMPTY_OUTSIDE + ec - 1);
 					// l2r with 1 empty node
 					items[1].updateStates(
@@ -634,8 +649,8 @@ namespace emptyeisner2nd {
 				for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
 					// r2l_empty_ouside
 					items[1].updateStates(
-							r2l_bi_arc_scores_list[l][0][ec][0] +
-							r2l_arc_scores_list[ec][0],
+							biSiblingScores(l, 1, l, 0, ec)[0] +
+							arcScores(l, 1, ec)[0],
 							l, 0, R2L_EMPTY_OUTSIDE + ec - 1);
 					// r2l with 1 empty node
 					items[1].updateStates(
@@ -649,19 +664,24 @@ namespace emptyeisner2nd {
 	}
 
 	void DepParser::decode() {
+		initChart();
 
 		for (int d = 1; d <= m_nSentenceLength + 1; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 
+			m_nDistance = d;
 			initArcScore(d);
-			initBiSiblingArcScore(d);
+			initBiSiblingArcScore(d, m_nMaxEmpty);
 
 			decodeSpan(d, 0, m_nSentenceLength - d + 1);
 
 			if (d > 1) {
 				int l = m_nSentenceLength - d + 1, r = m_nSentenceLength;
 				// root
-				StateItem (&l2ritems)[MAX_EMPTY_COUNT] = m_lItems[l][r - 1];
-				StateItem (&items)[MAX_EMPTY_COUNT] = m_lItems[l][r];
+				StateItem * l2ritems = spanItems(l, r - 1);
+				StateItem * items = spanItems(l, r);
 				// initialize
 				for (int nec = 0; nec <= m_nMaxEmpty; ++nec) items[nec].init(l, r);
 				int lnec = 0, rnec = 0;
@@ -669,8 +689,8 @@ namespace emptyeisner2nd {
 					// r2l_solid_outside
 					items[lnec].updateStates(
 							l2ritems[lnec].states[L2R].score +
-							m_lBiSiblingScore[l][1][l][0][0][lnec] +
-							m_lArcScore[l][1][0][lnec],
+							biSiblingScores(l, 1, l, 0, 0)[lnec] +
+							arcScores(l, 1, 0)[lnec],
 							r, lnec, R2L_SOLID_OUTSIDE);
 					++lnec;
 				}
@@ -678,8 +698,8 @@ namespace emptyeisner2nd {
 				// r2l
 				for (int s = l; s < r; ++s) {
 					lnec = 0;
-					StateItem (&litems)[MAX_EMPTY_COUNT] = m_lItems[l][s];
-					StateItem (&ritems)[MAX_EMPTY_COUNT] = m_lItems[s][r];
+					StateItem * litems = spanItems(l, s);
+					StateItem * ritems = spanItems(s, r);
 					while (lnec <= m_nMaxEmpty && litems[lnec].states[R2L].split != -1) {
 						rnec = 0;
 						while (lnec + rnec <= m_nMaxEmpty && ritems[rnec].states[R2L_SOLID_OUTSIDE].split != -1) {
@@ -695,20 +715,371 @@ namespace emptyeisner2nd {
 		}
 	}
 
+	// nec-free decoding
+	// the chart keeps one item per span, the state of an item records in
+	// lecnum the count of empty nodes under its best derivation, and arcs and
+	// bi-sibling arcs are scored with that count as the exact decoder does with
+	// the nec of the item, so every score uses the features of training
+	// choosing the best derivation per state makes the count greedy, and every
+	// empty node pays a penalty instead of tracking the count as a dimension
+	// the penalty is found by dinkelbach iterations on the average tree score,
+	// the criterion work() uses to choose the count: decode with penalty p, set
+	// p to the average score of the result, stop once p doesn't grow
+	void DepParser::relax() {
+		m_vecRelaxedScores.clear();
+		int nec = decodeRelaxed(0);
+		for (int iteration = 0; iteration < MAX_RELAX_ITERATION; ++iteration) {
+			tscore score = spanItems(0, m_nSentenceLength)[0].states[R2L].score + m_nEmptyPenalty * nec;
+			tscore penalty = score / (m_nSentenceLength + nec);
+			if (iteration > 0 && penalty <= m_nEmptyPenalty) {
+				break;
+			}
+			nec = decodeRelaxed(penalty);
+		}
+	}
+
+	int DepParser::decodeRelaxed(const tscore & penalty) {
+		m_nEmptyPenalty = penalty;
+
+		bool bScore = m_vecRelaxedScores.empty();
+		std::size_t index = 0;
+		if (bScore) {
+			initChart();
+		}
+		for (int d = 1; d <= m_nSentenceLength + 1; ++d) {
+
+			m_nDistance = d;
+			std::size_t begin = index;
+			if (bScore) {
+				initArcScore(d);
+				// other counts are scored once relaxedBiSiblingScore() needs them
+				initBiSiblingArcScore(d, 0);
+				forEachRelaxedScore(d, [](tscore *) {}, [&](tscore * scores) {
+					std::fill(scores + 1, scores + m_nEmptyStride, RELAXED_UNSCORED);
+				});
+			}
+			else {
+				cacheRelaxedScore(d, false, index);
+			}
+
+			decodeRelaxedSpan(d, 0, m_nSentenceLength - d + 1);
+
+			if (d > 1) {
+				int l = m_nSentenceLength - d + 1, r = m_nSentenceLength;
+				// root
+				StateItem & l2ritem = spanItems(l, r - 1)[0];
+				StateItem & item = spanItems(l, r)[0];
+				item.init(l, r);
+				if (l2ritem.states[L2R].split != -1) {
+					int lnec = l2ritem.states[L2R].lecnum;
+					// r2l_solid_outside
+					item.updateStates(
+							l2ritem.states[L2R].score +
+							relaxedBiSiblingScore(l, 1, l, 0, 0, lnec) +
+							arcScores(l, 1, 0)[relaxedEmpty(lnec)],
+							r, lnec, R2L_SOLID_OUTSIDE);
+				}
+
+				// r2l
+				for (int s = l; s < r; ++s) {
+					StateItem & litem = spanItems(l, s)[0];
+					StateItem & ritem = spanItems(s, r)[0];
+					if (litem.states[R2L].split != -1 && ritem.states[R2L_SOLID_OUTSIDE].split != -1) {
+						item.updateStates(
+								litem.states[R2L].score + ritem.states[R2L_SOLID_OUTSIDE].score,
+								s, litem.states[R2L].lecnum + ritem.states[R2L_SOLID_OUTSIDE].lecnum, R2L);
+					}
+				}
+			}
+
+			// keeps the bi-sibling scores this pass added for the next ones
+			index = begin;
+			cacheRelaxedScore(d, true, index);
+		}
+
+		return decodeRelaxedArcs();
+	}
+
+	// arc scores don't depend on the penalty, so the first pass saves the
+	// scores of every distance and later passes copy them back
+	void DepParser::cacheRelaxedScore(const int & d, const bool & bSave, std::size_t & index) {
+		auto cache = [&](tscore * scores) {
+			for (int nec = 0; nec < m_nEmptyStride; ++nec, ++index) {
+				if (!bSave) {
+					scores[nec] = m_vecRelaxedScores[index];
+				}
+				else if (index < m_vecRelaxedScores.size()) {
+					m_vecRelaxedScores[index] = scores[nec];
+				}
+				else {
+					m_vecRelaxedScores.push_back(scores[nec]);
+				}
+			}
+		};
+		forEachRelaxedScore(d, cache, cache);
+	}
+
+	// the arcs of distance d and the bi-sibling arcs the relaxed decoder uses,
+	// those with both an empty middle and an empty outer child never are
+	template<typename ARC_FUNC, typename BI_SIBLING_FUNC>
+	void DepParser::forEachRelaxedScore(const int & d, ARC_FUNC arc, BI_SIBLING_FUNC biSibling) {
+		for (int i = 0, max_i = m_nSentenceLength - d + 1; i <= max_i; ++i) {
+			for (int dir = 0; dir < 2; ++dir) {
+				for (int ec = 0; ec <= MAX_EMPTY_SIZE; ++ec) {
+					arc(arcScores(i, dir, ec));
+				}
+				for (int k = i, max_k = i + d; k < max_k; ++k) {
+					biSibling(biSiblingScores(i, dir, k, 0, 0));
+					for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+						biSibling(biSiblingScores(i, dir, k, ec, 0));
+						biSibling(biSiblingScores(i, dir, k, 0, ec));
+					}
+				}
+			}
+		}
+	}
+
+	// biSiblingScores() of nec empty nodes, scored on first use with the
+	// children initBiSiblingArcScore() gives the entry
+	tscore DepParser::relaxedBiSiblingScore(const int & i, const int & dir, const int & k, const int & mid_ec, const int & out_ec, const int & nec) {
+		tscore & score = biSiblingScores(i, dir, k, mid_ec, out_ec)[relaxedEmpty(nec)];
+		if (score == RELAXED_UNSCORED) {
+			int l = i + m_nDistance - 1;
+			int c = mid_ec != 0 ? ENCODE_EMPTY(k + 1, mid_ec) : k != i ? k : out_ec == 0 || m_nDistance == 1 ? -1 : dir == 0 ? l : i;
+			int c2 = out_ec == 0 ? (dir == 0 ? l : i) : ENCODE_EMPTY(dir == 0 ? l + 1 : i, out_ec);
+			score = biSiblingArcScore(dir == 0 ? i : l, c, c2, relaxedEmpty(nec));
+		}
+		return score;
+	}
+
+	// decodeSpan with every span kept in spanItems(l, r)[0], lecnum of a state
+	// is the count of empty nodes under it rather than under its left part
+	void DepParser::decodeRelaxedSpan(int distance, int left, int right) {
+		for (int l = left; l < right; ++l) {
+
+			int r = l + distance - 1;
+			StateItem & item = spanItems(l, r)[0];
+
+			// initialize
+			item.init(l, r);
+
+			if (distance == 1) {
+				// l2r, r2l
+				item.updateStates(0, r, 0, L2R);
+				item.updateStates(0, l, 0, R2L);
+				for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+					// l2r_empty_ouside
+					item.updateStates(
+							biSiblingScores(l, 0, l, 0, ec)[0] +
+							arcScores(l, 0, ec)[0] -
+							m_nEmptyPenalty,
+							r, 1, L2R_EMPTY_OUTSIDE + ec - 1);
+					// l2r with 1 empty node
+					item.updateStates(
+							item.states[L2R_EMPTY_OUTSIDE + ec - 1].score,
+							ENCODE_EMPTY(l, ec), 1, L2R);
+					// r2l_empty_ouside
+					item.updateStates(
+							biSiblingScores(l, 1, l, 0, ec)[0] +
+							arcScores(l, 1, ec)[0] -
+							m_nEmptyPenalty,
+							l, 1, R2L_EMPTY_OUTSIDE + ec - 1);
+					// r2l with 1 empty node
+					item.updateStates(
+							item.states[R2L_EMPTY_OUTSIDE + ec - 1].score,
+							ENCODE_EMPTY(l, ec), 1, R2L);
+				}
+				continue;
+			}
+
+			for (int s = l; s < r; ++s) {
+
+				StateItem & litem = spanItems(l, s)[0];
+				StateItem & ritem = spanItems(s + 1, r)[0];
+
+				// jux
+				if (litem.states[L2R].split != -1 && ritem.states[R2L].split != -1) {
+					item.updateStates(
+							litem.states[L2R].score + ritem.states[R2L].score,
+							s, litem.states[L2R].lecnum + ritem.states[R2L].lecnum, JUX);
+				}
+
+				for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+					// l2r_empty_inside
+					if (litem.states[L2R_EMPTY_OUTSIDE + ec - 1].split != -1 && ritem.states[R2L].split != -1) {
+						int lnec = litem.states[L2R_EMPTY_OUTSIDE + ec - 1].lecnum, rnec = ritem.states[R2L].lecnum;
+						item.updateStates(
+								relaxedBiSiblingScore(l, 0, s, ec, 0, rnec) +
+								litem.states[L2R_EMPTY_OUTSIDE + ec - 1].score +
+								arcScores(l, 0, 0)[relaxedEmpty(lnec + rnec)] + ritem.states[R2L].score,
+								ENCODE_EMPTY(s, ec), lnec + rnec, L2R_EMPTY_INSIDE);
+					}
+					// r2l_empty_inside
+					if (litem.states[L2R].split != -1 && ritem.states[R2L_EMPTY_OUTSIDE + ec - 1].split != -1) {
+						int lnec = litem.states[L2R].lecnum, rnec = ritem.states[R2L_EMPTY_OUTSIDE + ec - 1].lecnum;
+						item.updateStates(
+								relaxedBiSiblingScore(l, 1, s, ec, 0, lnec) +
+								ritem.states[R2L_EMPTY_OUTSIDE + ec - 1].score +
+								arcScores(l, 1, 0)[relaxedEmpty(lnec + rnec)] + litem.states[L2R].score,
+								ENCODE_EMPTY(s, ec), lnec + rnec, R2L_EMPTY_INSIDE);
+					}
+				}
+			}
+
+			for (int s = l + 1; s < r; ++s) {
+
+				StateItem & litem = spanItems(l, s)[0];
+				StateItem & ritem = spanItems(s, r)[0];
+
+				if (litem.states[L2R_SOLID_OUTSIDE].split != -1) {
+					int lnec = litem.states[L2R_SOLID_OUTSIDE].lecnum;
+					if (ritem.states[JUX].split != -1) {
+						int rnec = ritem.states[JUX].lecnum;
+						// l2r_solid_both
+						item.updateStates(
+								litem.states[L2R_SOLID_OUTSIDE].score + ritem.states[JUX].score +
+								arcScores(l, 0, 0)[relaxedEmpty(lnec + rnec)] +
+								relaxedBiSiblingScore(l, 0, s, 0, 0, rnec),
+								s, lnec + rnec, L2R_SOLID_BOTH);
+					}
+					if (ritem.states[L2R].split != -1) {
+						int rnec = ritem.states[L2R].lecnum;
+						tscore base_score = litem.states[L2R_SOLID_OUTSIDE].score + ritem.states[L2R].score;
+						// l2r
+						item.updateStates(base_score, s, lnec + rnec, L2R);
+						for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+							// l2r_empty_outside
+							item.updateStates(
+									relaxedBiSiblingScore(l, 0, s, 0, ec, rnec) +
+									arcScores(l, 0, ec)[relaxedEmpty(lnec + rnec)] +
+									base_score - m_nEmptyPenalty,
+									s, lnec + rnec + 1, L2R_EMPTY_OUTSIDE + ec - 1);
+						}
+					}
+				}
+
+				if (ritem.states[R2L_SOLID_OUTSIDE].split != -1) {
+					int rnec = ritem.states[R2L_SOLID_OUTSIDE].lecnum;
+					if (litem.states[JUX].split != -1) {
+						int lnec = litem.states[JUX].lecnum;
+						// r2l_solid_both
+						item.updateStates(
+								litem.states[JUX].score + ritem.states[R2L_SOLID_OUTSIDE].score +
+								arcScores(l, 1, 0)[relaxedEmpty(lnec + rnec)] +
+								relaxedBiSiblingScore(l, 1, s, 0, 0, lnec),
+								s, lnec + rnec, R2L_SOLID_BOTH);
+					}
+					if (litem.states[R2L].split != -1) {
+						int lnec = litem.states[R2L].lecnum;
+						tscore base_score = litem.states[R2L].score + ritem.states[R2L_SOLID_OUTSIDE].score;
+						// r2l
+						item.updateStates(base_score, s, lnec + rnec, R2L);
+						for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+							// r2l_empty_outside
+							item.updateStates(
+									relaxedBiSiblingScore(l, 1, s, 0, ec, lnec) +
+									arcScores(l, 1, ec)[relaxedEmpty(lnec + rnec)] +
+									base_score - m_nEmptyPenalty,
+									s, lnec + rnec + 1, R2L_EMPTY_OUTSIDE + ec - 1);
+						}
+					}
+				}
+			}
+
+			StateItem & litem = spanItems(l, r - 1)[0];
+			StateItem & ritem = spanItems(l + 1, r)[0];
+
+			if (ritem.states[R2L].split != -1) {
+				int rnec = ritem.states[R2L].lecnum;
+				// l2r_solid_both
+				item.updateStates(
+						ritem.states[R2L].score +
+						arcScores(l, 0, 0)[relaxedEmpty(rnec)] +
+						relaxedBiSiblingScore(l, 0, l, 0, 0, rnec),
+						l, rnec, L2R_SOLID_BOTH);
+			}
+			if (litem.states[L2R].split != -1) {
+				int lnec = litem.states[L2R].lecnum;
+				// r2l_solid_both
+				item.updateStates(
+						litem.states[L2R].score +
+						arcScores(l, 1, 0)[relaxedEmpty(lnec)] +
+						relaxedBiSiblingScore(l, 1, l, 0, 0, lnec),
+						r, lnec, R2L_SOLID_BOTH);
+			}
+
+			// l2r_solid_outside, r2l_solid_outside
+			for (const auto & type : { L2R_SOLID_BOTH, L2R_EMPTY_INSIDE }) {
+				if (item.states[type].split != -1) {
+					item.updateStates(item.states[type].score, item.states[type].split, item.states[type].lecnum, L2R_SOLID_OUTSIDE);
+				}
+			}
+			for (const auto & type : { R2L_SOLID_BOTH, R2L_EMPTY_INSIDE }) {
+				if (item.states[type].split != -1) {
+					item.updateStates(item.states[type].score, item.states[type].split, item.states[type].lecnum, R2L_SOLID_OUTSIDE);
+				}
+			}
+
+			if (item.states[L2R_SOLID_OUTSIDE].split != -1) {
+				const StateScore & rstate = spanItems(r, r)[0].states[L2R];
+				int lnec = item.states[L2R_SOLID_OUTSIDE].lecnum;
+				tscore base_score = item.states[L2R_SOLID_OUTSIDE].score + rstate.score;
+				for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+					// l2r_empty_ouside
+					item.updateStates(
+							arcScores(l, 0, ec)[relaxedEmpty(lnec + rstate.lecnum)] +
+							relaxedBiSiblingScore(l, 0, l, 0, ec, rstate.lecnum) +
+							base_score - m_nEmptyPenalty,
+							r, lnec + rstate.lecnum + 1, L2R_EMPTY_OUTSIDE + ec - 1);
+				}
+				// l2r
+				item.updateStates(base_score, r, lnec + rstate.lecnum, L2R);
+			}
+			for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+				if (item.states[L2R_EMPTY_OUTSIDE + ec - 1].split != -1) {
+					// l2r
+					item.updateStates(item.states[L2R_EMPTY_OUTSIDE + ec - 1].score, ENCODE_EMPTY(r, ec), item.states[L2R_EMPTY_OUTSIDE + ec - 1].lecnum, L2R);
+				}
+			}
+
+			if (item.states[R2L_SOLID_OUTSIDE].split != -1) {
+				const StateScore & lstate = spanItems(l, l)[0].states[R2L];
+				int rnec = item.states[R2L_SOLID_OUTSIDE].lecnum;
+				tscore base_score = item.states[R2L_SOLID_OUTSIDE].score + lstate.score;
+				for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+					// r2l_empty_ouside
+					item.updateStates(
+							arcScores(l, 1, ec)[relaxedEmpty(lstate.lecnum + rnec)] +
+							relaxedBiSiblingScore(l, 1, l, 0, ec, lstate.lecnum) +
+							base_score - m_nEmptyPenalty,
+							l, lstate.lecnum + rnec + 1, R2L_EMPTY_OUTSIDE + ec - 1);
+				}
+				// r2l
+				item.updateStates(base_score, l, lstate.lecnum + rnec, R2L);
+			}
+			for (int ec = 1; ec <= MAX_EMPTY_SIZE; ++ec) {
+				if (item.states[R2L_EMPTY_OUTSIDE + ec - 1].split != -1) {
+					// r2l
+					item.updateStates(item.states[R2L_EMPTY_OUTSIDE + ec - 1].score, ENCODE_EMPTY(l, ec), item.states[R2L_EMPTY_OUTSIDE + ec - 1].lecnum, R2L);
+				}
+			}
+		}
+	}
+
 	void DepParser::decodeArcs(int nec) {
 
 		m_vecTrainECArcs.clear();
 
-		if (m_lItems[0][m_nSentenceLength][nec].states[R2L].split == -1) return;
+		if (spanItems(0, m_nSentenceLength)[nec].states[R2L].split == -1) return;
 		typedef std::tuple<int, int, int> sItem;
-		std::stack<sItem> stack;
+		FixedStack<sItem> stack;
 		stack.push(sItem(0, m_nSentenceLength, nec));
-		m_lItems[0][m_nSentenceLength][nec].type = R2L;
+		spanItems(0, m_nSentenceLength)[nec].type = R2L;
 
 		while (!stack.empty()) {
 			sItem span = stack.top();
 			stack.pop();
-			StateItem & item = m_lItems[std::get<0>(span)][std::get<1>(span)][std::get<2>(span)];
+			StateItem & item = spanItems(std::get<0>(span), std::get<1>(span))[std::get<2>(span)];
 			int split = item.states[item.type].split;
 			int tnec = std::get<2>(span), lnec = item.states[item.type].lecnum;
 
@@ -717,9 +1088,9 @@ namespace emptyeisner2nd {
 
 			switch (item.type) {
 			case JUX:
-				m_lItems[item.left][split][lnec].type = L2R;
+				spanItems(item.left, split)[lnec].type = L2R;
 				stack.push(sItem(item.left, split, lnec));
-				m_lItems[split + 1][item.right][tnec - lnec].type = R2L;
+				spanItems(split + 1, item.right)[tnec - lnec].type = R2L;
 				stack.push(sItem(split + 1, item.right, tnec - lnec));
 				break;
 			case L2R:
@@ -732,9 +1103,9 @@ namespace emptyeisner2nd {
 					break;
 				}
 
-				m_lItems[item.left][split][lnec].type = L2R_SOLID_OUTSIDE;
+				spanItems(item.left, split)[lnec].type = L2R_SOLID_OUTSIDE;
 				stack.push(sItem(item.left, split, lnec));
-				m_lItems[split][item.right][tnec - lnec].type = L2R;
+				spanItems(split, item.right)[tnec - lnec].type = L2R;
 				stack.push(sItem(split, item.right, tnec - lnec));
 				break;
 			case R2L:
@@ -747,9 +1118,9 @@ namespace emptyeisner2nd {
 					break;
 				}
 
-				m_lItems[split][item.right][tnec - lnec].type = R2L_SOLID_OUTSIDE;
+				spanItems(split, item.right)[tnec - lnec].type = R2L_SOLID_OUTSIDE;
 				stack.push(sItem(split, item.right, tnec - lnec));
-				m_lItems[item.left][split][lnec].type = R2L;
+				spanItems(item.left, split)[lnec].type = R2L;
 				stack.push(sItem(item.left, split, lnec));
 				break;
 			case L2R_SOLID_BOTH:
@@ -759,13 +1130,13 @@ namespace emptyeisner2nd {
 				m_vecTrainECArcs.push_back(ECArc(item.left, item.right, tnec));
 
 				if (split == item.left) {
-					m_lItems[item.left + 1][item.right][tnec - lnec].type = R2L;
+					spanItems(item.left + 1, item.right)[tnec - lnec].type = R2L;
 					stack.push(sItem(item.left + 1, item.right, tnec - lnec));
 				}
 				else {
-					m_lItems[item.left][split][lnec].type = L2R_SOLID_OUTSIDE;
+					spanItems(item.left, split)[lnec].type = L2R_SOLID_OUTSIDE;
 					stack.push(sItem(item.left, split, lnec));
-					m_lItems[split][item.right][tnec - lnec].type = JUX;
+					spanItems(split, item.right)[tnec - lnec].type = JUX;
 					stack.push(sItem(split, item.right, tnec - lnec));
 				}
 				break;
@@ -776,13 +1147,13 @@ namespace emptyeisner2nd {
 				m_vecTrainECArcs.push_back(ECArc(item.right == m_nSentenceLength ? -1 : item.right, item.left, tnec));
 
 				if (split == item.right) {
-					m_lItems[item.left][item.right - 1][lnec].type = L2R;
+					spanItems(item.left, item.right - 1)[lnec].type = L2R;
 					stack.push(sItem(item.left, item.right - 1, lnec));
 				}
 				else {
-					m_lItems[split][item.right][tnec - lnec].type = R2L_SOLID_OUTSIDE;
+					spanItems(split, item.right)[tnec - lnec].type = R2L_SOLID_OUTSIDE;
 					stack.push(sItem(split, item.right, tnec - lnec));
-					m_lItems[item.left][split][lnec].type = JUX;
+					spanItems(item.left, split)[lnec].type = JUX;
 					stack.push(sItem(item.left, split, lnec));
 				}
 				break;
@@ -792,9 +1163,9 @@ namespace emptyeisner2nd {
 				}
 				m_vecTrainECArcs.push_back(ECArc(item.left, item.right, tnec));
 
-				m_lItems[item.left][DECODE_EMPTY_POS(split)][lnec].type = L2R_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
+				spanItems(item.left, DECODE_EMPTY_POS(split))[lnec].type = L2R_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
 				stack.push(sItem(item.left, DECODE_EMPTY_POS(split), lnec));
-				m_lItems[DECODE_EMPTY_POS(split) + 1][item.right][tnec - lnec].type = R2L;
+				spanItems(DECODE_EMPTY_POS(split) + 1, item.right)[tnec - lnec].type = R2L;
 				stack.push(sItem(DECODE_EMPTY_POS(split) + 1, item.right, tnec - lnec));
 				break;
 			case R2L_EMPTY_INSIDE:
@@ -803,9 +1174,9 @@ namespace emptyeisner2nd {
 				}
 				m_vecTrainECArcs.push_back(ECArc(item.right, item.left, tnec));
 
-				m_lItems[DECODE_EMPTY_POS(split) + 1][item.right][tnec - lnec].type = R2L_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
+				spanItems(DECODE_EMPTY_POS(split) + 1, item.right)[tnec - lnec].type = R2L_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
 				stack.push(sItem(DECODE_EMPTY_POS(split) + 1, item.right, tnec - lnec));
-				m_lItems[item.left][DECODE_EMPTY_POS(split)][lnec].type = L2R;
+				spanItems(item.left, DECODE_EMPTY_POS(split))[lnec].type = L2R;
 				stack.push(sItem(item.left, DECODE_EMPTY_POS(split), lnec));
 				break;
 			case L2R_SOLID_OUTSIDE:
@@ -822,7 +1193,7 @@ namespace emptyeisner2nd {
 				}
 				if (item.right == m_nSentenceLength) {
 					m_vecTrainECArcs.push_back(ECArc(-1, item.left, tnec));
-					m_lItems[item.left][item.right - 1][lnec].type = L2R;
+					spanItems(item.left, item.right - 1)[lnec].type = L2R;
 					stack.push(sItem(item.left, item.right - 1, lnec));
 					break;
 				}
@@ -837,9 +1208,9 @@ namespace emptyeisner2nd {
 					break;
 				}
 
-				m_lItems[item.left][split][lnec].type = L2R_SOLID_OUTSIDE;
+				spanItems(item.left, split)[lnec].type = L2R_SOLID_OUTSIDE;
 				stack.push(sItem(item.left, split, lnec));
-				m_lItems[split][item.right][tnec - lnec - 1].type = L2R;
+				spanItems(split, item.right)[tnec - lnec - 1].type = L2R;
 				stack.push(sItem(split, item.right, tnec - lnec - 1));
 				break;
 			case R2L_EMPTY_OUTSIDE + 0:
@@ -849,9 +1220,9 @@ namespace emptyeisner2nd {
 					break;
 				}
 
-				m_lItems[split][item.right][tnec - lnec - 1].type = R2L_SOLID_OUTSIDE;
+				spanItems(split, item.right)[tnec - lnec - 1].type = R2L_SOLID_OUTSIDE;
 				stack.push(sItem(split, item.right, tnec - lnec - 1));
-				m_lItems[item.left][split][lnec].type = R2L;
+				spanItems(item.left, split)[lnec].type = R2L;
 				stack.push(sItem(item.left, split, lnec));
 				break;
 			default:
@@ -860,6 +1231,167 @@ namespace emptyeisner2nd {
 		}
 	}
 
+	// decodeArcs over the relaxed chart, returns the number of empty nodes
+	// arcs carry no empty count
+	int DepParser::decodeRelaxedArcs() {
+
+		m_vecTrainECArcs.clear();
+
+		if (spanItems(0, m_nSentenceLength)[0].states[R2L].split == -1) return 0;
+		int nec = 0;
+		typedef std::pair<int, int> sItem;
+		FixedStack<sItem> stack;
+		stack.push(sItem(0, m_nSentenceLength));
+		spanItems(0, m_nSentenceLength)[0].type = R2L;
+
+		while (!stack.empty()) {
+			sItem span = stack.top();
+			stack.pop();
+			StateItem & item = spanItems(span.first, span.second)[0];
+			int split = item.states[item.type].split;
+
+			switch (item.type) {
+			case JUX:
+				spanItems(item.left, split)[0].type = L2R;
+				stack.push(sItem(item.left, split));
+				spanItems(split + 1, item.right)[0].type = R2L;
+				stack.push(sItem(split + 1, item.right));
+				break;
+			case L2R:
+				if (IS_EMPTY(split)) {
+					item.type = L2R_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
+					stack.push(span);
+					break;
+				}
+				if (item.left == item.right) {
+					break;
+				}
+
+				spanItems(item.left, split)[0].type = L2R_SOLID_OUTSIDE;
+				stack.push(sItem(item.left, split));
+				spanItems(split, item.right)[0].type = L2R;
+				stack.push(sItem(split, item.right));
+				break;
+			case R2L:
+				if (IS_EMPTY(split)) {
+					item.type = R2L_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
+					stack.push(span);
+					break;
+				}
+				if (item.left == item.right) {
+					break;
+				}
+
+				spanItems(split, item.right)[0].type = R2L_SOLID_OUTSIDE;
+				stack.push(sItem(split, item.right));
+				spanItems(item.left, split)[0].type = R2L;
+				stack.push(sItem(item.left, split));
+				break;
+			case L2R_SOLID_BOTH:
+				if (item.left == item.right) {
+					break;
+				}
+				m_vecTrainECArcs.push_back(ECArc(item.left, item.right, 0));
+
+				if (split == item.left) {
+					spanItems(item.left + 1, item.right)[0].type = R2L;
+					stack.push(sItem(item.left + 1, item.right));
+				}
+				else {
+					spanItems(item.left, split)[0].type = L2R_SOLID_OUTSIDE;
+					stack.push(sItem(item.left, split));
+					spanItems(split, item.right)[0].type = JUX;
+					stack.push(sItem(split, item.right));
+				}
+				break;
+			case R2L_SOLID_BOTH:
+				if (item.left == item.right) {
+					break;
+				}
+				m_vecTrainECArcs.push_back(ECArc(item.right == m_nSentenceLength ? -1 : item.right, item.left, 0));
+
+				if (split == item.right) {
+					spanItems(item.left, item.right - 1)[0].type = L2R;
+					stack.push(sItem(item.left, item.right - 1));
+				}
+				else {
+					spanItems(split, item.right)[0].type = R2L_SOLID_OUTSIDE;
+					stack.push(sItem(split, item.right));
+					spanItems(item.left, split)[0].type = JUX;
+					stack.push(sItem(item.left, split));
+				}
+				break;
+			case L2R_EMPTY_INSIDE:
+				m_vecTrainECArcs.push_back(ECArc(item.left, item.right, 0));
+
+				spanItems(item.left, DECODE_EMPTY_POS(split))[0].type = L2R_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
+				stack.push(sItem(item.left, DECODE_EMPTY_POS(split)));
+				spanItems(DECODE_EMPTY_POS(split) + 1, item.right)[0].type = R2L;
+				stack.push(sItem(DECODE_EMPTY_POS(split) + 1, item.right));
+				break;
+			case R2L_EMPTY_INSIDE:
+				m_vecTrainECArcs.push_back(ECArc(item.right, item.left, 0));
+
+				spanItems(DECODE_EMPTY_POS(split) + 1, item.right)[0].type = R2L_EMPTY_OUTSIDE + DECODE_EMPTY_TAG(split) - 1;
+				stack.push(sItem(DECODE_EMPTY_POS(split) + 1, item.right));
+				spanItems(item.left, DECODE_EMPTY_POS(split))[0].type = L2R;
+				stack.push(sItem(item.left, DECODE_EMPTY_POS(split)));
+				break;
+			case L2R_SOLID_OUTSIDE:
+				if (item.left == item.right) {
+					break;
+				}
+
+				item.type = IS_EMPTY(split) ? L2R_EMPTY_INSIDE : L2R_SOLID_BOTH;
+				stack.push(span);
+				break;
+			case R2L_SOLID_OUTSIDE:
+				if (item.left == item.right) {
+					break;
+				}
+				if (item.right == m_nSentenceLength) {
+					m_vecTrainECArcs.push_back(ECArc(-1, item.left, 0));
+					spanItems(item.left, item.right - 1)[0].type = L2R;
+					stack.push(sItem(item.left, item.right - 1));
+					break;
+				}
+
+				item.type = IS_EMPTY(split) ? R2L_EMPTY_INSIDE : R2L_SOLID_BOTH;
+				stack.push(span);
+				break;
+			case L2R_EMPTY_OUTSIDE + 0:
+				m_vecTrainECArcs.push_back(ECArc(item.left, ENCODE_EMPTY(item.right + 1, item.type - L2R_EMPTY_OUTSIDE + 1), 0));
+				++nec;
+
+				if (item.left == item.right) {
+					break;
+				}
+
+				spanItems(item.left, split)[0].type = L2R_SOLID_OUTSIDE;
+				stack.push(sItem(item.left, split));
+				spanItems(split, item.right)[0].type = L2R;
+				stack.push(sItem(split, item.right));
+				break;
+			case R2L_EMPTY_OUTSIDE + 0:
+				m_vecTrainECArcs.push_back(ECArc(item.right, ENCODE_EMPTY(item.left, item.type - R2L_EMPTY_OUTSIDE + 1), 0));
+				++nec;
+
+				if (item.left == item.right) {
+					break;
+				}
+
+				spanItems(split, item.right)[0].type = R2L_SOLID_OUTSIDE;
+				stack.push(sItem(split, item.right));
+				spanItems(item.left, split)[0].type = R2L;
+				stack.push(sItem(item.left, split));
+				break;
+			default:
+				break;
+			}
+		}
+		return nec;
+	}
+
 	void DepParser::update(const int & nec) {
 		Arcs2BiArcs(m_vecTrainECArcs, m_vecTrainBiArcs);
 
@@ -944,9 +1476,9 @@ namespace emptyeisner2nd {
 	void DepParser::goldCheck(int nec) {
 		if (m_nRealEmpty != nec) return;
 		Arcs2BiArcs(m_vecTrainECArcs, m_vecTrainBiArcs);
-		if (m_vecCorrectECArcs.size() != m_vecTrainECArcs.size() || m_lItems[0][m_nSentenceLength][nec].states[R2L].score / GOLD_POS_SCORE != m_vecCorrectECArcs.size() + m_vecCorrectBiArcs.size()) {
+		if (m_vecCorrectECArcs.size() != m_vecTrainECArcs.size() || spanItems(0, m_nSentenceLength)[nec].states[R2L].score / GOLD_POS_SCORE != m_vecCorrectECArcs.size() + m_vecCorrectBiArcs.size()) {
 			std::cout << "gold parse len error at " << m_nTrainingRound << std::endl;
-			std::cout << "score is " << m_lItems[0][m_nSentenceLength][nec].states[R2L].score << std::endl;
+			std::cout << "score is " << spanItems(0, m_nSentenceLength)[nec].states[R2L].score << std::endl;
 			std::cout << "len is " << m_vecTrainECArcs.size() << std::endl;
 			++m_nTotalErrors;
 		}
@@ -6,37 +6,59 @@
 
 #include "emptyeisner2nd_state.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/empty_words.h"
 #include "common/parser/graph_dp/features/weightec2nd.h"
 
 namespace emptyeisner2nd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
 
 		Weightec2nd *m_pWeight;
 
-		StateItem m_lItems[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE][MAX_EMPTY_COUNT];
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE][MAX_EMPTYTAG_SIZE];
 		WordPOSTag m_lSentenceWithEmpty[MAX_SENTENCE_SIZE];
 		std::vector<ECArc> m_vecCorrectECArcs;
 		std::vector<ECBiArc> m_vecCorrectBiArcs;
 		std::vector<ECArc> m_vecTrainECArcs;
 		std::vector<ECBiArc> m_vecTrainBiArcs;
-		std::vector<int> m_vecCorrectEmpty;
 		int m_nSentenceLength;
 		int m_nMaxEmpty;
 		int m_nRealEmpty;
 		int m_nSentenceCount;
-
-		tscore m_lArcScore[MAX_SENTENCE_SIZE][2][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT];
-		tscore m_lBiSiblingScore[MAX_SENTENCE_SIZE][2][MAX_SENTENCE_SIZE][MAX_EMPTY_SIZE + 1][MAX_EMPTY_SIZE + 1][MAX_EMPTY_COUNT];
+		EmptyWords m_cEmptyWords;
+
+		bool m_bRelaxed;
+		tscore m_nEmptyPenalty;
+		std::vector<tscore> m_vecRelaxedScores;
+
+		// chart and arc scores sized by initChart() for the current sentence,
+		// the innermost dimension is nec and holds m_nMaxEmpty + 1 entries
+		// spans are stored as an upper triangle, bi-sibling scores only for
+		// the distance being decoded
+		int m_nEmptyStride;
+		int m_nDistance;
+		std::vector<StateItem> m_vecItems;
+		std::vector<tscore> m_vecArcScores;
+		std::vector<tscore> m_vecBiSiblingScores;
 
 		std::unordered_set<ECArc> m_setArcGoldScore;
 		std::unordered_set<ECBiArc> m_setBiSiblingArcGoldScore;
 
+		void initChart();
+		StateItem * spanItems(const int & l, const int & r) {
+			return &m_vecItems[(l * (m_nSentenceLength + 1) - l * (l - 1) / 2 + r - l) * m_nEmptyStride];
+		}
+		tscore * arcScores(const int & i, const int & dir, const int & ec) {
+			return &m_vecArcScores[((i * 2 + dir) * (MAX_EMPTY_SIZE + 1) + ec) * m_nEmptyStride];
+		}
+		tscore * biSiblingScores(const int & i, const int & dir, const int & k, const int & mid_ec, const int & out_ec) {
+			return &m_vecBiSiblingScores[((((i * 2 + dir) * m_nDistance + k - i) * (MAX_EMPTY_SIZE + 1) + mid_ec) * (MAX_EMPTY_SIZE + 1) + out_ec) * m_nEmptyStride];
+		}
+
 		void update(const int & nec);
 		void generate(DependencyTree * retval, const DependencyTree & correct);
 		void goldCheck(int nec);
@@ -48,16 +70,31 @@ namespace emptyeisner2nd {
 		tscore baseArcScore(const int & p, const int & c, const int & nec);
 		tscore biSiblingArcScore(const int & p, const int & c, const int & c2, const int & nec);
 		void initArcScore(const int & d);
-		void initBiSiblingArcScore(const int & d);
+		void initBiSiblingArcScore(const int & d, const int & nMaxEmpty);
 
 		tscore getOrUpdateInnerEmptyScore(const int & p, const int & c, const int & amount);
 		tscore getOrUpdateBaseArcScore(const int & p, const int & c, const int & amount);
 		tscore getOrUpdateBiSiblingScore(const int & p, const int & c, const int & c2, const int & nec, const int & amount);
 
+		void relax();
+		int decodeRelaxed(const tscore & penalty);
+		void cacheRelaxedScore(const int & d, const bool & bSave, std::size_t & index);
+		template<typename ARC_FUNC, typename BI_SIBLING_FUNC>
+		void forEachRelaxedScore(const int & d, ARC_FUNC arc, BI_SIBLING_FUNC biSibling);
+		tscore relaxedBiSiblingScore(const int & i, const int & dir, const int & k, const int & mid_ec, const int & out_ec, const int & nec);
+		void decodeRelaxedSpan(int distance, int left, int right);
+		int decodeRelaxedArcs();
+		// scores are only kept for up to m_nMaxEmpty empty nodes under an arc
+		int relaxedEmpty(const int & nec) const { return nec < m_nMaxEmpty ? nec : m_nMaxEmpty; }
+
 	public:
-		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
+		// bRelaxed parses without the empty count dimension, empty nodes pay a
+		// penalty instead, see relax()
+		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const bool & bRelaxed = false);
 		~DepParser();
 
+		void setRelaxed(const bool & bRelaxed) { m_bRelaxed = bRelaxed; }
+
 		void decode();
 		void decodeArcs(int nec);
 		void decodeSpan(int distance, int left, int right);
@@ -71,6 +108,11 @@ namespace emptyeisner2nd {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
 	};
 }
 
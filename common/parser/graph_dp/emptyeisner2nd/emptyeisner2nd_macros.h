@@ -1,6 +1,8 @@
 #ifndef _EMPTY_EISNER2ND_MACROS_H
 #define _EMPTY_EISNER2ND_MACROS_H
 
+#include <climits>
+
 #include "common/parser/agenda.h"
 #include "common/parser/macros_base.h"
 #include "include/learning/perceptron/packed_score.h"
@@ -13,6 +15,10 @@ namespace emptyeisner2nd {
 
 #define MAX_ACTION_SIZE (9 + (MAX_EMPTY_SIZE << 1))
 
+#define MAX_RELAX_ITERATION	8
+// bi-sibling scores the relaxed decoder hasn't needed yet
+#define RELAXED_UNSCORED	LLONG_MIN
+
 #define EMPTYTAG			"EMCAT"
 
 #define GOLD_POS_SCORE 10
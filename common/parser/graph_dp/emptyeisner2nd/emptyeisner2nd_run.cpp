@@ -7,9 +7,12 @@
 #include "common/token/emp.h"
 #include "emptyeisner2nd_run.h"
 #include "emptyeisner2nd_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
+#include "common/parser/benchmark.h"
 
 namespace emptyeisner2nd {
-	Run::Run() = default;
+	Run::Run(const bool & bRelaxed) : m_bRelaxed(bRelaxed) {}
 
 	Run::~Run() = default;
 
@@ -22,7 +25,7 @@ namespace emptyeisner2nd {
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> ref_sent) {
 				for (const auto & token : ref_sent) {
@@ -51,23 +54,57 @@ namespace emptyeisner2nd {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		DependencyTree ref_sent;
+		std::vector<DependencyTree> corpus;
+
+		// empty nodes grow the vocabulary while training, workers can't share it
+		if (nThreads > 1 || nMixStep > 0) {
+			std::cout << "parameter mixing is not supported by this decoder, train with one thread." << std::endl;
+			return;
+		}
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN));
+		CorpusReader input(sInputFile);
+		if (input) {
+			while (input >> ref_sent) {
+				for (const auto & token : ref_sent) {
+					if (TREENODE_POSTAG(token) == EMPTYTAG) {
+						TEmptyTag::getTokenizer().add(TREENODE_WORD(token));
+					}
+				}
+				corpus.push_back(ref_sent);
+			}
+			std::cout << "empty tag complete" << std::endl << TEmptyTag::getTokenizer() << std::endl;
+			trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		return std::unique_ptr<SentenceParser>(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_bRelaxed)));
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
 
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_bRelaxed));
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -87,7 +124,7 @@ namespace emptyeisner2nd {
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> ref_sent) {
 				for (const auto & token : ref_sent) {
@@ -117,4 +154,32 @@ namespace emptyeisner2nd {
 
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
+
+	// parse the gold trees with the exhaustive and the relaxed decoder, report
+	// the attachment score of the words, empty node f1 and the decoding time,
+	// then how the relaxed trees score against the exhaustive ones
+	void Run::benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & /*vecOptions*/) {
+		std::vector<DependencyTree> corrects, sentences, necs;
+		loadGoldTrees(sInputFile, corrects);
+		removeEmptyNodes(corrects, sentences);
+
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE));
+		EmptyScores agreement;
+		std::cout << "decoder\tUAS\tempty P\tempty R\tempty F\ttime(s)" << std::endl;
+		for (const auto & relaxed : { false, true }) {
+			parser->setRelaxed(relaxed);
+			EmptyScores scores;
+			double seconds = timeParse(parser.get(), sentences, [&](const int & index, const DependencyTree & tree) {
+				scores.add(corrects[index], tree);
+				if (relaxed) {
+					agreement.add(necs[index], tree);
+				}
+				else {
+					necs.push_back(tree);
+				}
+			});
+			std::cout << (relaxed ? "relaxed" : "nec") << "\t" << scores.uas() << "\t" << scores.precision() << "\t" << scores.recall() << "\t" << scores.f() << "\t" << seconds << std::endl;
+		}
+		std::cout << "relaxed/nec\t" << agreement.uas() << "\t" << agreement.precision() << "\t" << agreement.recall() << "\t" << agreement.f() << "\t-" << std::endl;
+	}
 }
@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
@@ -7,33 +6,44 @@
 #include "common/token/pos.h"
 #include "common/token/emp.h"
 #include "emptyeisner3rd_depparser.h"
+#include "common/parser/fixed_stack.h"
 
 namespace emptyeisner3rd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
-	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const int & nBeamSize, const bool & bCubePruning) :
+		DepParserBase(nState), m_cEmptyWords(nState != ParserState::PARSE), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
+		m_dEmptyThreshold = EMPTY_DETECTOR_THRESHOLD;
 
 		m_pWeight = new Weight(sFeatureInput, sFeatureOut);
 
+		setBeamSize(nBeamSize, bCubePruning);
+
 		for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
 			m_lItems[1][i].init(i, i);
 		}
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		m_cEmptyWords.reserve();
 	}
 
 	DepParser::~DepParser() {
 		delete m_pWeight;
 	}
 
+	void DepParser::setBeamSize(const int & nBeamSize, const bool & bCubePruning) {
+		m_nBeamSize = nBeamSize;
+		m_bCubePruning = bCubePruning;
+		for (int d = 0; d < MAX_SENTENCE_SIZE; ++d) {
+			for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
+				m_lItems[d][i].setBeamSize(m_nBeamSize);
+			}
+		}
+	}
+
 	void DepParser::preTrainEmpty(const DependencyTree & correct, const int & round, const int & step) {
 		// initialize
 		m_vecCorrectArcs.clear();
@@ -107,11 +117,10 @@ namespace emptyeisner3rd {
 			m_lSentence[idx][0].refer(TWord::code(SENT_WORD(token)), TPOSTag::code(SENT_POSTAG(token)));
 			for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 				m_lSentence[idx][i].refer(
-					TWord::code(
-					(idx == 0 ? START_WORD : TWord::key(m_lSentence[idx - 1][0].first())) +
-					TEmptyTag::key(i) + SENT_WORD(token)
-					),
-					TPOSTag::code(TEmptyTag::key(i))
+					m_cEmptyWords.word(i, idx == 0 ? 0 : m_lSentence[idx - 1][0].first(), m_lSentence[idx][0].first(), [&]() {
+						return (idx == 0 ? START_WORD : TWord::key(m_lSentence[idx - 1][0].first())) + TEmptyTag::key(i) + SENT_WORD(token);
+					}),
+					m_cEmptyWords.postag(i)
 					);
 			}
 			correct.push_back(DependencyTreeNode(token, -1, NULL_LABEL));
@@ -120,20 +129,32 @@ namespace emptyeisner3rd {
 		m_lSentence[idx][0].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 		for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 			m_lSentence[idx][i].refer(
-				TWord::code(
-				TWord::key(m_lSentence[idx - 1][0].first()) + TEmptyTag::key(i) + END_WORD
-				),
-				TPOSTag::code(TEmptyTag::key(i))
+				m_cEmptyWords.word(i, m_lSentence[idx - 1][0].first(), 0, [&]() {
+					return TWord::key(m_lSentence[idx - 1][0].first()) + TEmptyTag::key(i) + END_WORD;
+				}),
+				m_cEmptyWords.postag(i)
 				);
 		}
+		if (m_pEmptyDetector) {
+			m_pEmptyDetector->gate(sentence, m_dEmptyThreshold, m_vecOpenEmpty);
+		}
+		m_cEmptyBeams.begin(sentence, m_vecOpenEmpty.empty());
 		work(retval, correct);
+		m_cEmptyBeams.end();
 	}
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -152,6 +173,9 @@ namespace emptyeisner3rd {
 
 	void DepParser::decode() {
 		for (int d = 1; d <= m_nSentenceLength + 1; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 			initFirstOrderScore(d);
 			if (d > 1) {
 				initSecondOrderScore(d);
@@ -164,6 +188,12 @@ namespace emptyeisner3rd {
 
 				// initialize
 				item.init(i, l);
+				m_vecL2REmptyInsideRows.clear();
+				m_vecR2LEmptyInsideRows.clear();
+				m_vecL2RSolidBothRows.clear();
+				m_vecR2LSolidBothRows.clear();
+				m_vecL2REmptyOutsideRows.clear();
+				m_vecR2LEmptyOutsideRows.clear();
 
 				for (int s = i; s < l; ++s) {
 					const StateItem & litem = m_lItems[s - i + 1][i];
@@ -172,7 +202,10 @@ namespace emptyeisner3rd {
 					item.updateJUX(s, litem.l2r.getScore() + ritem.r2l.getScore());
 					// l2r_empty_inside
 					tscore l_empty_inside_base_score = l2r_arc_score + ritem.r2l.getScore();
-					for (const auto & l_beam : litem.l2r_empty_outside) {
+					if (m_bCubePruning) {
+						m_vecL2REmptyInsideRows.push_back(ScoreRow(s, 0, l_empty_inside_base_score, &litem.l2r_empty_outside));
+					}
+					else for (const auto & l_beam : litem.l2r_empty_outside) {
 						int p = ENCODE_EMPTY(s, DECODE_EMPTY_TAG(l_beam->getSplit()));
 						int k = ENCODE_EMPTY(s + 1, DECODE_EMPTY_TAG(l_beam->getSplit()));
 						int j = DECODE_EMPTY_POS(l_beam->getSplit());
@@ -183,7 +216,10 @@ namespace emptyeisner3rd {
 					}
 					// r2l_empty_inside
 					tscore r_empty_inside_base_score = r2l_arc_score + litem.l2r.getScore();
-					for (const auto & r_beam : ritem.r2l_empty_outside) {
+					if (m_bCubePruning) {
+						m_vecR2LEmptyInsideRows.push_back(ScoreRow(s, 0, r_empty_inside_base_score, &ritem.r2l_empty_outside));
+					}
+					else for (const auto & r_beam : ritem.r2l_empty_outside) {
 						int p = ENCODE_EMPTY(s, DECODE_EMPTY_TAG(r_beam->getSplit()));
 						int k = ENCODE_EMPTY(s + 1, DECODE_EMPTY_TAG(r_beam->getSplit()));
 						int j = DECODE_EMPTY_POS(r_beam->getSplit());
@@ -202,7 +238,10 @@ namespace emptyeisner3rd {
 
 					// l2r_solid_both
 					tscore l_solid_both_base_score = ritem.jux.getScore() + l2r_arc_score + m_lSecondOrderScore[ENCODE_2ND_L2R(i, k)];
-					for (const auto & swbs : l_beam) {
+					if (m_bCubePruning) {
+						m_vecL2RSolidBothRows.push_back(SolidOutsideRow(k, 0, l_solid_both_base_score, &l_beam));
+					}
+					else for (const auto & swbs : l_beam) {
 						// j is inner split
 						const int & j = swbs->getSplit();
 						item.updateL2RSolidBoth(k, j, l_solid_both_base_score +
@@ -217,7 +256,10 @@ namespace emptyeisner3rd {
 						// o is outside empty
 						int o = ENCODE_EMPTY(l + 1, t);
 						tscore l_empty_outside_base_score = ritem.l2r.getScore() + swt->getScore() + twoArcScore(i, k, o);
-						for (const auto & swbs : l_beam) {
+						if (m_bCubePruning) {
+							m_vecL2REmptyOutsideRows.push_back(SolidOutsideRow(k, t, l_empty_outside_base_score, &l_beam));
+						}
+						else for (const auto & swbs : l_beam) {
 							// j is inner split
 							const int & j = swbs->getSplit();
 							item.updateL2REmptyOutside(s, j, l_empty_outside_base_score +
@@ -229,7 +271,10 @@ namespace emptyeisner3rd {
 					item.updateL2R(k, litem.l2r_solid_outside.bestItem().getScore() + ritem.l2r.getScore());
 					// r2l_solid_both
 					tscore r_solid_both_base_score = litem.jux.getScore() + r2l_arc_score + m_lSecondOrderScore[ENCODE_2ND_R2L(i, k)];
-					for (const auto & swbs : r_beam) {
+					if (m_bCubePruning) {
+						m_vecR2LSolidBothRows.push_back(SolidOutsideRow(k, 0, r_solid_both_base_score, &r_beam));
+					}
+					else for (const auto & swbs : r_beam) {
 						const int & j = swbs->getSplit();
 						item.updateR2LSolidBoth(k, j, r_solid_both_base_score +
 							swbs->getScore() +
@@ -241,7 +286,10 @@ namespace emptyeisner3rd {
 						int s = ENCODE_EMPTY(k, t);
 						int o = ENCODE_EMPTY(i, t);
 						tscore r_empty_outside_base_score = litem.r2l.getScore() + swt->getScore() + twoArcScore(l, k, o);
-						for (const auto & swbs : r_beam) {
+						if (m_bCubePruning) {
+							m_vecR2LEmptyOutsideRows.push_back(SolidOutsideRow(k, t, r_empty_outside_base_score, &r_beam));
+						}
+						else for (const auto & swbs : r_beam) {
 							const int & j = swbs->getSplit();
 							item.updateR2LEmptyOutside(s, j, r_empty_outside_base_score +
 								swbs->getScore() +
@@ -251,6 +299,10 @@ namespace emptyeisner3rd {
 					// r2l
 					item.updateR2L(k, ritem.r2l_solid_outside.bestItem().getScore() + litem.r2l.getScore());
 				}
+				if (m_bCubePruning) {
+					combineEmptyInside(i, l);
+					combineSolidBoth(i, l);
+				}
 				if (d > 1) {
 					// l2r_solid_both
 					item.updateL2RSolidBoth(i, i, m_lItems[d - 1][i + 1].r2l.getScore() +
@@ -284,7 +336,10 @@ namespace emptyeisner3rd {
 					int o = ENCODE_EMPTY(l + 1, t);
 					if (d > 1) {
 						tscore base_l2r_empty_outside_score = swt->getScore() + twoArcScore(i, l, o) + m_lItems[1][l].l2r.getScore();
-						for (const auto & swbs : item.l2r_solid_outside) {
+						if (m_bCubePruning) {
+							m_vecL2REmptyOutsideRows.push_back(SolidOutsideRow(l, t, base_l2r_empty_outside_score, &item.l2r_solid_outside));
+						}
+						else for (const auto & swbs : item.l2r_solid_outside) {
 							const int & j = swbs->getSplit();
 							item.updateL2REmptyOutside(s, swbs->getSplit(), base_l2r_empty_outside_score +
 								swbs->getScore() +
@@ -304,7 +359,10 @@ namespace emptyeisner3rd {
 					int o = ENCODE_EMPTY(i, t);
 					if (d > 1) {
 						tscore base_r2l_empty_outside_score = swt->getScore() + twoArcScore(l, i, o) + m_lItems[1][i].r2l.getScore();
-						for (const auto & swbs : item.r2l_solid_outside) {
+						if (m_bCubePruning) {
+							m_vecR2LEmptyOutsideRows.push_back(SolidOutsideRow(i, t, base_r2l_empty_outside_score, &item.r2l_solid_outside));
+						}
+						else for (const auto & swbs : item.r2l_solid_outside) {
 							const int & j = swbs->getSplit();
 							item.updateR2LEmptyOutside(s, swbs->getSplit(), base_r2l_empty_outside_score +
 								swbs->getScore() +
@@ -318,6 +376,9 @@ namespace emptyeisner3rd {
 					}
 
 				}
+				if (m_bCubePruning) {
+					combineEmptyOutside(i, l);
+				}
 				// l2r
 				item.updateL2R(l, item.l2r_solid_outside.bestItem().getScore() + m_lItems[1][l].l2r.getScore());
 				if (item.l2r_empty_outside.size() > 0) {
@@ -349,9 +410,65 @@ namespace emptyeisner3rd {
 		}
 	}
 
+	void DepParser::combineEmptyInside(const int & i, const int & l) {
+		StateItem & item = m_lItems[l - i + 1][i];
+		cubePrune(m_vecL2REmptyInsideRows, m_nBeamSize, [&](const ScoreRow & row, const int & index) -> tscore {
+			const auto & l_beam = (*row.beam)[index];
+			int k = ENCODE_EMPTY(row.split + 1, DECODE_EMPTY_TAG(l_beam.getSplit()));
+			int j = DECODE_EMPTY_POS(l_beam.getSplit());
+			return row.base + l_beam.getScore() + twoArcScore(i, k, l) + triArcScore(i, j == i ? -1 : j, k, l);
+		}, [&item](const ScoreRow & row, const int & index, const tscore & score) {
+			const auto & l_beam = (*row.beam)[index];
+			item.updateL2REmptyInside(ENCODE_EMPTY(row.split, DECODE_EMPTY_TAG(l_beam.getSplit())), l_beam.getSplit(), score);
+		});
+		cubePrune(m_vecR2LEmptyInsideRows, m_nBeamSize, [&](const ScoreRow & row, const int & index) -> tscore {
+			const auto & r_beam = (*row.beam)[index];
+			int k = ENCODE_EMPTY(row.split + 1, DECODE_EMPTY_TAG(r_beam.getSplit()));
+			int j = DECODE_EMPTY_POS(r_beam.getSplit());
+			return row.base + r_beam.getScore() + twoArcScore(l, k, i) + triArcScore(l, j == l ? -1 : j, k, i);
+		}, [&item](const ScoreRow & row, const int & index, const tscore & score) {
+			const auto & r_beam = (*row.beam)[index];
+			item.updateR2LEmptyInside(ENCODE_EMPTY(row.split, DECODE_EMPTY_TAG(r_beam.getSplit())), r_beam.getSplit(), score);
+		});
+	}
+
+	void DepParser::combineSolidBoth(const int & i, const int & l) {
+		StateItem & item = m_lItems[l - i + 1][i];
+		cubePrune(m_vecL2RSolidBothRows, m_nBeamSize, [&](const SolidOutsideRow & row, const int & index) -> tscore {
+			const int & j = (*row.beam)[index].getSplit();
+			return row.base + (*row.beam)[index].getScore() + triArcScore(i, j == i ? -1 : IS_EMPTY(j) ? j + 1 : j, row.split, l);
+		}, [&item](const SolidOutsideRow & row, const int & index, const tscore & score) {
+			item.updateL2RSolidBoth(row.split, (*row.beam)[index].getSplit(), score);
+		});
+		cubePrune(m_vecR2LSolidBothRows, m_nBeamSize, [&](const SolidOutsideRow & row, const int & index) -> tscore {
+			const int & j = (*row.beam)[index].getSplit();
+			return row.base + (*row.beam)[index].getScore() + triArcScore(l, j == l ? -1 : IS_EMPTY(j) ? j + 1 : j, row.split, i);
+		}, [&item](const SolidOutsideRow & row, const int & index, const tscore & score) {
+			item.updateR2LSolidBoth(row.split, (*row.beam)[index].getSplit(), score);
+		});
+	}
+
+	// rows are split k with empty type t, the outside empty node goes after l for l2r
+	// and before i for r2l
+	void DepParser::combineEmptyOutside(const int & i, const int & l) {
+		StateItem & item = m_lItems[l - i + 1][i];
+		cubePrune(m_vecL2REmptyOutsideRows, m_nBeamSize, [&](const SolidOutsideRow & row, const int & index) -> tscore {
+			const int & j = (*row.beam)[index].getSplit();
+			return row.base + (*row.beam)[index].getScore() + triArcScore(i, j == i ? -1 : IS_EMPTY(j) ? j + 1 : j, row.split, ENCODE_EMPTY(l + 1, row.type));
+		}, [&item](const SolidOutsideRow & row, const int & index, const tscore & score) {
+			item.updateL2REmptyOutside(ENCODE_EMPTY(row.split, row.type), (*row.beam)[index].getSplit(), score);
+		});
+		cubePrune(m_vecR2LEmptyOutsideRows, m_nBeamSize, [&](const SolidOutsideRow & row, const int & index) -> tscore {
+			const int & j = (*row.beam)[index].getSplit();
+			return row.base + (*row.beam)[index].getScore() + triArcScore(l, j == l ? -1 : IS_EMPTY(j) ? j + 1 : j, row.split, ENCODE_EMPTY(i, row.type));
+		}, [&item](const SolidOutsideRow & row, const int & index, const tscore & score) {
+			item.updateR2LEmptyOutside(ENCODE_EMPTY(row.split, row.type), (*row.beam)[index].getSplit(), score);
+		});
+	}
+
 	void DepParser::decodeArcs() {
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int>> stack;
 		stack.push(std::tuple<int, int, int>(m_nSentenceLength + 1, -1, 0));
 		m_lItems[m_nSentenceLength + 1][0].type = R2L;
 
@@ -697,6 +814,9 @@ namespace emptyeisner3rd {
 				m_lFirstOrderScore[ENCODE_L2R(i)] = arcScore(i, i + d - 1);
 				m_lFirstOrderScore[ENCODE_R2L(i)] = arcScore(i + d - 1, i);
 			}
+			if (m_cEmptyBeams.cached() && m_cEmptyBeams.read(m_abFirstOrderEmptyScore[ENCODE_L2R(i)]) && m_cEmptyBeams.read(m_abFirstOrderEmptyScore[ENCODE_R2L(i)])) {
+				continue;
+			}
 			m_abFirstOrderEmptyScore[ENCODE_L2R(i)].clear();
 			m_abFirstOrderEmptyScore[ENCODE_R2L(i)].clear();
 
@@ -712,6 +832,8 @@ namespace emptyeisner3rd {
 			}
 			m_abFirstOrderEmptyScore[ENCODE_L2R(i)].sortItems();
 			m_abFirstOrderEmptyScore[ENCODE_R2L(i)].sortItems();
+			m_cEmptyBeams.write(m_abFirstOrderEmptyScore[ENCODE_L2R(i)]);
+			m_cEmptyBeams.write(m_abFirstOrderEmptyScore[ENCODE_R2L(i)]);
 		}
 		int i = m_nSentenceLength - d + 1;
 		m_lFirstOrderScore[ENCODE_R2L(i)] = arcScore(m_nSentenceLength, i);
@@ -746,11 +868,10 @@ namespace emptyeisner3rd {
 				m_lSentence[m_nSentenceLength][0].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 				for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 					m_lSentence[m_nSentenceLength][i].refer(
-						TWord::code(
-						(m_nSentenceLength == 0 ? START_WORD : TWord::key(m_lSentence[m_nSentenceLength - 1][0].first())) +
-						TEmptyTag::key(i) + TREENODE_WORD(node)
-						),
-						TPOSTag::code(TEmptyTag::key(i))
+						m_cEmptyWords.word(i, m_nSentenceLength == 0 ? 0 : m_lSentence[m_nSentenceLength - 1][0].first(), m_lSentence[m_nSentenceLength][0].first(), [&]() {
+							return (m_nSentenceLength == 0 ? START_WORD : TWord::key(m_lSentence[m_nSentenceLength - 1][0].first())) + TEmptyTag::key(i) + TREENODE_WORD(node);
+						}),
+						m_cEmptyWords.postag(i)
 						);
 				}
 				++m_nSentenceLength;
@@ -759,10 +880,10 @@ namespace emptyeisner3rd {
 		m_lSentence[m_nSentenceLength][0].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 		for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 			m_lSentence[m_nSentenceLength][i].refer(
-				TWord::code(
-				TWord::key(m_lSentence[m_nSentenceLength - 1][0].first()) + TEmptyTag::key(i) + END_WORD
-				),
-				TPOSTag::code(TEmptyTag::key(i))
+				m_cEmptyWords.word(i, m_lSentence[m_nSentenceLength - 1][0].first(), 0, [&]() {
+					return TWord::key(m_lSentence[m_nSentenceLength - 1][0].first()) + TEmptyTag::key(i) + END_WORD;
+				}),
+				m_cEmptyWords.postag(i)
 				);
 		}
 		int idx = 0, idxwe = 0;
@@ -792,6 +913,10 @@ namespace emptyeisner3rd {
 		int pos_c = DECODE_EMPTY_POS(c);
 		int tag_c = DECODE_EMPTY_TAG(c);
 
+		if (!m_vecOpenEmpty.empty() && !m_vecOpenEmpty[pos_c * MAX_EMPTYTAG_SIZE + tag_c]) {
+			return false;
+		}
+
 		p_tag = m_lSentence[p][0].second();
 
 		c_tag = m_lSentence[pos_c][tag_c].second();
@@ -1,23 +1,36 @@
 #ifndef _EMPTY_EISNER_DEPPARSER_H
 #define _EMPTY_EISNER_DEPPARSER_H
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
 #include "emptyeisner3rd_state.h"
 #include "emptyeisner3rd_weight.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
+#include "common/parser/empty_beams.h"
+#include "common/parser/empty_words.h"
+#include "common/parser/empty_detector.h"
 
 namespace emptyeisner3rd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
 
 		Weight *m_pWeight;
 
+		int m_nBeamSize;
+		bool m_bCubePruning;
+		std::vector<ScoreRow> m_vecL2REmptyInsideRows, m_vecR2LEmptyInsideRows;
+		std::vector<SolidOutsideRow> m_vecL2RSolidBothRows, m_vecR2LSolidBothRows;
+		std::vector<SolidOutsideRow> m_vecL2REmptyOutsideRows, m_vecR2LEmptyOutsideRows;
+
 		StateItem m_lItems[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
 		WordPOSTag m_lSentence[MAX_SENTENCE_SIZE][MAX_EMPTYTAG_SIZE];
 		WordPOSTag m_lSentenceWithEmpty[MAX_SENTENCE_SIZE];
@@ -27,6 +40,14 @@ namespace emptyeisner3rd {
 		std::vector<TriArc> m_vecTrainTriArcs;
 
 		int m_nSentenceLength;
+		EmptyWords m_cEmptyWords;
+		FallbackEngine<DepParser> m_cFallback;
+
+		std::shared_ptr<const EmptyDetector> m_pEmptyDetector;
+		double m_dEmptyThreshold;
+		// slots the detector left open for the sentence being parsed
+		std::vector<bool> m_vecOpenEmpty;
+		EmptyBeams m_cEmptyBeams;
 
 		tscore m_nRetval;
 		tscore m_lFirstOrderScore[MAX_SENTENCE_SIZE << 1];
@@ -71,6 +92,10 @@ namespace emptyeisner3rd {
 		void initFirstOrderScore(const int & d);
 		void initSecondOrderScore(const int & d);
 
+		void combineEmptyInside(const int & i, const int & l);
+		void combineSolidBoth(const int & i, const int & l);
+		void combineEmptyOutside(const int & i, const int & l);
+
 		bool testEmptyNode(const int & p, const int & c);
 		void getOrUpdateStackScore(const int & p, const int & c, const int & amount);
 		void getOrUpdateStackScore(const int & p, const int & c, const int & c2, const int & amount);
@@ -78,9 +103,24 @@ namespace emptyeisner3rd {
 
 
 	public:
-		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
+		// nBeamSize items are kept per span, bCubePruning pops only nBeamSize
+		// candidates per span instead of scoring every beam item
+		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState, const int & nBeamSize = AGENDA_SIZE, const bool & bCubePruning = false);
 		~DepParser();
 
+		// empty nodes are only tried at (gap, category) slots the detector gives
+		// at least dThreshold, nullptr tries every slot
+		void setEmptyDetector(const std::shared_ptr<const EmptyDetector> & pDetector, const double & dThreshold) {
+			m_pEmptyDetector = pDetector;
+			m_dEmptyThreshold = dThreshold;
+			m_vecOpenEmpty.clear();
+		}
+
+		// first-order empty beams of parsed sentences are kept in pCache
+		void setEmptyCache(const std::shared_ptr<ScoreCache> & pCache) { m_cEmptyBeams.setCache(pCache); }
+
+		void setBeamSize(const int & nBeamSize, const bool & bCubePruning);
+
 		void decode();
 		void decodeArcs();
 
@@ -95,6 +135,11 @@ namespace emptyeisner3rd {
 			m_pWeight->saveScores();
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
+
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
 	};
 }
 
@@ -3,6 +3,7 @@
 
 #include <utility>
 
+#include "common/parser/cube.h"
 #include "common/parser/agenda.h"
 #include "common/parser/macros_base.h"
 #include "include/learning/perceptron/packed_score.h"
@@ -13,7 +14,9 @@ namespace emptyeisner3rd {
 #define GOLD_POS_SCORE 10
 #define GOLD_NEG_SCORE -50
 
+// default and largest beam width, beams allocate room for the width in use
 #define AGENDA_SIZE		4
+#define MAX_AGENDA_SIZE	32
 #define MAX_EMPTY_SIZE	17
 
 #define EMPTYTAG			"EMCAT"
@@ -54,8 +57,10 @@ namespace emptyeisner3rd {
 	typedef BiGram<int> Arc;
 	typedef QuarGram<int> TriArc;
 
-	typedef AgendaBeam<ScoreWithBiSplit, AGENDA_SIZE> ScoreAgenda;
-	typedef AgendaBeam<ScoreWithBiSplit, AGENDA_SIZE << 1> SolidOutsideAgenda;
+	typedef AgendaBeam<ScoreWithBiSplit, 0> ScoreAgenda;
+	typedef AgendaBeam<ScoreWithBiSplit, 0> SolidOutsideAgenda;
+	typedef BeamRow<ScoreAgenda> ScoreRow;
+	typedef BeamRow<SolidOutsideAgenda> SolidOutsideRow;
 
 	bool testTree(const std::vector<Arc> & arcs);
 	bool testEmptyTree(const std::vector<Arc> & arcs, const int & len);
@@ -6,9 +6,18 @@
 
 #include "emptyeisner3rd_run.h"
 #include "emptyeisner3rd_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
+#include "common/parser/benchmark.h"
 
 namespace emptyeisner3rd {
-	Run::Run() = default;
+	Run::Run(const int & nBeamSize, const bool & bCubePruning, const std::string & sEmptyDetector, const double & dEmptyThreshold, const std::string & sEmptyCache) :
+		m_nBeamSize(nBeamSize < 0 ? AGENDA_SIZE : nBeamSize), m_bCubePruning(bCubePruning), m_sEmptyDetector(sEmptyDetector), m_dEmptyThreshold(dEmptyThreshold), m_sEmptyCache(sEmptyCache) {
+		if (m_nBeamSize < 1 || m_nBeamSize > MAX_AGENDA_SIZE) {
+			std::cout << "beam width " << m_nBeamSize << " is not in 1.." << MAX_AGENDA_SIZE << ", " << AGENDA_SIZE << " is used." << std::endl;
+			m_nBeamSize = AGENDA_SIZE;
+		}
+	}
 
 	Run::~Run() = default;
 
@@ -20,9 +29,9 @@ namespace emptyeisner3rd {
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN, m_nBeamSize, m_bCubePruning));
 
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> ref_sent) {
 				++nRound;
@@ -42,23 +51,59 @@ namespace emptyeisner3rd {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		DependencyTree ref_sent;
+		std::vector<DependencyTree> corpus;
+
+		// empty nodes grow the vocabulary while training, workers can't share it
+		if (nThreads > 1 || nMixStep > 0) {
+			std::cout << "parameter mixing is not supported by this decoder, train with one thread." << std::endl;
+			return;
+		}
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN, m_nBeamSize, m_bCubePruning));
+		CorpusReader input(sInputFile);
+		if (input) {
+			while (input >> ref_sent) {
+				corpus.push_back(ref_sent);
+			}
+			trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		std::unique_ptr<LoadedParser<DepParser>> loaded(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE, m_nBeamSize, m_bCubePruning)));
+		DepParser * parser = loaded->get();
+		if (!m_sEmptyDetector.empty()) {
+			parser->setEmptyDetector(EmptyDetector::open(m_sEmptyDetector), m_dEmptyThreshold);
+		}
+		if (!m_sEmptyCache.empty()) {
+			parser->setEmptyCache(ScoreCache::open(m_sEmptyCache, EmptyBeams::fingerprint("emptyeisner3rd", sFeatureFile, MAX_EMPTY_SIZE)));
+		}
+		return loaded;
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
 
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		std::unique_ptr<SentenceParser> parser = load(sFeatureFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -81,8 +126,8 @@ namespace emptyeisner3rd {
 
 		auto time_begin = time(NULL);
 		
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST, m_nBeamSize, m_bCubePruning));
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> ref_sent) {
 				++nRound;
@@ -99,4 +144,26 @@ namespace emptyeisner3rd {
 
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
+
+	// speed/recall curve of the empty detector given by detector=file, the
+	// numeric options are the thresholds
+	// with cache=file it times the empty beam cache instead
+	void Run::benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) {
+		std::vector<double> vecThresholds;
+		std::vector<DependencyTree> corrects;
+		readThresholds(vecOptions, vecThresholds);
+		loadGoldTrees(sInputFile, corrects);
+
+		std::shared_ptr<const EmptyDetector> detector;
+		if (!m_sEmptyDetector.empty()) {
+			detector = EmptyDetector::open(m_sEmptyDetector);
+		}
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE, m_nBeamSize, m_bCubePruning));
+		if (!m_sEmptyCache.empty()) {
+			benchmarkEmptyCache(parser.get(), corrects, m_sEmptyCache, EmptyBeams::fingerprint("emptyeisner3rd", sFeatureInput, MAX_EMPTY_SIZE));
+		}
+		else {
+			benchmarkEmptyDetector(parser.get(), corrects, detector, vecThresholds);
+		}
+	}
 }
@@ -21,6 +21,17 @@ namespace emptyeisner3rd {
 		r2l.reset();
 	}
 
+	void StateItem::setBeamSize(const int & nBeamSize) {
+		l2r_solid_both.setLimit(nBeamSize);
+		r2l_solid_both.setLimit(nBeamSize);
+		l2r_empty_outside.setLimit(nBeamSize);
+		r2l_empty_outside.setLimit(nBeamSize);
+		l2r_empty_inside.setLimit(nBeamSize);
+		r2l_empty_inside.setLimit(nBeamSize);
+		l2r_solid_outside.setLimit(nBeamSize << 1);
+		r2l_solid_outside.setLimit(nBeamSize << 1);
+	}
+
 	void StateItem::print() {
 		std::cout << "[" << left << "," << right << "]" << std::endl;
 		std::cout << "type is: ";
@@ -36,6 +36,8 @@ namespace emptyeisner3rd {
 		~StateItem();
 
 		void init(const int & l, const int & r);
+		// solid outside beams keep twice as many items
+		void setBeamSize(const int & nBeamSize);
 
 		void updateJUX(const int & split, const tscore & score);
 		void updateL2RSolidBoth(const int & split, const int & innersplit, const tscore & score);
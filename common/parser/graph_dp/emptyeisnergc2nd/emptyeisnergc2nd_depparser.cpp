@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
@@ -7,23 +6,22 @@
 #include "common/token/word.h"
 #include "common/token/pos.h"
 #include "common/token/emp.h"
+#include "common/parser/fixed_stack.h"
 
 namespace emptyeisnergc2nd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
 	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+		DepParserBase(nState), m_cEmptyWords(nState != ParserState::PARSE), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
+		m_dEmptyThreshold = EMPTY_DETECTOR_THRESHOLD;
 
 		m_pWeight = new Weight(sFeatureInput, sFeatureOut);
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		m_cEmptyWords.reserve();
 	}
 
 	DepParser::~DepParser() {
@@ -72,11 +70,10 @@ namespace emptyeisnergc2nd {
 			m_lSentence[idx][0].refer(TWord::code(SENT_WORD(token)), TPOSTag::code(SENT_POSTAG(token)));
 			for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 				m_lSentence[idx][i].refer(
-					TWord::code(
-					(idx == 0 ? START_WORD : TWord::key(m_lSentence[idx - 1][0].first())) +
-					TEmptyTag::key(i) + SENT_WORD(token)
-					),
-					TPOSTag::code(TEmptyTag::key(i))
+					m_cEmptyWords.word(i, idx == 0 ? 0 : m_lSentence[idx - 1][0].first(), m_lSentence[idx][0].first(), [&]() {
+						return (idx == 0 ? START_WORD : TWord::key(m_lSentence[idx - 1][0].first())) + TEmptyTag::key(i) + SENT_WORD(token);
+					}),
+					m_cEmptyWords.postag(i)
 					);
 			}
 			correct.push_back(DependencyTreeNode(token, -1, NULL_LABEL));
@@ -85,20 +82,32 @@ namespace emptyeisnergc2nd {
 		m_lSentence[idx][0].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 		for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 			m_lSentence[idx][i].refer(
-				TWord::code(
-				TWord::key(m_lSentence[idx - 1][0].first()) + TEmptyTag::key(i) + END_WORD
-				),
-				TPOSTag::code(TEmptyTag::key(i))
+				m_cEmptyWords.word(i, m_lSentence[idx - 1][0].first(), 0, [&]() {
+					return TWord::key(m_lSentence[idx - 1][0].first()) + TEmptyTag::key(i) + END_WORD;
+				}),
+				m_cEmptyWords.postag(i)
 				);
 		}
+		if (m_pEmptyDetector) {
+			m_pEmptyDetector->gate(sentence, m_dEmptyThreshold, m_vecOpenEmpty);
+		}
+		m_cEmptyBeams.begin(sentence, m_vecOpenEmpty.empty());
 		work(retval, correct);
+		m_cEmptyBeams.end();
 	}
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -157,6 +166,9 @@ namespace emptyeisnergc2nd {
 		}
 
 		for (int d = 1; d <= m_nSentenceLength; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 
 			m_lItems[d].reserve(m_nSentenceLength - d + 1);
 
@@ -456,7 +468,7 @@ namespace emptyeisnergc2nd {
 	void DepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int, int>> stack;
 
 		int s = m_lItems[m_nSentenceLength + 1][0].r2l[0].getSplit();
 		m_vecTrainArcs.push_back(Arc(-1, s));
@@ -817,6 +829,11 @@ namespace emptyeisnergc2nd {
 					m_vecArcScore[i + d - 1][i] = arcScore(i + d - 1, i);
 				}
 
+				if (m_cEmptyBeams.cached() && m_cEmptyBeams.read(m_vecFirstOrderEmptyScore[i][i + d - 1]) && m_cEmptyBeams.read(m_vecFirstOrderEmptyScore[i + d - 1][i])) {
+					continue;
+				}
+				m_vecFirstOrderEmptyScore[i][i + d - 1].clear();
+				m_vecFirstOrderEmptyScore[i + d - 1][i].clear();
 				for (int t = TEmptyTag::start(), max_t = TEmptyTag::end(); t < max_t; ++t) {
 					if (m_nState == ParserState::GOLDTEST || testEmptyNode(i, ENCODE_EMPTY(i + d, t))) {
 						tscore score = arcScore(i, ENCODE_EMPTY(i + d, t));
@@ -831,6 +848,8 @@ namespace emptyeisnergc2nd {
 						}
 					}
 				}
+				m_cEmptyBeams.write(m_vecFirstOrderEmptyScore[i][i + d - 1]);
+				m_cEmptyBeams.write(m_vecFirstOrderEmptyScore[i + d - 1][i]);
 			}
 		}
 		for (int i = 0; i < m_nSentenceLength; ++i) {
@@ -1004,11 +1023,10 @@ namespace emptyeisnergc2nd {
 				m_lSentence[m_nSentenceLength][0].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 				for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 					m_lSentence[m_nSentenceLength][i].refer(
-						TWord::code(
-						(m_nSentenceLength == 0 ? START_WORD : TWord::key(m_lSentence[m_nSentenceLength - 1][0].first())) +
-						TEmptyTag::key(i) + TREENODE_WORD(node)
-						),
-						TPOSTag::code(TEmptyTag::key(i))
+						m_cEmptyWords.word(i, m_nSentenceLength == 0 ? 0 : m_lSentence[m_nSentenceLength - 1][0].first(), m_lSentence[m_nSentenceLength][0].first(), [&]() {
+							return (m_nSentenceLength == 0 ? START_WORD : TWord::key(m_lSentence[m_nSentenceLength - 1][0].first())) + TEmptyTag::key(i) + TREENODE_WORD(node);
+						}),
+						m_cEmptyWords.postag(i)
 						);
 				}
 				++m_nSentenceLength;
@@ -1017,10 +1035,10 @@ namespace emptyeisnergc2nd {
 		m_lSentence[m_nSentenceLength][0].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 		for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 			m_lSentence[m_nSentenceLength][i].refer(
-				TWord::code(
-				TWord::key(m_lSentence[m_nSentenceLength - 1][0].first()) + TEmptyTag::key(i) + END_WORD
-				),
-				TPOSTag::code(TEmptyTag::key(i))
+				m_cEmptyWords.word(i, m_lSentence[m_nSentenceLength - 1][0].first(), 0, [&]() {
+					return TWord::key(m_lSentence[m_nSentenceLength - 1][0].first()) + TEmptyTag::key(i) + END_WORD;
+				}),
+				m_cEmptyWords.postag(i)
 				);
 		}
 		int idx = 0, idxwe = 0;
@@ -1051,6 +1069,10 @@ namespace emptyeisnergc2nd {
 		int pos_c = DECODE_EMPTY_POS(c);
 		int tag_c = DECODE_EMPTY_TAG(c);
 
+		if (!m_vecOpenEmpty.empty() && !m_vecOpenEmpty[pos_c * MAX_EMPTYTAG_SIZE + tag_c]) {
+			return false;
+		}
+
 		p_tag = m_lSentence[p][0].second();
 
 		c_tag = m_lSentence[pos_c][tag_c].second();
@@ -1,20 +1,27 @@
 #ifndef _EMPTY_EISNERGC2ND_DEPPARSER_H
 #define _EMPTY_EISNERGC2ND_DEPPARSER_H
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
 #include "emptyeisnergc2nd_state.h"
 #include "emptyeisnergc2nd_weight.h"
 #include "common/parser/depparser_base.h"
+#include "common/parser/graph_dp/engine/fallback_engine.h"
+#include "common/parser/empty_beams.h"
+#include "common/parser/empty_words.h"
+#include "common/parser/empty_detector.h"
 
 namespace emptyeisnergc2nd {
 
 	class DepParser : public DepParserBase {
 	private:
-		static WordPOSTag empty_taggedword;
-		static WordPOSTag start_taggedword;
-		static WordPOSTag end_taggedword;
+		friend class EisnerEngine<ARC_FACTOR, DepParser>;
+
+		WordPOSTag empty_taggedword;
+		WordPOSTag start_taggedword;
+		WordPOSTag end_taggedword;
 
 		Weight *m_pWeight;
 
@@ -32,6 +39,14 @@ namespace emptyeisnergc2nd {
 		std::vector<Arc> m_vecTrainArcs;
 		std::vector<TriArc> m_vecTrainTriArcs;
 		int m_nSentenceLength;
+		EmptyWords m_cEmptyWords;
+		FallbackEngine<DepParser> m_cFallback;
+
+		std::shared_ptr<const EmptyDetector> m_pEmptyDetector;
+		double m_dEmptyThreshold;
+		// slots the detector left open for the sentence being parsed
+		std::vector<bool> m_vecOpenEmpty;
+		EmptyBeams m_cEmptyBeams;
 
 		tscore m_nRetval;
 		std::vector<std::vector<tscore>> m_vecArcScore;
@@ -96,6 +111,17 @@ namespace emptyeisnergc2nd {
 		DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState);
 		~DepParser();
 
+		// empty nodes are only tried at (gap, category) slots the detector gives
+		// at least dThreshold, nullptr tries every slot
+		void setEmptyDetector(const std::shared_ptr<const EmptyDetector> & pDetector, const double & dThreshold) {
+			m_pEmptyDetector = pDetector;
+			m_dEmptyThreshold = dThreshold;
+			m_vecOpenEmpty.clear();
+		}
+
+		// first-order empty beams of parsed sentences are kept in pCache
+		void setEmptyCache(const std::shared_ptr<ScoreCache> & pCache) { m_cEmptyBeams.setCache(pCache); }
+
 		void decode();
 		void decodeArcs();
 
@@ -109,6 +135,11 @@ namespace emptyeisnergc2nd {
 			std::cout << "Total number of training errors are: " << m_nTotalErrors << std::endl;
 		}
 
+		void finishtraining(const std::string & sFeatureOut) {
+			m_pWeight->referRecordPath(sFeatureOut);
+			finishtraining();
+		}
+
 		void printTime() {
 //			std::cout << "total time tick is " << GetTickCount() - m_tStartTime << std::endl;
 			std::cout << "total malloc time is " << m_tInitSpaceTime << std::endl;
@@ -2,16 +2,28 @@
 #define _EMPTY_EISNERGC2ND_RUN_H
 
 #include "common/parser/run_base.h"
+#include "common/parser/empty_detector.h"
 
 namespace emptyeisnergc2nd {
 	class Run : public RunBase {
+	private:
+		std::string m_sEmptyDetector;
+		double m_dEmptyThreshold;
+		std::string m_sEmptyCache;
+
 	public:
-		Run();
+		// sEmptyDetector is an empty detector model gating empty nodes when parsing
+		// sEmptyCache keeps the first-order empty beams of parsed sentences
+		Run(const std::string & sEmptyDetector = "", const double & dEmptyThreshold = EMPTY_DETECTOR_THRESHOLD, const std::string & sEmptyCache = "");
 		~Run();
 
 		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) override;
+		void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) override;
 		void parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) override;
+		std::unique_ptr<SentenceParser> load(const std::string & sFeatureFile) override;
+		int timeExponent() const override { return 5; }
 		void goldtest(const std::string & sInputFile, const std::string & sFeatureInput) override;
+		void benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) override;
 	};
 }
 
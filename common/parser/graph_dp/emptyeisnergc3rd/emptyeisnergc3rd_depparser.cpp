@@ -1,5 +1,4 @@
 #include <cmath>
-#include <stack>
 #include <algorithm>
 #include <unordered_set>
 
@@ -7,17 +6,15 @@
 #include "common/token/word.h"
 #include "common/token/pos.h"
 #include "common/token/emp.h"
+#include "common/parser/fixed_stack.h"
 
 namespace emptyeisnergc3rd {
 
-	WordPOSTag DepParser::empty_taggedword = WordPOSTag();
-	WordPOSTag DepParser::start_taggedword = WordPOSTag();
-	WordPOSTag DepParser::end_taggedword = WordPOSTag();
-
 	DepParser::DepParser(const std::string & sFeatureInput, const std::string & sFeatureOut, int nState) :
-		DepParserBase(nState) {
+		DepParserBase(nState), m_cEmptyWords(nState != ParserState::PARSE), m_cFallback(*this) {
 
 		m_nSentenceLength = 0;
+		m_dEmptyThreshold = EMPTY_DETECTOR_THRESHOLD;
 
 		m_pWeight = new Weight(sFeatureInput, sFeatureOut);
 
@@ -26,9 +23,10 @@ namespace emptyeisnergc3rd {
 			m_lItems[1][i].init(i, i, m_nSentenceLength);
 		}
 
-		DepParser::empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
-		DepParser::start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
-		DepParser::end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		empty_taggedword.refer(TWord::code(EMPTY_WORD), TPOSTag::code(EMPTY_POSTAG));
+		start_taggedword.refer(TWord::code(START_WORD), TPOSTag::code(START_POSTAG));
+		end_taggedword.refer(TWord::code(END_WORD), TPOSTag::code(END_POSTAG));
+		m_cEmptyWords.reserve();
 
 		m_tStartTime = 0;
 		m_tInitSpaceTime = 0;
@@ -87,11 +85,10 @@ namespace emptyeisnergc3rd {
 			m_lSentence[idx][0].refer(TWord::code(SENT_WORD(token)), TPOSTag::code(SENT_POSTAG(token)));
 			for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 				m_lSentence[idx][i].refer(
-					TWord::code(
-					(idx == 0 ? START_WORD : TWord::key(m_lSentence[idx - 1][0].first())) +
-					TEmptyTag::key(i) + SENT_WORD(token)
-					),
-					TPOSTag::code(TEmptyTag::key(i))
+					m_cEmptyWords.word(i, idx == 0 ? 0 : m_lSentence[idx - 1][0].first(), m_lSentence[idx][0].first(), [&]() {
+						return (idx == 0 ? START_WORD : TWord::key(m_lSentence[idx - 1][0].first())) + TEmptyTag::key(i) + SENT_WORD(token);
+					}),
+					m_cEmptyWords.postag(i)
 					);
 			}
 			correct.push_back(DependencyTreeNode(token, -1, NULL_LABEL));
@@ -100,20 +97,32 @@ namespace emptyeisnergc3rd {
 		m_lSentence[idx][0].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 		for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 			m_lSentence[idx][i].refer(
-				TWord::code(
-				TWord::key(m_lSentence[idx - 1][0].first()) + TEmptyTag::key(i) + END_WORD
-				),
-				TPOSTag::code(TEmptyTag::key(i))
+				m_cEmptyWords.word(i, m_lSentence[idx - 1][0].first(), 0, [&]() {
+					return TWord::key(m_lSentence[idx - 1][0].first()) + TEmptyTag::key(i) + END_WORD;
+				}),
+				m_cEmptyWords.postag(i)
 				);
 		}
+		if (m_pEmptyDetector) {
+			m_pEmptyDetector->gate(sentence, m_dEmptyThreshold, m_vecOpenEmpty);
+		}
+		m_cEmptyBeams.begin(sentence, m_vecOpenEmpty.empty());
 		work(retval, correct);
+		m_cEmptyBeams.end();
 	}
 
 	void DepParser::work(DependencyTree * retval, const DependencyTree & correct) {
 
+		m_cDeadline.start();
 		decode();
+		m_cDeadline.stop();
 
-		decodeArcs();
+		if (m_cDeadline.missed()) {
+			m_cFallback.decode(m_nSentenceLength, m_vecTrainArcs);
+		}
+		else {
+			decodeArcs();
+		}
 
 		switch (m_nState) {
 		case ParserState::TRAIN:
@@ -137,6 +146,9 @@ namespace emptyeisnergc3rd {
 	void DepParser::decode() {
 
 		for (int d = 1; d <= m_nSentenceLength; ++d) {
+			if (m_cDeadline.expired()) {
+				return;
+			}
 
 			initArcScore(d);
 			if (d > 1) {
@@ -439,7 +451,7 @@ namespace emptyeisnergc3rd {
 	void DepParser::decodeArcs() {
 
 		m_vecTrainArcs.clear();
-		std::stack<std::tuple<int, int, int, int>> stack;
+		FixedStack<std::tuple<int, int, int, int>> stack;
 
 		int s = m_lItems[m_nSentenceLength + 1][0].r2l[0].getSplit();
 		m_vecTrainArcs.push_back(Arc(-1, s));
@@ -817,6 +829,9 @@ namespace emptyeisnergc3rd {
 				m_lArcScore[ENCODE_L2R(i)] = arcScore(i, i + d - 1);
 				m_lArcScore[ENCODE_R2L(i)] = arcScore(i + d - 1, i);
 			}
+			if (m_cEmptyBeams.cached() && m_cEmptyBeams.read(m_abFirstOrderEmptyScore[ENCODE_L2R(i)]) && m_cEmptyBeams.read(m_abFirstOrderEmptyScore[ENCODE_R2L(i)])) {
+				continue;
+			}
 			m_abFirstOrderEmptyScore[ENCODE_L2R(i)].clear();
 			m_abFirstOrderEmptyScore[ENCODE_R2L(i)].clear();
 
@@ -834,6 +849,8 @@ namespace emptyeisnergc3rd {
 					}
 				}
 			}
+			m_cEmptyBeams.write(m_abFirstOrderEmptyScore[ENCODE_L2R(i)]);
+			m_cEmptyBeams.write(m_abFirstOrderEmptyScore[ENCODE_R2L(i)]);
 		}
 	}
 
@@ -888,11 +905,10 @@ namespace emptyeisnergc3rd {
 				m_lSentence[m_nSentenceLength][0].refer(TWord::code(TREENODE_WORD(node)), TPOSTag::code(TREENODE_POSTAG(node)));
 				for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 					m_lSentence[m_nSentenceLength][i].refer(
-						TWord::code(
-						(m_nSentenceLength == 0 ? START_WORD : TWord::key(m_lSentence[m_nSentenceLength - 1][0].first())) +
-						TEmptyTag::key(i) + TREENODE_WORD(node)
-						),
-						TPOSTag::code(TEmptyTag::key(i))
+						m_cEmptyWords.word(i, m_nSentenceLength == 0 ? 0 : m_lSentence[m_nSentenceLength - 1][0].first(), m_lSentence[m_nSentenceLength][0].first(), [&]() {
+							return (m_nSentenceLength == 0 ? START_WORD : TWord::key(m_lSentence[m_nSentenceLength - 1][0].first())) + TEmptyTag::key(i) + TREENODE_WORD(node);
+						}),
+						m_cEmptyWords.postag(i)
 						);
 				}
 				++m_nSentenceLength;
@@ -901,10 +917,10 @@ namespace emptyeisnergc3rd {
 		m_lSentence[m_nSentenceLength][0].refer(TWord::code(ROOT_WORD), TPOSTag::code(ROOT_POSTAG));
 		for (int i = TEmptyTag::start(), max_i = TEmptyTag::end(); i < max_i; ++i) {
 			m_lSentence[m_nSentenceLength][i].refer(
-				TWord::code(
-				TWord::key(m_lSentence[m_nSentenceLength - 1][0].first()) + TEmptyTag::key(i) + END_WORD
-				),
-				TPOSTag::code(TEmptyTag::key(i))
+				m_cEmptyWords.word(i, m_lSentence[m_nSentenceLength - 1][0].first(), 0, [&]() {
+					return TWord::key(m_lSentence[m_nSentenceLength - 1][0].first()) + TEmptyTag::key(i) + END_WORD;
+				}),
+				m_cEmptyWords.postag(i)
 				);
 		}
 		int idx = 0, idxwe = 0;
@@ -935,6 +951,10 @@ namespace emptyeisnergc3rd {
 		int pos_c = DECODE_EMPTY_POS(c);
 		int tag_c = DECODE_EMPTY_TAG(c);
 
+		if (!m_vecOpenEmpty.empty() && !m_vecOpenEmpty[pos_c * MAX_EMPTYTAG_SIZE + tag_c]) {
+			return false;
+		}
+
 		p_tag = m_lSentence[p][0].second();
 
 		c_tag = m_lSentence[pos_c][tag_c].second();
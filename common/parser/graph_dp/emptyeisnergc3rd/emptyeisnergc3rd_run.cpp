@@ -6,9 +6,12 @@
 
 #include "emptyeisnergc3rd_run.h"
 #include "emptyeisnergc3rd_depparser.h"
+#include "common/parser/corpus.h"
+#include "common/parser/epochs.h"
+#include "common/parser/benchmark.h"
 
 namespace emptyeisnergc3rd {
-	Run::Run() = default;
+	Run::Run(const std::string & sEmptyDetector, const double & dEmptyThreshold, const std::string & sEmptyCache) : m_sEmptyDetector(sEmptyDetector), m_dEmptyThreshold(dEmptyThreshold), m_sEmptyCache(sEmptyCache) {}
 
 	Run::~Run() = default;
 
@@ -21,7 +24,7 @@ namespace emptyeisnergc3rd {
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureOutput, ParserState::TRAIN));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> ref_sent) {
 				++nRound;
@@ -42,23 +45,59 @@ namespace emptyeisnergc3rd {
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
 
+	void Run::train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) {
+		DependencyTree ref_sent;
+		std::vector<DependencyTree> corpus;
+
+		// empty nodes grow the vocabulary while training, workers can't share it
+		if (nThreads > 1 || nMixStep > 0) {
+			std::cout << "parameter mixing is not supported by this decoder, train with one thread." << std::endl;
+			return;
+		}
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, vecFeatureOutput.back(), ParserState::TRAIN));
+		CorpusReader input(sInputFile);
+		if (input) {
+			while (input >> ref_sent) {
+				corpus.push_back(ref_sent);
+			}
+			trainEpochs(parser.get(), corpus, vecFeatureOutput, bShuffle);
+		}
+		input.close();
+
+		std::cout << "Done." << std::endl;
+	}
+
+	std::unique_ptr<SentenceParser> Run::load(const std::string & sFeatureFile) {
+		std::unique_ptr<LoadedParser<DepParser>> loaded(new LoadedParser<DepParser>(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE)));
+		DepParser * parser = loaded->get();
+		if (!m_sEmptyDetector.empty()) {
+			parser->setEmptyDetector(EmptyDetector::open(m_sEmptyDetector), m_dEmptyThreshold);
+		}
+		if (!m_sEmptyCache.empty()) {
+			parser->setEmptyCache(ScoreCache::open(m_sEmptyCache, EmptyBeams::fingerprint("emptyeisnergc3rd", sFeatureFile, MAX_EMPTY_SIZE)));
+		}
+		return loaded;
+	}
+
 	void Run::parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) {
 
 		Sentence sentence;
 		DependencyTree tree;
 
+		CorpusWriter output(sOutputFile, m_nFlushTrees, m_nBufferSize);
+
 		std::cout << "Parsing started" << std::endl;
 
 		auto time_begin = time(NULL);
 
-		std::unique_ptr<DepParser> parser(new DepParser(sFeatureFile, sFeatureFile, ParserState::PARSE));
-		std::ifstream input(sInputFile);
-		std::ofstream output(sOutputFile);
+		std::unique_ptr<SentenceParser> parser = load(sFeatureFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> sentence) {
 				if (sentence.size() < MAX_SENTENCE_SIZE) {
-					parser->parse(sentence, &tree);
-					output << tree;
+					parseSentence(*parser, sentence, tree);
+					write(output, tree);
+					output.next();
 					tree.clear();
 				}
 			}
@@ -78,7 +117,7 @@ namespace emptyeisnergc3rd {
 		auto time_begin = time(NULL);
 
 		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, "", ParserState::GOLDTEST));
-		std::ifstream input(sInputFile);
+		CorpusReader input(sInputFile);
 		if (input) {
 			while (input >> ref_sent) {
 				++nRound;
@@ -95,4 +134,26 @@ namespace emptyeisnergc3rd {
 
 		std::cout << "Training has finished successfully. Total time taken is: " << difftime(time_end, time_begin) << "s" << std::endl;
 	}
+
+	// speed/recall curve of the empty detector given by detector=file, the
+	// numeric options are the thresholds
+	// with cache=file it times the empty beam cache instead
+	void Run::benchmark(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecOptions) {
+		std::vector<double> vecThresholds;
+		std::vector<DependencyTree> corrects;
+		readThresholds(vecOptions, vecThresholds);
+		loadGoldTrees(sInputFile, corrects);
+
+		std::shared_ptr<const EmptyDetector> detector;
+		if (!m_sEmptyDetector.empty()) {
+			detector = EmptyDetector::open(m_sEmptyDetector);
+		}
+		std::unique_ptr<DepParser> parser(new DepParser(sFeatureInput, sFeatureInput, ParserState::PARSE));
+		if (!m_sEmptyCache.empty()) {
+			benchmarkEmptyCache(parser.get(), corrects, m_sEmptyCache, EmptyBeams::fingerprint("emptyeisnergc3rd", sFeatureInput, MAX_EMPTY_SIZE));
+		}
+		else {
+			benchmarkEmptyDetector(parser.get(), corrects, detector, vecThresholds);
+		}
+	}
 }
@@ -0,0 +1,231 @@
+#ifndef _CLE_ENGINE_H
+#define _CLE_ENGINE_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "common/parser/macros_base.h"
+#include "include/learning/perceptron/score.h"
+
+// chu-liu-edmonds maximum spanning arborescence over first-order scores,
+// trees may be non-projective
+// SCORER is the decoder providing arcScore(p, c), word n is the root,
+// decode() finds the best tree and decodeArcs() reads it with root arcs (-1, c)
+// this is tarjan's dense variant, best incoming arcs are followed from
+// every word until they reach the root or a cycle, a cycle is contracted
+// into a new node whose incoming and outgoing arcs are merged from its
+// members, so every node is visited once and decoding is O(n^2)
+// contracted nodes take ids from n + 1 on, the arcs of the dense tables
+// remember the words they come from for the expansion
+template<class SCORER>
+class CLEEngine {
+private:
+	static const int MAX_NODES = MAX_SENTENCE_SIZE << 1;
+	static_assert(MAX_NODES <= 128, "arcs are stored as int8");
+
+	enum STATE {
+		UNVISITED = 0,
+		ON_PATH,
+		DONE
+	};
+
+	SCORER & m_rScorer;
+	int m_nSentenceLength;
+	int m_nNodes;
+	tscore m_nScore;
+
+	tscore m_lArcScores[MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
+	// [from][to] between current nodes, with the words of the arc
+	tscore m_lScores[MAX_NODES][MAX_NODES];
+	std::int8_t m_lHeads[MAX_NODES][MAX_NODES];
+	std::int8_t m_lChildren[MAX_NODES][MAX_NODES];
+
+	// node a node was contracted into, -1 while it is a node of the graph
+	int m_lParent[MAX_NODES];
+	int m_lState[MAX_NODES];
+	// best incoming arc of a node when it was visited and the arc kept in the tree
+	tscore m_lInScore[MAX_NODES];
+	std::int8_t m_lInHead[MAX_NODES], m_lInChild[MAX_NODES];
+	std::int8_t m_lHead[MAX_NODES], m_lChild[MAX_NODES];
+
+	std::vector<int> m_vecPath;
+
+	void initScores();
+	void contract(const int & begin);
+	void expand();
+
+public:
+	CLEEngine(SCORER & rScorer) : m_rScorer(rScorer), m_nSentenceLength(0), m_nNodes(0), m_nScore(0) {}
+	~CLEEngine() = default;
+
+	void decode(const int & nSentenceLength);
+	void decodeArcs(std::vector<BiGram<int>> & vecArcs);
+
+	// score of the best tree
+	const tscore & score() const { return m_nScore; }
+};
+
+template<class SCORER>
+void CLEEngine<SCORER>::initScores() {
+	int n = m_nSentenceLength;
+	for (int c = 0; c < n; ++c) {
+		for (int p = 0; p <= n; ++p) {
+			if (p != c) {
+				m_lArcScores[p][c] = m_rScorer.arcScore(p, c);
+				m_lScores[p][c] = m_lArcScores[p][c];
+				m_lHeads[p][c] = p;
+				m_lChildren[p][c] = c;
+			}
+		}
+	}
+	// the root takes a single child, every root arc pays more than any two
+	// trees can differ by, so the best tree has one root arc and is the
+	// best of such trees
+	tscore penalty = 1;
+	for (int c = 0; c < n; ++c) {
+		tscore low = m_lArcScores[n][c], high = low;
+		for (int p = 0; p < n; ++p) {
+			if (p != c) {
+				low = std::min(low, m_lArcScores[p][c]);
+				high = std::max(high, m_lArcScores[p][c]);
+			}
+		}
+		penalty += high - low;
+	}
+	for (int c = 0; c < n; ++c) {
+		m_lScores[n][c] -= penalty;
+	}
+}
+
+// contract the cycle at the end of the path starting with begin
+template<class SCORER>
+void CLEEngine<SCORER>::contract(const int & begin) {
+	int node = m_nNodes++;
+	int first = m_vecPath.size();
+	while (m_vecPath[--first] != begin);
+	for (int i = first; i < (int)m_vecPath.size(); ++i) {
+		m_lParent[m_vecPath[i]] = node;
+	}
+
+	m_lParent[node] = -1;
+	m_lState[node] = UNVISITED;
+	for (int x = 0; x < node; ++x) {
+		if (m_lParent[x] != -1) {
+			continue;
+		}
+		// arcs into the cycle replace the arc of the member they enter
+		int in = -1, out = -1;
+		tscore in_score = 0;
+		for (int i = first; i < (int)m_vecPath.size(); ++i) {
+			int y = m_vecPath[i];
+			if (x != m_nSentenceLength && (out == -1 || m_lScores[out][x] < m_lScores[y][x])) {
+				out = y;
+			}
+			if (in == -1 || in_score < m_lScores[x][y] - m_lInScore[y]) {
+				in = y;
+				in_score = m_lScores[x][y] - m_lInScore[y];
+			}
+		}
+		m_lScores[x][node] = in_score;
+		m_lHeads[x][node] = m_lHeads[x][in];
+		m_lChildren[x][node] = m_lChildren[x][in];
+		if (out != -1) {
+			m_lScores[node][x] = m_lScores[out][x];
+			m_lHeads[node][x] = m_lHeads[out][x];
+			m_lChildren[node][x] = m_lChildren[out][x];
+		}
+	}
+	m_vecPath.resize(first);
+}
+
+// contracted nodes give their arc to the member holding its child and
+// the other members keep the arcs they had in the cycle
+template<class SCORER>
+void CLEEngine<SCORER>::expand() {
+	for (int node = 0; node < m_nNodes; ++node) {
+		if (m_lParent[node] == -1) {
+			m_lHead[node] = m_lInHead[node];
+			m_lChild[node] = m_lInChild[node];
+		}
+	}
+	for (int node = m_nNodes - 1; node > m_nSentenceLength; --node) {
+		int member = m_lChild[node];
+		while (m_lParent[member] != node) {
+			member = m_lParent[member];
+		}
+		for (int y = 0; y < node; ++y) {
+			if (m_lParent[y] == node) {
+				m_lHead[y] = y == member ? m_lHead[node] : m_lInHead[y];
+				m_lChild[y] = y == member ? m_lChild[node] : m_lInChild[y];
+			}
+		}
+	}
+}
+
+template<class SCORER>
+void CLEEngine<SCORER>::decode(const int & nSentenceLength) {
+	m_nSentenceLength = nSentenceLength;
+	m_nNodes = m_nSentenceLength + 1;
+	m_nScore = 0;
+	if (m_nSentenceLength == 0) {
+		return;
+	}
+
+	initScores();
+	for (int node = 0; node < m_nNodes; ++node) {
+		m_lParent[node] = -1;
+		m_lState[node] = UNVISITED;
+	}
+	m_lState[m_nSentenceLength] = DONE;
+
+	for (int word = 0; word < m_nSentenceLength; ++word) {
+		if (m_lState[word] != UNVISITED) {
+			continue;
+		}
+		m_vecPath.clear();
+		int node = word;
+		while (true) {
+			m_lState[node] = ON_PATH;
+			m_vecPath.push_back(node);
+			int head = -1;
+			for (int x = 0; x < m_nNodes; ++x) {
+				if (x != node && m_lParent[x] == -1 && (head == -1 || m_lScores[head][node] < m_lScores[x][node])) {
+					head = x;
+				}
+			}
+			m_lInScore[node] = m_lScores[head][node];
+			m_lInHead[node] = m_lHeads[head][node];
+			m_lInChild[node] = m_lChildren[head][node];
+
+			if (m_lState[head] == DONE) {
+				for (const auto & x : m_vecPath) {
+					m_lState[x] = DONE;
+				}
+				break;
+			}
+			if (m_lState[head] == ON_PATH) {
+				contract(head);
+				node = m_nNodes - 1;
+			}
+			else {
+				node = head;
+			}
+		}
+	}
+
+	expand();
+	for (int c = 0; c < m_nSentenceLength; ++c) {
+		m_nScore += m_lArcScores[m_lHead[c]][c];
+	}
+}
+
+template<class SCORER>
+void CLEEngine<SCORER>::decodeArcs(std::vector<BiGram<int>> & vecArcs) {
+	vecArcs.clear();
+	for (int c = 0; c < m_nSentenceLength; ++c) {
+		vecArcs.push_back(BiGram<int>(m_lHead[c] == m_nSentenceLength ? -1 : m_lHead[c], c));
+	}
+}
+
+#endif
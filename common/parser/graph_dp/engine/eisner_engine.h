@@ -0,0 +1,613 @@
+#ifndef _EISNER_ENGINE_H
+#define _EISNER_ENGINE_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include "common/parser/macros_base.h"
+#include "common/parser/deadline.h"
+#include "common/parser/fixed_stack.h"
+#include "include/learning/perceptron/score.h"
+
+// factors scored by EisnerEngine
+enum EisnerFactor {
+	ARC_FACTOR = 1,
+	SIBLING_FACTOR,
+};
+
+// projective eisner chart shared by the first and second order decoders
+// FACTOR picks the recurrences at compile time, SCORER is the decoder
+// providing the factor scores, it needs
+//   arcScore(p, c)
+//   twoArcScore(p, c, c2) with SIBLING_FACTOR, c is -1 for the first child
+// word n is the root, decode() fills the chart and decodeArcs() backtracks
+// the best tree with a root arc (-1, c)
+// every span keeps the first best split in the order the original decoders
+// tried them, so results are the same split for split
+// scores and splits live in separate tables per span type, the recurrences
+// only read the dense scores and the int8 splits are read by decodeArcs()
+// with setKBest(true) decode() also keeps the factor scores of every span
+// and decodeKBest() enumerates the k best trees from the chart with lazy
+// k-best parsing (huang and chiang 2005, algorithm 3), a span only gets
+// its second best derivation when a bigger span asks for it
+// with a deadline decode() stops between span widths once it has expired,
+// the chart is then unfinished
+// only eisner and eisner2nd decode with it, the higher order decoders use it
+// through FallbackEngine for the sentences over their budget, their own
+// charts keep items per grand parent (gc), beams of bi-split items (3rd)
+// and empty node counts (empty), which no FACTOR covers
+template<int FACTOR, class SCORER>
+class EisnerEngine {
+public:
+	// jux is the pair of adjacent complete spans siblings are built from
+	enum SPAN {
+		JUX = 0,
+		L2R_INCOMPLETE,
+		R2L_INCOMPLETE,
+		L2R,
+		R2L,
+		SPAN_TYPES
+	};
+
+private:
+	static_assert(MAX_SENTENCE_SIZE <= 128, "splits are stored as int8");
+
+	// a span of the chart
+	struct Item {
+		int type, d, i;
+	};
+
+	// derivation of a span, the split and the ranks of the derivations of
+	// its (at most two) sub spans
+	struct Derivation {
+		tscore score;
+		int split;
+		int rank[2];
+
+		bool operator<(const Derivation & derivation) const { return score < derivation.score; }
+	};
+
+	enum KBEST_STATE {
+		KBEST_NEW = 0,
+		KBEST_OPEN,
+		KBEST_EXHAUSTED
+	};
+
+	SCORER & m_rScorer;
+	Deadline * m_pDeadline;
+	int m_nSentenceLength;
+
+	// [type][d][i] for the span [i, i + d - 1], a split of -1 is unset
+	tscore m_lScores[SPAN_TYPES][MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
+	std::int8_t m_lSplits[SPAN_TYPES][MAX_SENTENCE_SIZE][MAX_SENTENCE_SIZE];
+	tscore m_lArcScore[MAX_SENTENCE_SIZE << 1];
+	tscore m_lSiblingScore[FACTOR >= SIBLING_FACTOR ? (MAX_SENTENCE_SIZE << MAX_SENTENCE_BITS) << 1 : 1];
+
+	// k-best, factor scores of the whole sentence, [p][c] and [p][k][c]
+	// with k = p for the first child, and per span its derivations found
+	// so far, the heap of its candidates and its state
+	bool m_bKBest;
+	std::vector<tscore> m_vecArcScores;
+	std::vector<tscore> m_vecSiblingScores;
+	std::vector<std::vector<Derivation>> m_vecDerivations;
+	std::vector<std::vector<Derivation>> m_vecCandidates;
+	std::vector<int> m_vecKBestStates;
+	std::vector<int> m_vecTouched;
+	std::vector<int> m_vecSplits;
+
+	static int encodeL2R(const int & i) { return i << 1; }
+	static int encodeR2L(const int & i) { return (i << 1) + 1; }
+	static int encodeL2R(const int & i, const int & k) { return encodeL2R((i << MAX_SENTENCE_BITS) | k); }
+	static int encodeR2L(const int & i, const int & k) { return encodeR2L((i << MAX_SENTENCE_BITS) | k); }
+
+	const tscore & score(const int & type, const int & d, const int & i) const { return m_lScores[type][d][i]; }
+
+	void init(const int & d, const int & i) {
+		for (int type = 0; type < SPAN_TYPES; ++type) {
+			m_lScores[type][d][i] = 0;
+			m_lSplits[type][d][i] = -1;
+		}
+	}
+
+	void update(const int & type, const int & d, const int & i, const int & split, const tscore & score) {
+		if (m_lSplits[type][d][i] == -1 || m_lScores[type][d][i] < score) {
+			m_lScores[type][d][i] = score;
+			m_lSplits[type][d][i] = split;
+		}
+	}
+
+	void initScores(const int & d);
+	// only the overload of FACTOR is instantiated, scorers without
+	// twoArcScore() stay valid
+	void initSiblingScores(const int &, std::integral_constant<int, ARC_FACTOR>) {}
+	void initSiblingScores(const int & d, std::integral_constant<int, SIBLING_FACTOR>);
+	void decodeSpan(const int & d, const int & i);
+	void decodeRoot(const int & d);
+
+	static int index(const Item & item) { return (item.type * MAX_SENTENCE_SIZE + item.d) * MAX_SENTENCE_SIZE + item.i; }
+	tscore & arcScore(const int & p, const int & c) { return m_vecArcScores[p * MAX_SENTENCE_SIZE + c]; }
+	tscore & siblingScore(const int & p, const int & k, const int & c) { return m_vecSiblingScores[(p * MAX_SENTENCE_SIZE + k) * MAX_SENTENCE_SIZE + c]; }
+	void splits(const Item & item, std::vector<int> & vecSplits) const;
+	int subItems(const Item & item, const int & split, Item (&items)[2]) const;
+	tscore localScore(const Item & item, const int & split);
+	void pushNext(const Item & item, const Derivation & derivation);
+	bool kthBest(const Item & item, const int & k);
+
+public:
+	EisnerEngine(SCORER & rScorer) : m_rScorer(rScorer), m_pDeadline(nullptr), m_nSentenceLength(0), m_bKBest(false) {
+		for (int i = 0; i < MAX_SENTENCE_SIZE; ++i) {
+			init(1, i);
+		}
+	}
+	~EisnerEngine() = default;
+
+	void setDeadline(Deadline * pDeadline) { m_pDeadline = pDeadline; }
+	void decode(const int & nSentenceLength);
+	void decodeArcs(std::vector<BiGram<int>> & vecArcs);
+
+	void setKBest(const bool & bKBest);
+	// at most k best trees from the chart of the last decode(), best first
+	void decodeKBest(const int & k, std::vector<std::vector<BiGram<int>>> & vecArcs, std::vector<tscore> & vecScores);
+
+	// score of the best tree
+	const tscore & score() const { return score(R2L, m_nSentenceLength + 1, 0); }
+};
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::initScores(const int & d) {
+	for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
+		m_lArcScore[encodeL2R(i)] = m_rScorer.arcScore(i, i + d - 1);
+		m_lArcScore[encodeR2L(i)] = m_rScorer.arcScore(i + d - 1, i);
+	}
+	int root = m_nSentenceLength - d + 1;
+	m_lArcScore[encodeR2L(root)] = m_rScorer.arcScore(m_nSentenceLength, root);
+
+	initSiblingScores(d, std::integral_constant<int, FACTOR>());
+
+	if (m_bKBest) {
+		for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
+			int l = i + d - 1;
+			arcScore(i, l) = m_lArcScore[encodeL2R(i)];
+			arcScore(l, i) = m_lArcScore[encodeR2L(i)];
+			if (FACTOR >= SIBLING_FACTOR) {
+				siblingScore(i, i, l) = m_lSiblingScore[encodeL2R(i, i)];
+				siblingScore(l, l, i) = m_lSiblingScore[encodeR2L(i, i)];
+				for (int k = i + 1; k < l; ++k) {
+					siblingScore(i, k, l) = m_lSiblingScore[encodeL2R(i, k)];
+					siblingScore(l, k, i) = m_lSiblingScore[encodeR2L(i, k)];
+				}
+			}
+		}
+		arcScore(m_nSentenceLength, root) = m_lArcScore[encodeR2L(root)];
+		if (FACTOR >= SIBLING_FACTOR) {
+			siblingScore(m_nSentenceLength, m_nSentenceLength, root) = m_lSiblingScore[encodeR2L(root, root)];
+		}
+	}
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::initSiblingScores(const int & d, std::integral_constant<int, SIBLING_FACTOR>) {
+	for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
+		int l = i + d - 1;
+		m_lSiblingScore[encodeL2R(i, i)] = m_rScorer.twoArcScore(i, -1, l);
+		m_lSiblingScore[encodeR2L(i, i)] = m_rScorer.twoArcScore(l, -1, i);
+		for (int k = i + 1; k < l; ++k) {
+			m_lSiblingScore[encodeL2R(i, k)] = m_rScorer.twoArcScore(i, k, l);
+			m_lSiblingScore[encodeR2L(i, k)] = m_rScorer.twoArcScore(l, k, i);
+		}
+	}
+	int root = m_nSentenceLength - d + 1;
+	m_lSiblingScore[encodeR2L(root, root)] = m_rScorer.twoArcScore(m_nSentenceLength, -1, root);
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::decodeSpan(const int & d, const int & i) {
+	int l = i + d - 1;
+	const tscore & l2r_arc_score = m_lArcScore[encodeL2R(i)];
+	const tscore & r2l_arc_score = m_lArcScore[encodeR2L(i)];
+
+	init(d, i);
+
+	if (FACTOR == ARC_FACTOR) {
+		// incomplete
+		for (int s = i; s < l; ++s) {
+			tscore partial = score(L2R, s - i + 1, i) + score(R2L, l - s, s + 1);
+			update(L2R_INCOMPLETE, d, i, s, partial + l2r_arc_score);
+			update(R2L_INCOMPLETE, d, i, s, partial + r2l_arc_score);
+		}
+		// complete
+		update(L2R, d, i, l, score(L2R_INCOMPLETE, d, i));
+		update(R2L, d, i, i, score(R2L_INCOMPLETE, d, i));
+		for (int s = i + 1; s < l; ++s) {
+			update(L2R, d, i, s, score(L2R_INCOMPLETE, s - i + 1, i) + score(L2R, l - s + 1, s));
+			update(R2L, d, i, s, score(R2L_INCOMPLETE, l - s + 1, s) + score(R2L, s - i + 1, i));
+		}
+		return;
+	}
+
+	// jux
+	for (int s = i; s < l; ++s) {
+		update(JUX, d, i, s, score(L2R, s - i + 1, i) + score(R2L, l - s, s + 1));
+	}
+	for (int k = i + 1; k < l; ++k) {
+		int ld = k - i + 1, rd = l - k + 1;
+		// incomplete, k is the previous sibling
+		update(L2R_INCOMPLETE, d, i, k, score(JUX, rd, k) + score(L2R_INCOMPLETE, ld, i) + l2r_arc_score + m_lSiblingScore[encodeL2R(i, k)]);
+		update(R2L_INCOMPLETE, d, i, k, score(JUX, ld, i) + score(R2L_INCOMPLETE, rd, k) + r2l_arc_score + m_lSiblingScore[encodeR2L(i, k)]);
+		// complete
+		update(L2R, d, i, k, score(L2R_INCOMPLETE, ld, i) + score(L2R, rd, k));
+		update(R2L, d, i, k, score(R2L_INCOMPLETE, rd, k) + score(R2L, ld, i));
+	}
+	// incomplete, first child
+	update(L2R_INCOMPLETE, d, i, i, score(R2L, d - 1, i + 1) + l2r_arc_score + m_lSiblingScore[encodeL2R(i, i)]);
+	update(R2L_INCOMPLETE, d, i, l, score(L2R, d - 1, i) + r2l_arc_score + m_lSiblingScore[encodeR2L(i, i)]);
+	// complete
+	update(L2R, d, i, l, score(L2R_INCOMPLETE, d, i));
+	update(R2L, d, i, i, score(R2L_INCOMPLETE, d, i));
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::decodeRoot(const int & d) {
+	int n = m_nSentenceLength, left = n - d + 1;
+	init(d, left);
+
+	// the root takes a single child
+	if (FACTOR == ARC_FACTOR) {
+		update(R2L_INCOMPLETE, d, left, n - 1, score(L2R, d - 1, left) + m_lArcScore[encodeR2L(left)]);
+	}
+	else {
+		update(R2L_INCOMPLETE, d, left, n, score(L2R, d - 1, left) + m_lArcScore[encodeR2L(left)] + m_lSiblingScore[encodeR2L(left, left)]);
+	}
+	update(R2L, d, left, left, score(R2L_INCOMPLETE, d, left));
+	for (int s = left + 1; s < n; ++s) {
+		update(R2L, d, left, s, score(R2L_INCOMPLETE, n - s + 1, s) + score(R2L, s - left + 1, left));
+	}
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::decode(const int & nSentenceLength) {
+	m_nSentenceLength = nSentenceLength;
+	for (int d = 2; d <= m_nSentenceLength + 1; ++d) {
+		if (m_pDeadline != nullptr && m_pDeadline->expired()) {
+			return;
+		}
+		initScores(d);
+		for (int i = 0, max_i = m_nSentenceLength - d + 1; i < max_i; ++i) {
+			decodeSpan(d, i);
+		}
+		decodeRoot(d);
+	}
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::decodeArcs(std::vector<BiGram<int>> & vecArcs) {
+	// (type, left, right)
+	struct Span {
+		int type, left, right;
+	};
+	FixedStack<Span> stack;
+
+	vecArcs.clear();
+	stack.push(Span{ R2L, 0, m_nSentenceLength });
+
+	while (!stack.empty()) {
+		Span span = stack.top();
+		stack.pop();
+
+		int left = span.left, right = span.right;
+		if (left == right) {
+			continue;
+		}
+		int d = right - left + 1, s = m_lSplits[span.type][d][left], head = right == m_nSentenceLength ? -1 : right;
+
+		// arcs come out in the order of the original decoders, the arc
+		// factor reads them off complete spans, the sibling factor off
+		// incomplete ones
+		switch (span.type) {
+		case JUX:
+			if (left < right - 1) {
+				stack.push(Span{ L2R, left, s });
+				stack.push(Span{ R2L, s + 1, right });
+			}
+			break;
+		case L2R:
+			if (FACTOR == ARC_FACTOR) {
+				vecArcs.push_back(BiGram<int>(left, s));
+			}
+			if (left < right - 1) {
+				stack.push(Span{ L2R_INCOMPLETE, left, s });
+				stack.push(Span{ L2R, s, right });
+			}
+			else if (FACTOR != ARC_FACTOR) {
+				vecArcs.push_back(BiGram<int>(left, right));
+			}
+			break;
+		case R2L:
+			if (FACTOR == ARC_FACTOR) {
+				vecArcs.push_back(BiGram<int>(head, s));
+			}
+			if (left < right - 1) {
+				stack.push(Span{ R2L_INCOMPLETE, s, right });
+				stack.push(Span{ R2L, left, s });
+			}
+			else if (FACTOR != ARC_FACTOR) {
+				vecArcs.push_back(BiGram<int>(head, left));
+			}
+			break;
+		case L2R_INCOMPLETE:
+			if (FACTOR == ARC_FACTOR) {
+				stack.push(Span{ L2R, left, s });
+				stack.push(Span{ R2L, s + 1, right });
+				break;
+			}
+			vecArcs.push_back(BiGram<int>(left, right));
+			if (s == left) {
+				stack.push(Span{ R2L, s + 1, right });
+			}
+			else {
+				stack.push(Span{ L2R_INCOMPLETE, left, s });
+				stack.push(Span{ JUX, s, right });
+			}
+			break;
+		case R2L_INCOMPLETE:
+			if (FACTOR == ARC_FACTOR) {
+				stack.push(Span{ L2R, left, s });
+				stack.push(Span{ R2L, s + 1, right });
+				break;
+			}
+			vecArcs.push_back(BiGram<int>(head, left));
+			if (s == right) {
+				stack.push(Span{ L2R, left, s - 1 });
+			}
+			else {
+				stack.push(Span{ R2L_INCOMPLETE, s, right });
+				stack.push(Span{ JUX, left, s });
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::setKBest(const bool & bKBest) {
+	m_bKBest = bKBest;
+	if (m_bKBest && m_vecDerivations.empty()) {
+		int nItems = SPAN_TYPES * MAX_SENTENCE_SIZE * MAX_SENTENCE_SIZE;
+		m_vecArcScores.resize(MAX_SENTENCE_SIZE * MAX_SENTENCE_SIZE);
+		if (FACTOR >= SIBLING_FACTOR) {
+			m_vecSiblingScores.resize(MAX_SENTENCE_SIZE * MAX_SENTENCE_SIZE * MAX_SENTENCE_SIZE);
+		}
+		m_vecDerivations.resize(nItems);
+		m_vecCandidates.resize(nItems);
+		m_vecKBestStates.resize(nItems, KBEST_NEW);
+	}
+}
+
+// every split the recurrences try for a span
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::splits(const Item & item, std::vector<int> & vecSplits) const {
+	int i = item.i, l = item.i + item.d - 1;
+	vecSplits.clear();
+	switch (item.type) {
+	case JUX:
+		for (int s = i; s < l; ++s) {
+			vecSplits.push_back(s);
+		}
+		break;
+	case L2R:
+	case R2L:
+		vecSplits.push_back(item.type == L2R ? l : i);
+		for (int s = i + 1; s < l; ++s) {
+			vecSplits.push_back(s);
+		}
+		break;
+	case L2R_INCOMPLETE:
+	case R2L_INCOMPLETE:
+		// the root takes a single child
+		if (l == m_nSentenceLength) {
+			vecSplits.push_back(FACTOR == ARC_FACTOR ? l - 1 : l);
+		}
+		else if (FACTOR == ARC_FACTOR) {
+			for (int s = i; s < l; ++s) {
+				vecSplits.push_back(s);
+			}
+		}
+		else {
+			vecSplits.push_back(item.type == L2R_INCOMPLETE ? i : l);
+			for (int s = i + 1; s < l; ++s) {
+				vecSplits.push_back(s);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// sub spans a split combines, the score of a derivation is the local score
+// of its split and the scores of theirs
+template<int FACTOR, class SCORER>
+int EisnerEngine<FACTOR, SCORER>::subItems(const Item & item, const int & split, Item (&items)[2]) const {
+	int i = item.i, l = item.i + item.d - 1, s = split;
+	switch (item.type) {
+	case JUX:
+		items[0] = Item{ L2R, s - i + 1, i };
+		items[1] = Item{ R2L, l - s, s + 1 };
+		return 2;
+	case L2R:
+		if (s == l) {
+			items[0] = Item{ L2R_INCOMPLETE, item.d, i };
+			return 1;
+		}
+		items[0] = Item{ L2R_INCOMPLETE, s - i + 1, i };
+		items[1] = Item{ L2R, l - s + 1, s };
+		return 2;
+	case R2L:
+		if (s == i) {
+			items[0] = Item{ R2L_INCOMPLETE, item.d, i };
+			return 1;
+		}
+		items[0] = Item{ R2L_INCOMPLETE, l - s + 1, s };
+		items[1] = Item{ R2L, s - i + 1, i };
+		return 2;
+	case L2R_INCOMPLETE:
+		if (FACTOR == ARC_FACTOR) {
+			items[0] = Item{ L2R, s - i + 1, i };
+			items[1] = Item{ R2L, l - s, s + 1 };
+			return 2;
+		}
+		if (s == i) {
+			items[0] = Item{ R2L, item.d - 1, i + 1 };
+			return 1;
+		}
+		items[0] = Item{ L2R_INCOMPLETE, s - i + 1, i };
+		items[1] = Item{ JUX, l - s + 1, s };
+		return 2;
+	case R2L_INCOMPLETE:
+		if (l == m_nSentenceLength || (FACTOR != ARC_FACTOR && s == l)) {
+			items[0] = Item{ L2R, item.d - 1, i };
+			return 1;
+		}
+		if (FACTOR == ARC_FACTOR) {
+			items[0] = Item{ L2R, s - i + 1, i };
+			items[1] = Item{ R2L, l - s, s + 1 };
+			return 2;
+		}
+		items[0] = Item{ R2L_INCOMPLETE, l - s + 1, s };
+		items[1] = Item{ JUX, s - i + 1, i };
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+template<int FACTOR, class SCORER>
+tscore EisnerEngine<FACTOR, SCORER>::localScore(const Item & item, const int & split) {
+	int i = item.i, l = item.i + item.d - 1;
+	switch (item.type) {
+	case L2R_INCOMPLETE:
+		return arcScore(i, l) + (FACTOR >= SIBLING_FACTOR ? siblingScore(i, split, l) : 0);
+	case R2L_INCOMPLETE:
+		return arcScore(l, i) + (FACTOR >= SIBLING_FACTOR ? siblingScore(l, split, i) : 0);
+	default:
+		return 0;
+	}
+}
+
+// successors of a derivation, ranks of the first sub span only grow while
+// the second is at its best, so every rank pair is pushed once
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::pushNext(const Item & item, const Derivation & derivation) {
+	Item items[2];
+	int n = subItems(item, derivation.split, items);
+	auto & candidates = m_vecCandidates[index(item)];
+	for (int t = 0; t < n; ++t) {
+		if (t == 0 && n == 2 && derivation.rank[1] != 0) {
+			continue;
+		}
+		int rank = derivation.rank[t] + 1;
+		if (kthBest(items[t], rank)) {
+			const auto & derivations = m_vecDerivations[index(items[t])];
+			Derivation next = derivation;
+			next.rank[t] = rank;
+			next.score += derivations[rank].score - derivations[rank - 1].score;
+			candidates.push_back(next);
+			std::push_heap(candidates.begin(), candidates.end());
+		}
+	}
+}
+
+// makes sure the k-th (from 0) best derivation of a span is found,
+// false if the span has fewer derivations
+template<int FACTOR, class SCORER>
+bool EisnerEngine<FACTOR, SCORER>::kthBest(const Item & item, const int & k) {
+	int id = index(item);
+	auto & derivations = m_vecDerivations[id];
+	auto & candidates = m_vecCandidates[id];
+	// the best derivation is the one of the chart
+	if (derivations.empty()) {
+		m_vecTouched.push_back(id);
+		derivations.push_back(Derivation{ score(item.type, item.d, item.i), item.d == 1 ? -1 : m_lSplits[item.type][item.d][item.i], { 0, 0 } });
+		m_vecKBestStates[id] = item.d == 1 ? KBEST_EXHAUSTED : KBEST_NEW;
+	}
+	while ((int)derivations.size() <= k && m_vecKBestStates[id] != KBEST_EXHAUSTED) {
+		if (m_vecKBestStates[id] == KBEST_NEW) {
+			// the best derivation of every other split
+			Item items[2];
+			splits(item, m_vecSplits);
+			for (const auto & split : m_vecSplits) {
+				if (split != derivations[0].split) {
+					Derivation derivation{ localScore(item, split), split, { 0, 0 } };
+					for (int t = 0, n = subItems(item, split, items); t < n; ++t) {
+						derivation.score += score(items[t].type, items[t].d, items[t].i);
+					}
+					candidates.push_back(derivation);
+				}
+			}
+			std::make_heap(candidates.begin(), candidates.end());
+			m_vecKBestStates[id] = KBEST_OPEN;
+		}
+		pushNext(item, derivations.back());
+		if (candidates.empty()) {
+			m_vecKBestStates[id] = KBEST_EXHAUSTED;
+			break;
+		}
+		std::pop_heap(candidates.begin(), candidates.end());
+		derivations.push_back(candidates.back());
+		candidates.pop_back();
+	}
+	return (int)derivations.size() > k;
+}
+
+template<int FACTOR, class SCORER>
+void EisnerEngine<FACTOR, SCORER>::decodeKBest(const int & k, std::vector<std::vector<BiGram<int>>> & vecArcs, std::vector<tscore> & vecScores) {
+	// (span, rank)
+	struct Span {
+		Item item;
+		int rank;
+	};
+	FixedStack<Span> stack;
+	Item items[2];
+
+	for (const auto & id : m_vecTouched) {
+		m_vecDerivations[id].clear();
+		m_vecCandidates[id].clear();
+	}
+	m_vecTouched.clear();
+
+	vecArcs.clear();
+	vecScores.clear();
+	Item root{ R2L, m_nSentenceLength + 1, 0 };
+	for (int rank = 0; rank < k && kthBest(root, rank); ++rank) {
+		vecScores.push_back(m_vecDerivations[index(root)][rank].score);
+		vecArcs.push_back(std::vector<BiGram<int>>());
+		stack.push(Span{ root, rank });
+		while (!stack.empty()) {
+			Span span = stack.top();
+			stack.pop();
+			const Item & item = span.item;
+			if (item.d == 1) {
+				continue;
+			}
+			int l = item.i + item.d - 1;
+			if (item.type == L2R_INCOMPLETE) {
+				vecArcs.back().push_back(BiGram<int>(item.i, l));
+			}
+			else if (item.type == R2L_INCOMPLETE) {
+				vecArcs.back().push_back(BiGram<int>(l == m_nSentenceLength ? -1 : l, item.i));
+			}
+			// sub spans of best derivations may not have been asked for yet
+			kthBest(item, span.rank);
+			const Derivation & derivation = m_vecDerivations[index(item)][span.rank];
+			for (int t = 0, n = subItems(item, derivation.split, items); t < n; ++t) {
+				stack.push(Span{ items[t], derivation.rank[t] });
+			}
+		}
+	}
+}
+
+#endif
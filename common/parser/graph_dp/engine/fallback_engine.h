@@ -0,0 +1,33 @@
+#ifndef _FALLBACK_ENGINE_H
+#define _FALLBACK_ENGINE_H
+
+#include <memory>
+#include <vector>
+
+#include "eisner_engine.h"
+
+// first order eisner over the arc scores of a higher order decoder, it
+// finishes the sentences the decoder runs out of time on
+// SCORER needs arcScore(p, c) with word n the root, as EisnerEngine does,
+// the chart is only allocated for the first sentence that needs it
+template<class SCORER>
+class FallbackEngine {
+private:
+	SCORER & m_rScorer;
+	std::unique_ptr<EisnerEngine<ARC_FACTOR, SCORER>> m_pEngine;
+
+public:
+	FallbackEngine(SCORER & rScorer) : m_rScorer(rScorer) {}
+	~FallbackEngine() = default;
+
+	// arcs of the best first order tree, the root arc is (-1, c)
+	void decode(const int & nSentenceLength, std::vector<BiGram<int>> & vecArcs) {
+		if (!m_pEngine) {
+			m_pEngine.reset(new EisnerEngine<ARC_FACTOR, SCORER>(m_rScorer));
+		}
+		m_pEngine->decode(nSentenceLength);
+		m_pEngine->decodeArcs(vecArcs);
+	}
+};
+
+#endif
@@ -133,6 +133,28 @@ void Weight1st::computeAverageFeatureWeights(const int & round) {
 	m_mapPp_1PpCpCp1.computeAverage(round);
 }
 
+void Weight1st::mixScores(const Weight1st & base, const Weight1st & worker) {
+	m_mapPw.mixScores(base.m_mapPw, worker.m_mapPw);
+	m_mapPp.mixScores(base.m_mapPp, worker.m_mapPp);
+	m_mapPwp.mixScores(base.m_mapPwp, worker.m_mapPwp);
+
+	m_mapCw.mixScores(base.m_mapCw, worker.m_mapCw);
+	m_mapCp.mixScores(base.m_mapCp, worker.m_mapCp);
+	m_mapCwp.mixScores(base.m_mapCwp, worker.m_mapCwp);
+	m_mapPwpCwp.mixScores(base.m_mapPwpCwp, worker.m_mapPwpCwp);
+	m_mapPpCwp.mixScores(base.m_mapPpCwp, worker.m_mapPpCwp);
+	m_mapPwpCp.mixScores(base.m_mapPwpCp, worker.m_mapPwpCp);
+	m_mapPwCwp.mixScores(base.m_mapPwCwp, worker.m_mapPwCwp);
+	m_mapPwpCw.mixScores(base.m_mapPwpCw, worker.m_mapPwpCw);
+	m_mapPwCw.mixScores(base.m_mapPwCw, worker.m_mapPwCw);
+	m_mapPpCp.mixScores(base.m_mapPpCp, worker.m_mapPpCp);
+	m_mapPpBpCp.mixScores(base.m_mapPpBpCp, worker.m_mapPpBpCp);
+	m_mapPpPp1Cp_1Cp.mixScores(base.m_mapPpPp1Cp_1Cp, worker.m_mapPpPp1Cp_1Cp);
+	m_mapPp_1PpCp_1Cp.mixScores(base.m_mapPp_1PpCp_1Cp, worker.m_mapPp_1PpCp_1Cp);
+	m_mapPpPp1CpCp1.mixScores(base.m_mapPpPp1CpCp1, worker.m_mapPpPp1CpCp1);
+	m_mapPp_1PpCpCp1.mixScores(base.m_mapPp_1PpCpCp1, worker.m_mapPp_1PpCpCp1);
+}
+
 void Weight1st::init(const WordPOSTag & tkEmpty, const WordPOSTag & tkStart, const WordPOSTag & tkEnd) {
 	m_tkEmpty.refer(tkEmpty.first(), tkEmpty.second());
 	m_tkStart.refer(tkStart.first(), tkStart.second());
@@ -38,6 +38,7 @@ public:
 	void loadScores();
 	void saveScores() const;
 	void computeAverageFeatureWeights(const int & round);
+	void mixScores(const Weight1st & base, const Weight1st & worker);
 
 	void referRound(const int & nRound);
 	void init(const WordPOSTag & tkEmpty, const WordPOSTag & tkStart, const WordPOSTag & tkEnd);
@@ -21,6 +21,7 @@ public:
 	void loadScores();
 	void saveScores() const;
 	void computeAverageFeatureWeights(const int & round);
+	void mixScores(const Weight2nd & base, const Weight2nd & worker);
 
 	void getOrUpdateBiArcScore(tscore & retval, const int & p, const int & c, const int & c2, const int & amount, int sentLen, WordPOSTag (&sent)[MAX_SENTENCE_SIZE]);
 };
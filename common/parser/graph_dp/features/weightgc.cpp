@@ -136,6 +136,34 @@ void Weightgc::computeAverageFeatureWeights(const int & round) {
 	m_mapMwGp.computeAverage(round);
 }
 
+void Weightgc::mixScores(const Weightgc & base, const Weightgc & worker) {
+	m_mapPw.mixScores(base.m_mapPw, worker.m_mapPw);
+	m_mapPp.mixScores(base.m_mapPp, worker.m_mapPp);
+	m_mapPwp.mixScores(base.m_mapPwp, worker.m_mapPwp);
+
+	m_mapCw.mixScores(base.m_mapCw, worker.m_mapCw);
+	m_mapCp.mixScores(base.m_mapCp, worker.m_mapCp);
+	m_mapCwp.mixScores(base.m_mapCwp, worker.m_mapCwp);
+	m_mapPwpCwp.mixScores(base.m_mapPwpCwp, worker.m_mapPwpCwp);
+	m_mapPpCwp.mixScores(base.m_mapPpCwp, worker.m_mapPpCwp);
+	m_mapPwpCp.mixScores(base.m_mapPwpCp, worker.m_mapPwpCp);
+	m_mapPwCwp.mixScores(base.m_mapPwCwp, worker.m_mapPwCwp);
+	m_mapPwpCw.mixScores(base.m_mapPwpCw, worker.m_mapPwpCw);
+	m_mapPwCw.mixScores(base.m_mapPwCw, worker.m_mapPwCw);
+	m_mapPpCp.mixScores(base.m_mapPpCp, worker.m_mapPpCp);
+	m_mapPpBpCp.mixScores(base.m_mapPpBpCp, worker.m_mapPpBpCp);
+	m_mapPpPp1Cp_1Cp.mixScores(base.m_mapPpPp1Cp_1Cp, worker.m_mapPpPp1Cp_1Cp);
+	m_mapPp_1PpCp_1Cp.mixScores(base.m_mapPp_1PpCp_1Cp, worker.m_mapPp_1PpCp_1Cp);
+	m_mapPpPp1CpCp1.mixScores(base.m_mapPpPp1CpCp1, worker.m_mapPpPp1CpCp1);
+	m_mapPp_1PpCpCp1.mixScores(base.m_mapPp_1PpCpCp1, worker.m_mapPp_1PpCpCp1);
+
+	m_mapGpHpMp.mixScores(base.m_mapGpHpMp, worker.m_mapGpHpMp);
+	m_mapGpMp.mixScores(base.m_mapGpMp, worker.m_mapGpMp);
+	m_mapGwMw.mixScores(base.m_mapGwMw, worker.m_mapGwMw);
+	m_mapGwMp.mixScores(base.m_mapGwMp, worker.m_mapGwMp);
+	m_mapMwGp.mixScores(base.m_mapMwGp, worker.m_mapMwGp);
+}
+
 void Weightgc::getOrUpdateGrandArcScore(tscore & retval, const int & g, const int & h, const int & m, const int & amount, int sentLen, WordPOSTag (&sent)[MAX_SENTENCE_SIZE]) {
 
 	// elements
@@ -21,6 +21,7 @@ public:
 	void loadScores();
 	void saveScores() const;
 	void computeAverageFeatureWeights(const int & round);
+	void mixScores(const Weightgc & base, const Weightgc & worker);
 
 	void getOrUpdateGrandArcScore(tscore & retval, const int & g, const int & h, const int & m, const int & amount, int sentLen, WordPOSTag (&sent)[MAX_SENTENCE_SIZE]);
 };
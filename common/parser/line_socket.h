@@ -0,0 +1,74 @@
+#ifndef _LINE_SOCKET_H
+#define _LINE_SOCKET_H
+
+#include <string>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+// line before a tree the decoder finished with its fallback after the time
+// budget ran out, the tree format has no field for it
+#define DEGRADED_LINE	"#degraded"
+
+// lines of a socket, read through a buffer
+class SocketReader {
+private:
+	int m_nSocket;
+	std::string m_sBuffer;
+
+public:
+	SocketReader(const int & nSocket) : m_nSocket(nSocket) {}
+	~SocketReader() = default;
+
+	// false once the other side has closed without a full line
+	bool getline(std::string & sLine) {
+		char buffer[4096];
+		std::string::size_type end;
+		while ((end = m_sBuffer.find('\n')) == std::string::npos) {
+			ssize_t n = recv(m_nSocket, buffer, sizeof(buffer), 0);
+			if (n == -1 && errno == EINTR) {
+				continue;
+			}
+			if (n <= 0) {
+				return false;
+			}
+			m_sBuffer.append(buffer, n);
+		}
+		sLine = m_sBuffer.substr(0, end);
+		m_sBuffer.erase(0, end + 1);
+		return true;
+	}
+
+	// bytes read from the socket that no line has taken yet
+	bool buffered() const { return !m_sBuffer.empty(); }
+
+	// lines of a tree up to the empty line ending it, all with their newlines
+	bool gettree(std::string & sTree) {
+		std::string line;
+		sTree.clear();
+		while (getline(line)) {
+			sTree += line + "\n";
+			if (line.empty()) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+inline bool sendAll(const int & nSocket, const std::string & sData) {
+	std::string::size_type sent = 0;
+	while (sent < sData.size()) {
+		ssize_t n = send(nSocket, sData.data() + sent, sData.size() - sent, MSG_NOSIGNAL);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		sent += n;
+	}
+	return true;
+}
+
+#endif
@@ -1,12 +1,13 @@
 #include <map>
 #include <set>
-#include <stack>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 
 #include "macros_base.h"
+#include "fixed_stack.h"
 
 int encodeLinkDistance(const int & st, const int & n0) {
 	int diff = n0 - st;
@@ -153,23 +154,23 @@ std::ostream & operator<<(std::ostream & output, const Sentence & sentence) {
 			output << " ";
 		}
 	}
-	output << std::endl;
+	output << "\n";
 	return output;
 }
 
 std::ostream & operator<<(std::ostream & output, const DependencyTree & tree) {
 	for (auto itr = tree.begin(); itr != tree.end(); ++itr) {
-		output << TREENODE_WORD(*itr) << "\t" << TREENODE_POSTAG(*itr) << "\t" << TREENODE_HEAD(*itr) << "\t" << TREENODE_LABEL(*itr) << std::endl;
+		output << TREENODE_WORD(*itr) << "\t" << TREENODE_POSTAG(*itr) << "\t" << TREENODE_HEAD(*itr) << "\t" << TREENODE_LABEL(*itr) << "\n";
 	}
-	output << std::endl;
+	output << "\n";
 	return output;
 }
 
 std::ostream & operator<<(std::ostream & output, const DependencyTaggedTree & tree) {
 	for (auto itr = tree.begin(); itr != tree.end(); ++itr) {
-		output << TREENODE_WORD(itr->first) << "\t" << TREENODE_POSTAG(itr->first) << "\t" << TREENODE_HEAD(itr->first) << "\t" << TREENODE_LABEL(itr->first) << "\t" << itr->second << std::endl;
+		output << TREENODE_WORD(itr->first) << "\t" << TREENODE_POSTAG(itr->first) << "\t" << TREENODE_HEAD(itr->first) << "\t" << TREENODE_LABEL(itr->first) << "\t" << itr->second << "\n";
 	}
-	output << std::endl;
+	output << "\n";
 	return output;
 }
 
@@ -264,3 +265,94 @@ bool hasNonProjectiveTree(std::set<std::pair<int, int>> goldArcs, int len) {
 	}
 	return std::get<1>(std::get<1>(vecStates[len + 1][0])) == len;
 }
+
+void decodeProjectiveHeads(const std::vector<std::vector<tscore>> & vecScores, const int & len, std::vector<int> & vecHeads) {
+	static_assert(MAX_SENTENCE_SIZE <= 128, "splits are stored as int8");
+	// spans [s, t] stored at s * len + t, index 0 for head s and 1 for head t
+	// splits are kept apart from the scores the recurrences read
+	std::vector<tscore> complete[2], incomplete[2];
+	std::vector<std::int8_t> completeSplit[2], incompleteSplit[2];
+	for (int d = 0; d < 2; ++d) {
+		complete[d].assign(len * len, 0);
+		incomplete[d].assign(len * len, 0);
+		completeSplit[d].assign(len * len, -1);
+		incompleteSplit[d].assign(len * len, -1);
+	}
+
+	for (int w = 1; w < len; ++w) {
+		for (int s = 0, t = w; t < len; ++s, ++t) {
+			int span = s * len + t;
+			for (int r = s; r < t; ++r) {
+				tscore score = complete[0][s * len + r] + complete[1][(r + 1) * len + t];
+				if (incompleteSplit[0][span] == -1 || score > incomplete[0][span]) {
+					incomplete[0][span] = incomplete[1][span] = score;
+					incompleteSplit[0][span] = incompleteSplit[1][span] = r;
+				}
+			}
+			incomplete[0][span] += vecScores[s][t];
+			incomplete[1][span] += vecScores[t][s];
+			for (int r = s + 1; r <= t; ++r) {
+				tscore score = incomplete[0][s * len + r] + complete[0][r * len + t];
+				if (completeSplit[0][span] == -1 || score > complete[0][span]) {
+					complete[0][span] = score;
+					completeSplit[0][span] = r;
+				}
+			}
+			for (int r = s; r < t; ++r) {
+				tscore score = complete[1][s * len + r] + incomplete[1][r * len + t];
+				if (completeSplit[1][span] == -1 || score > complete[1][span]) {
+					complete[1][span] = score;
+					completeSplit[1][span] = r;
+				}
+			}
+		}
+	}
+
+	int root = 0;
+	for (int m = 1; m < len; ++m) {
+		if (complete[1][m] + complete[0][m * len + len - 1] + vecScores[len][m] >
+			complete[1][root] + complete[0][root * len + len - 1] + vecScores[len][root]) {
+			root = m;
+		}
+	}
+
+	vecHeads.assign(len, len);
+	// (s, t, head side, complete)
+	struct Span {
+		std::int8_t s, t, d;
+		bool complete;
+	};
+	FixedStack<Span> stack;
+	stack.push({ 0, (std::int8_t)root, 1, true });
+	stack.push({ (std::int8_t)root, (std::int8_t)(len - 1), 0, true });
+	while (!stack.empty()) {
+		Span span = stack.top();
+		stack.pop();
+		int s = span.s, t = span.t;
+		if (s == t) {
+			continue;
+		}
+		if (span.complete) {
+			std::int8_t r = completeSplit[span.d][s * len + t];
+			if (span.d == 0) {
+				stack.push({ span.s, r, 0, false });
+				stack.push({ r, span.t, 0, true });
+			}
+			else {
+				stack.push({ span.s, r, 1, true });
+				stack.push({ r, span.t, 1, false });
+			}
+		}
+		else {
+			std::int8_t r = incompleteSplit[span.d][s * len + t];
+			if (span.d == 0) {
+				vecHeads[t] = s;
+			}
+			else {
+				vecHeads[s] = t;
+			}
+			stack.push({ span.s, r, 0, true });
+			stack.push({ (std::int8_t)(r + 1), span.t, 1, true });
+		}
+	}
+}
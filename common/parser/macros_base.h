@@ -139,5 +139,8 @@ std::ostream & operator<<(std::ostream & output, const DependencyTaggedTree & tr
 
 void nBackSpace(const std::string & str);
 bool hasNonProjectiveTree(std::set<std::pair<int, int>> goldArcs, int len);
+// best projective tree under first-order scores, vecScores[h][m] with the root at len
+// the root takes a single child, whose head is len in vecHeads
+void decodeProjectiveHeads(const std::vector<std::vector<tscore>> & vecScores, const int & len, std::vector<int> & vecHeads);
 
 #endif
@@ -0,0 +1,154 @@
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <thread>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+
+#include "parse_scheduler.h"
+#include "common/token/word.h"
+#include "common/token/pos.h"
+
+ParseScheduler::ParseScheduler(RunBase & rRun, const int & nThreads) : m_rRun(rRun), m_nThreads(std::max(nThreads, 1)) {}
+
+ParseScheduler::~ParseScheduler() = default;
+
+bool ParseScheduler::load(const std::string & sFeatureFile) {
+	// models fill the tokenizers while loading, so workers are loaded in turn
+	m_vecWorkers.clear();
+	for (int t = 0; t < m_nThreads; ++t) {
+		m_vecWorkers.push_back(m_rRun.load(sFeatureFile));
+		if (!m_vecWorkers.back()) {
+			return false;
+		}
+	}
+	m_vecBusy.assign(m_nThreads, 0.0);
+	m_vecSteals.assign(m_nThreads, 0);
+	return true;
+}
+
+double ParseScheduler::cost(const Sentence & sentence) const {
+	return std::pow((double)sentence.size(), m_rRun.timeExponent());
+}
+
+// own queue first, then the longest sentence at the head of another queue
+bool ParseScheduler::next(std::vector<Queue> & queues, const std::vector<double> & costs, const int & worker, int & index) {
+	{
+		std::lock_guard<std::mutex> lock(queues[worker].mtx);
+		if (!queues[worker].items.empty()) {
+			index = queues[worker].items.front();
+			queues[worker].items.pop_front();
+			return true;
+		}
+	}
+	while (true) {
+		int victim = -1;
+		for (int t = 0; t < (int)queues.size(); ++t) {
+			if (t == worker) {
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(queues[t].mtx);
+			if (!queues[t].items.empty() && (victim == -1 || costs[index] < costs[queues[t].items.front()])) {
+				victim = t;
+				index = queues[t].items.front();
+			}
+		}
+		if (victim == -1) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(queues[victim].mtx);
+		if (!queues[victim].items.empty()) {
+			index = queues[victim].items.front();
+			queues[victim].items.pop_front();
+			++m_vecSteals[worker];
+			return true;
+		}
+	}
+}
+
+// busy time is the cpu time of the thread, so workers sharing a core don't
+// count it twice
+void ParseScheduler::work(std::vector<Queue> & queues, const std::vector<double> & costs, const std::vector<Sentence> & vecSentences, std::vector<DependencyTree> & vecTrees, const int & worker) {
+	int index;
+	timespec time_begin, time_end;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time_begin);
+	while (next(queues, costs, worker, index)) {
+		m_rRun.parseSentence(*m_vecWorkers[worker], vecSentences[index], vecTrees[index]);
+	}
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time_end);
+	m_vecBusy[worker] += (time_end.tv_sec - time_begin.tv_sec) + (time_end.tv_nsec - time_begin.tv_nsec) * 1e-9;
+}
+
+void ParseScheduler::parse(const std::vector<Sentence> & vecSentences, std::vector<DependencyTree> & vecTrees) {
+	std::vector<int> order;
+	std::vector<double> costs(vecSentences.size());
+	vecTrees.assign(vecSentences.size(), DependencyTree());
+	for (int i = 0; i < (int)vecSentences.size(); ++i) {
+		if (vecSentences[i].size() < MAX_SENTENCE_SIZE) {
+			for (const auto & token : vecSentences[i]) {
+				TWord::code(SENT_WORD(token));
+				TPOSTag::code(SENT_POSTAG(token));
+			}
+			costs[i] = cost(vecSentences[i]);
+			order.push_back(i);
+		}
+	}
+	TWord::code(ROOT_WORD);
+	TPOSTag::code(ROOT_POSTAG);
+	std::stable_sort(order.begin(), order.end(), [&costs](const int & a, const int & b) { return costs[a] > costs[b]; });
+
+	std::vector<Queue> queues(m_nThreads);
+	for (int i = 0; i < (int)order.size(); ++i) {
+		queues[i % m_nThreads].items.push_back(order[i]);
+	}
+	std::vector<std::thread> threads;
+	for (int t = 0; t < m_nThreads; ++t) {
+		threads.push_back(std::thread([&, t]() {
+			work(queues, costs, vecSentences, vecTrees, t);
+		}));
+	}
+	for (auto & thread : threads) {
+		thread.join();
+	}
+}
+
+void ParseScheduler::parse(const std::string & sInputFile, CorpusWriter & output) {
+	Sentence sentence;
+	std::vector<Sentence> sentences;
+	std::vector<DependencyTree> trees;
+	double wall = 0.0;
+	int nSentences = 0;
+
+	std::cout << "Parsing started with " << m_nThreads << " threads" << std::endl;
+
+	auto time_begin = std::chrono::steady_clock::now();
+
+	CorpusReader input(sInputFile);
+	bool more = (bool)input;
+	while (more) {
+		sentences.clear();
+		while (sentences.size() < PARSE_SCHEDULER_BATCH && (more = (bool)(input >> sentence))) {
+			sentences.push_back(sentence);
+		}
+		auto batch_begin = std::chrono::steady_clock::now();
+		parse(sentences, trees);
+		wall += std::chrono::duration<double>(std::chrono::steady_clock::now() - batch_begin).count();
+		for (std::size_t i = 0; i < sentences.size(); ++i) {
+			if (sentences[i].size() < MAX_SENTENCE_SIZE) {
+				m_rRun.write(output, trees[i]);
+				output.next();
+				++nSentences;
+			}
+		}
+	}
+	input.close();
+	output.close();
+
+	double busy = std::accumulate(m_vecBusy.begin(), m_vecBusy.end(), 0.0);
+	std::cout << "Parsing has finished successfully. Total time taken is: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - time_begin).count() << "s" << std::endl;
+	std::cout << nSentences << " sentences parsed in " << wall << "s, core utilization " << (wall == 0.0 ? 0.0 : 100.0 * busy / (wall * m_nThreads)) << "%" << std::endl;
+	for (int t = 0; t < m_nThreads; ++t) {
+		std::cout << "worker " << t << " busy " << m_vecBusy[t] << "s, stole " << m_vecSteals[t] << " sentences" << std::endl;
+	}
+}
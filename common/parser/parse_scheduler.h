@@ -0,0 +1,53 @@
+#ifndef _PARSE_SCHEDULER_H
+#define _PARSE_SCHEDULER_H
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "corpus.h"
+#include "run_base.h"
+#include "sentence_parser.h"
+
+#define PARSE_SCHEDULER_BATCH	4096
+
+// parses with one loaded parser per thread
+// sentences are read in batches, a batch is sorted by the cost its decoder
+// pays for each length, the longest go first and are dealt in turn to the
+// queues of the workers, a worker with an empty queue steals the longest
+// sentence still waiting anywhere, trees are written in input order
+// words and tags of a batch are coded before the workers start, so they only
+// look known keys up in the shared tokenizers
+class ParseScheduler {
+private:
+	struct Queue {
+		std::mutex mtx;
+		std::deque<int> items;
+	};
+
+	RunBase & m_rRun;
+	int m_nThreads;
+	std::vector<std::unique_ptr<SentenceParser>> m_vecWorkers;
+
+	// seconds every worker spent parsing and sentences it stole
+	std::vector<double> m_vecBusy;
+	std::vector<int> m_vecSteals;
+
+	double cost(const Sentence & sentence) const;
+	bool next(std::vector<Queue> & queues, const std::vector<double> & costs, const int & worker, int & index);
+	void work(std::vector<Queue> & queues, const std::vector<double> & costs, const std::vector<Sentence> & vecSentences, std::vector<DependencyTree> & vecTrees, const int & worker);
+
+public:
+	ParseScheduler(RunBase & rRun, const int & nThreads);
+	~ParseScheduler();
+
+	bool load(const std::string & sFeatureFile);
+	// tree i is the parse of sentence i, empty for sentences parse skips
+	void parse(const std::vector<Sentence> & vecSentences, std::vector<DependencyTree> & vecTrees);
+	// parses sInputFile into output and reports how busy the workers were
+	void parse(const std::string & sInputFile, CorpusWriter & output);
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <csignal>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+#include "line_socket.h"
+#include "parse_server.h"
+#include "common/token/vocabulary.h"
+
+namespace {
+	bool address(const std::string & sSocketFile, sockaddr_un & addr) {
+		if (sSocketFile.size() >= sizeof(addr.sun_path)) {
+			std::cout << "socket path " << sSocketFile << " is too long." << std::endl;
+			return false;
+		}
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		strcpy(addr.sun_path, sSocketFile.c_str());
+		return true;
+	}
+
+	int connectTo(const std::string & sSocketFile) {
+		sockaddr_un addr;
+		if (!address(sSocketFile, addr)) {
+			return -1;
+		}
+		int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (connection == -1 || connect(connection, (sockaddr *)&addr, sizeof(addr)) == -1) {
+			std::cout << "can't connect to " << sSocketFile << ": " << strerror(errno) << std::endl;
+			if (connection != -1) {
+				close(connection);
+			}
+			return -1;
+		}
+		return connection;
+	}
+
+	// the signal handler only wakes the thread that reloads
+	int hangup_pipe[2] = { -1, -1 };
+
+	void hangup(int) {
+		int saved = errno;
+		char c = 0;
+		write(hangup_pipe[1], &c, 1);
+		errno = saved;
+	}
+}
+
+ParseServer::ParseServer(RunBase & rRun) : m_rRun(rRun), m_nVersion(0), m_nSocket(-1) {}
+
+ParseServer::~ParseServer() {
+	if (m_nSocket != -1) {
+		close(m_nSocket);
+		unlink(m_sSocketFile.c_str());
+	}
+}
+
+bool ParseServer::open(const std::string & sSocketFile, const std::string & sFeatureFile) {
+	sockaddr_un addr;
+	if (!address(sSocketFile, addr)) {
+		return false;
+	}
+
+	auto time_begin = std::chrono::steady_clock::now();
+	m_pParser = m_rRun.load(sFeatureFile);
+	if (!m_pParser) {
+		return false;
+	}
+	std::cout << "models loaded in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - time_begin).count() << "s" << std::endl;
+	m_sFeatureFile = sFeatureFile;
+	m_nVersion = 1;
+
+	// a socket file left by a server that was stopped is replaced
+	unlink(sSocketFile.c_str());
+	m_nSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (m_nSocket == -1 || bind(m_nSocket, (sockaddr *)&addr, sizeof(addr)) == -1 || listen(m_nSocket, SOMAXCONN) == -1) {
+		std::cout << "can't listen on " << sSocketFile << ": " << strerror(errno) << std::endl;
+		if (m_nSocket != -1) {
+			close(m_nSocket);
+			m_nSocket = -1;
+		}
+		return false;
+	}
+	m_sSocketFile = sSocketFile;
+	std::cout << "listening on " << m_sSocketFile << std::endl;
+	return true;
+}
+
+bool ParseServer::reload(const std::string & sFeatureFile) {
+	std::lock_guard<std::mutex> reload(m_mtxReload);
+	std::string feature = sFeatureFile.empty() ? m_sFeatureFile : sFeatureFile;
+	// a missing file would load as empty models, cascaded decoders take
+	// model#pruning and every file of the cascade has to be there
+	std::istringstream files(feature);
+	std::string file;
+	while (std::getline(files, file, '#')) {
+		if (!std::ifstream(file)) {
+			std::cout << "can't read " << file << ", models of version " << m_nVersion << " stay." << std::endl;
+			return false;
+		}
+	}
+
+	auto time_begin = std::chrono::steady_clock::now();
+	Vocabulary vocabulary;
+	vocabulary.use();
+	std::unique_ptr<SentenceParser> parser = m_rRun.load(feature);
+	Vocabulary::release();
+	if (!parser) {
+		std::cout << "loading " << feature << " failed, models of version " << m_nVersion << " stay." << std::endl;
+		return false;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_begin).count();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mtxParser);
+		vocabulary.swap();
+		m_pParser.swap(parser);
+		// trees of the old models
+		if (m_rRun.sentenceCache()) {
+			m_rRun.sentenceCache()->clear();
+		}
+		m_sFeatureFile = feature;
+		++m_nVersion;
+	}
+	// the old models and their vocabulary go here, outside of the lock
+	parser.reset();
+	std::cout << "models of " << feature << " loaded in " << seconds << "s, version " << m_nVersion << " in use" << std::endl;
+	return true;
+}
+
+void ParseServer::watch() {
+	char c;
+	while (true) {
+		ssize_t n = read(hangup_pipe[0], &c, 1);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return;
+		}
+		reload("");
+	}
+}
+
+std::string ParseServer::answer(const std::string & sLine) {
+	if (sLine.compare(0, strlen(PARSE_SERVER_RELOAD), PARSE_SERVER_RELOAD) == 0) {
+		std::string feature;
+		std::istringstream(sLine.substr(strlen(PARSE_SERVER_RELOAD))) >> feature;
+		return reload(feature) ? "reloaded\n\n" : "reload failed\n\n";
+	}
+	Sentence sentence;
+	DependencyTree tree;
+	std::istringstream input(sLine);
+	std::ostringstream output;
+	input >> sentence;
+	if (sentence.empty() || sentence.size() >= MAX_SENTENCE_SIZE) {
+		return "\n";
+	}
+	std::lock_guard<std::mutex> lock(m_mtxParser);
+	if (m_rRun.parseSentence(*m_pParser, sentence, tree)) {
+		output << DEGRADED_LINE << std::endl;
+	}
+	m_rRun.write(output, tree);
+	return output.str();
+}
+
+void ParseServer::serve(const int & nConnection) {
+	SocketReader reader(nConnection);
+	std::string line;
+	while (reader.getline(line)) {
+		if (!sendAll(nConnection, answer(line))) {
+			break;
+		}
+	}
+	close(nConnection);
+	if (m_rRun.sentenceCache()) {
+		m_rRun.sentenceCache()->report(std::cout);
+	}
+	if (m_rRun.budget() > 0.0) {
+		m_rRun.reportBudget(std::cout);
+	}
+}
+
+void ParseServer::run() {
+	if (hangup_pipe[0] == -1 && pipe(hangup_pipe) == 0) {
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = hangup;
+		action.sa_flags = SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGHUP, &action, nullptr);
+		std::thread(&ParseServer::watch, this).detach();
+	}
+	while (true) {
+		int connection = accept(m_nSocket, nullptr, nullptr);
+		if (connection == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			std::cout << "accept failed: " << strerror(errno) << std::endl;
+			return;
+		}
+		std::thread(&ParseServer::serve, this, connection).detach();
+	}
+}
+
+bool ParseServer::client(const std::string & sSocketFile, const std::string & sInputFile, const std::string & sOutputFile) {
+	int connection = connectTo(sSocketFile);
+	if (connection == -1) {
+		return false;
+	}
+
+	std::ifstream input(sInputFile);
+	std::ofstream output(sOutputFile);
+	SocketReader reader(connection);
+	std::string sentence, line;
+	std::vector<double> latencies;
+	int degraded = 0;
+
+	auto time_begin = std::chrono::steady_clock::now();
+	bool ok = true;
+	while (ok && std::getline(input, sentence)) {
+		auto request_begin = std::chrono::steady_clock::now();
+		ok = sendAll(connection, sentence + "\n");
+		std::string tree;
+		while (ok && (ok = reader.getline(line)) && !line.empty()) {
+			if (tree.empty() && line == DEGRADED_LINE) {
+				++degraded;
+				continue;
+			}
+			tree += line + "\n";
+		}
+		if (!ok) {
+			break;
+		}
+		latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - request_begin).count());
+		// sentences parse skips are answered without a tree
+		if (!tree.empty()) {
+			output << tree << std::endl;
+		}
+	}
+	double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_begin).count();
+	close(connection);
+	output.close();
+
+	if (!ok) {
+		std::cout << "connection to " << sSocketFile << " lost." << std::endl;
+	}
+	if (!latencies.empty()) {
+		double sum = 0.0;
+		for (const auto & latency : latencies) {
+			sum += latency;
+		}
+		std::sort(latencies.begin(), latencies.end());
+		auto percentile = [&](const double & p) { return latencies[std::min((int)(p * latencies.size()), (int)latencies.size() - 1)]; };
+		std::cout << latencies.size() << " requests in " << total << "s" << std::endl;
+		std::cout << "latency ms: mean " << sum / latencies.size() << " p50 " << percentile(0.5) << " p95 " << percentile(0.95) << " p99 " << percentile(0.99) << " max " << latencies.back() << std::endl;
+		if (degraded > 0) {
+			std::cout << degraded << " trees degraded by the time budget of the server" << std::endl;
+		}
+	}
+	return ok;
+}
+
+bool ParseServer::requestReload(const std::string & sSocketFile, const std::string & sFeatureFile) {
+	int connection = connectTo(sSocketFile);
+	if (connection == -1) {
+		return false;
+	}
+	SocketReader reader(connection);
+	std::string line;
+	bool ok = sendAll(connection, std::string(PARSE_SERVER_RELOAD) + " " + sFeatureFile + "\n") && reader.getline(line);
+	close(connection);
+	std::cout << (ok ? line : "connection to " + sSocketFile + " lost.") << std::endl;
+	return ok && line == "reloaded";
+}
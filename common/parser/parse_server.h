@@ -0,0 +1,66 @@
+#ifndef _PARSE_SERVER_H
+#define _PARSE_SERVER_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+
+#include "run_base.h"
+#include "sentence_parser.h"
+
+// request line that replaces the models, optionally followed by a model file,
+// answered by reloaded or reload failed and the empty line
+#define PARSE_SERVER_RELOAD	"#reload"
+
+// long-lived parser answering on a unix domain socket, the models are
+// loaded once and stay warm between requests
+// a request is a line holding a sentence in the input format of parse, the
+// answer is its tree in the output format of parse, ended by the empty line
+// trees end with, sentences parse can't take are answered by the empty line
+// alone, trees the decoder finished with its fallback after the time budget
+// ran out come after a DEGRADED_LINE
+// every connection has its own thread, parsing goes through one parser at a
+// time since the tokenizers of a process are shared
+// the models are replaced on SIGHUP, which reads the model file again (write
+// the new one aside and rename it over the old), or on a PARSE_SERVER_RELOAD
+// request, new models load into a vocabulary of their own while the old ones
+// keep parsing, and take their place between two sentences, the old models
+// are freed once the sentence being parsed with them is done
+class ParseServer {
+private:
+	RunBase & m_rRun;
+	std::unique_ptr<SentenceParser> m_pParser;
+	std::mutex m_mtxParser;
+	// one reload at a time
+	std::mutex m_mtxReload;
+	std::string m_sFeatureFile;
+	int m_nVersion;
+	std::string m_sSocketFile;
+	int m_nSocket;
+
+	void serve(const int & nConnection);
+	// reloads on every SIGHUP
+	void watch();
+	// tree of a request line, with its empty line
+	std::string answer(const std::string & sLine);
+
+public:
+	ParseServer(RunBase & rRun);
+	~ParseServer();
+
+	// loads the models and listens on sSocketFile
+	bool open(const std::string & sSocketFile, const std::string & sFeatureFile);
+	// accepts connections until the process is stopped
+	void run();
+	// loads the models of sFeatureFile, the current file when empty, and
+	// replaces the ones in use, which stay when loading fails
+	bool reload(const std::string & sFeatureFile);
+
+	// sends every sentence of sInputFile to the server on sSocketFile, writes
+	// the answers to sOutputFile and reports the latency of the requests
+	static bool client(const std::string & sSocketFile, const std::string & sInputFile, const std::string & sOutputFile);
+	// asks the server on sSocketFile to reload and prints its answer
+	static bool requestReload(const std::string & sSocketFile, const std::string & sFeatureFile);
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include <map>
+#include <deque>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+#include "line_socket.h"
+#include "prefork_parser.h"
+
+PreforkParser::PreforkParser(RunBase & rRun, const int & nWorkers) : m_rRun(rRun), m_nWorkers(std::max(nWorkers, 1)) {}
+
+PreforkParser::~PreforkParser() {
+	stop();
+}
+
+bool PreforkParser::load(const std::string & sFeatureFile) {
+	m_pParser = m_rRun.load(sFeatureFile);
+	return m_pParser && fork();
+}
+
+bool PreforkParser::fork() {
+	// nothing buffered is written twice by the children
+	std::cout.flush();
+	fflush(stdout);
+	for (int w = 0; w < m_nWorkers; ++w) {
+		int sockets[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == -1) {
+			std::cout << "can't create a socket pair for worker " << w << "." << std::endl;
+			return false;
+		}
+		pid_t pid = ::fork();
+		if (pid == -1) {
+			std::cout << "can't fork worker " << w << "." << std::endl;
+			close(sockets[0]);
+			close(sockets[1]);
+			return false;
+		}
+		if (pid == 0) {
+			// the parent's ends of the other workers are closed, so every
+			// worker sees the end of its input when the parent closes its end
+			for (const auto & worker : m_vecWorkers) {
+				close(worker.socket);
+			}
+			close(sockets[0]);
+			serve(sockets[1]);
+			// destructors would flush the parent's buffers a second time
+			_exit(0);
+		}
+		close(sockets[1]);
+		m_vecWorkers.push_back(Worker{ pid, sockets[0], 0 });
+	}
+	return true;
+}
+
+void PreforkParser::serve(const int & nSocket) {
+	SocketReader reader(nSocket);
+	std::string line;
+	Sentence sentence;
+	DependencyTree tree;
+	while (reader.getline(line)) {
+		std::istringstream input(line);
+		std::ostringstream output;
+		input >> sentence;
+		tree.clear();
+		if (m_rRun.parseSentence(*m_pParser, sentence, tree)) {
+			output << DEGRADED_LINE << std::endl;
+		}
+		m_rRun.write(output, tree);
+		if (!sendAll(nSocket, output.str())) {
+			break;
+		}
+	}
+	close(nSocket);
+}
+
+void PreforkParser::stop() {
+	for (const auto & worker : m_vecWorkers) {
+		close(worker.socket);
+	}
+	for (const auto & worker : m_vecWorkers) {
+		waitpid(worker.pid, nullptr, 0);
+	}
+	m_vecWorkers.clear();
+}
+
+// memory of the parent and the workers, pss shares every page among the
+// processes mapping it, so the sum of pss is what they take together
+void PreforkParser::report(const int & nSentences, const double & dSeconds) {
+	std::cout << nSentences << " sentences parsed by " << m_nWorkers << " workers in " << dSeconds << "s (" << (dSeconds == 0.0 ? 0.0 : nSentences / dSeconds) << " sentences/s)" << std::endl;
+	std::vector<pid_t> pids(1, getpid());
+	for (const auto & worker : m_vecWorkers) {
+		pids.push_back(worker.pid);
+	}
+	long long total_rss = 0, total_pss = 0;
+	for (std::size_t i = 0; i < pids.size(); ++i) {
+		std::ifstream smaps("/proc/" + std::to_string(pids[i]) + "/smaps_rollup");
+		std::string line, key;
+		long long kb, rss = 0, pss = 0;
+		while (std::getline(smaps, line)) {
+			std::istringstream fields(line);
+			if (!(fields >> key >> kb)) {
+				continue;
+			}
+			if (key == "Rss:") {
+				rss = kb;
+			}
+			else if (key == "Pss:") {
+				pss = kb;
+			}
+		}
+		if (rss == 0) {
+			return;
+		}
+		std::cout << (i == 0 ? "parent" : "worker " + std::to_string(i - 1)) << " rss " << rss << " kB, pss " << pss << " kB" << std::endl;
+		total_rss += rss;
+		total_pss += pss;
+	}
+	std::cout << "total rss " << total_rss << " kB, total pss " << total_pss << " kB" << std::endl;
+}
+
+void PreforkParser::parse(const std::string & sInputFile, CorpusWriter & output) {
+	Sentence sentence;
+	std::vector<SocketReader> readers;
+	// input indices each worker has, in the order it answers them
+	std::vector<std::deque<int>> pending(m_vecWorkers.size());
+	// trees waiting for the ones before them, empty for skipped sentences
+	std::map<int, std::string> trees;
+	std::vector<pollfd> fds;
+	int nRead = 0, nWritten = 0, nSentences = 0, nDegraded = 0;
+	const std::string degraded = std::string(DEGRADED_LINE) + "\n";
+
+	for (const auto & worker : m_vecWorkers) {
+		readers.push_back(SocketReader(worker.socket));
+		fds.push_back(pollfd{ worker.socket, POLLIN, 0 });
+	}
+
+	std::cout << "Parsing started with " << m_nWorkers << " workers" << std::endl;
+
+	auto time_begin = std::chrono::steady_clock::now();
+
+	CorpusReader input(sInputFile);
+	bool more = (bool)input;
+	bool ok = true;
+	while (ok) {
+		// every free slot of a worker takes the next sentence
+		for (int w = 0; w < (int)m_vecWorkers.size() && more; ++w) {
+			while (m_vecWorkers[w].inflight < PREFORK_INFLIGHT && (more = (bool)(input >> sentence))) {
+				if (sentence.size() >= MAX_SENTENCE_SIZE) {
+					trees[nRead++] = "";
+					continue;
+				}
+				std::ostringstream line;
+				line << sentence;
+				if (!sendAll(m_vecWorkers[w].socket, line.str())) {
+					ok = false;
+					break;
+				}
+				pending[w].push_back(nRead++);
+				++m_vecWorkers[w].inflight;
+			}
+		}
+		while (trees.find(nWritten) != trees.end()) {
+			if (!trees[nWritten].empty()) {
+				output << trees[nWritten];
+				output.next();
+				++nSentences;
+			}
+			trees.erase(nWritten++);
+		}
+		if (!ok || (nWritten == nRead && !more)) {
+			break;
+		}
+
+		if (poll(fds.data(), fds.size(), -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			ok = false;
+			break;
+		}
+		for (int w = 0; w < (int)m_vecWorkers.size(); ++w) {
+			if (fds[w].revents == 0) {
+				continue;
+			}
+			// trees that came in one read are all taken now, poll won't
+			// tell about them again
+			do {
+				std::string tree;
+				if (pending[w].empty() || !readers[w].gettree(tree)) {
+					std::cout << "worker " << w << " stopped." << std::endl;
+					ok = false;
+					break;
+				}
+				// the decoders count in the workers, the parent counts the marks
+				if (tree.compare(0, degraded.size(), degraded) == 0) {
+					tree.erase(0, degraded.size());
+					++nDegraded;
+				}
+				trees[pending[w].front()] = tree;
+				pending[w].pop_front();
+				--m_vecWorkers[w].inflight;
+			} while (readers[w].buffered());
+			if (!ok) {
+				break;
+			}
+		}
+	}
+	input.close();
+	output.close();
+
+	report(nSentences, std::chrono::duration<double>(std::chrono::steady_clock::now() - time_begin).count());
+	if (m_rRun.budget() > 0.0) {
+		std::cout << "budget " << m_rRun.budget() << "ms: " << nDegraded << " of " << nSentences << " sentences degraded" << std::endl;
+	}
+	stop();
+	std::cout << (ok ? "Parsing has finished successfully." : "Parsing has failed.") << std::endl;
+}
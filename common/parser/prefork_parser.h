@@ -0,0 +1,49 @@
+#ifndef _PREFORK_PARSER_H
+#define _PREFORK_PARSER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "corpus.h"
+#include "run_base.h"
+#include "sentence_parser.h"
+
+// sentences a worker holds at once, so it never waits for the next one
+#define PREFORK_INFLIGHT	2
+
+// parses with worker processes forked after the models are loaded, so the
+// workers share the pages of one model copy-on-write, parsing only reads the
+// weights and the pages stay shared
+// the parent sends every worker sentences in the input format over a socket
+// pair and reads back trees in the output format, a worker has at most
+// PREFORK_INFLIGHT sentences at once and trees are written in input order
+class PreforkParser {
+private:
+	struct Worker {
+		pid_t pid;
+		int socket;
+		int inflight;
+	};
+
+	RunBase & m_rRun;
+	int m_nWorkers;
+	std::unique_ptr<SentenceParser> m_pParser;
+	std::vector<Worker> m_vecWorkers;
+
+	bool fork();
+	void serve(const int & nSocket);
+	void stop();
+	void report(const int & nSentences, const double & dSeconds);
+
+public:
+	PreforkParser(RunBase & rRun, const int & nWorkers);
+	~PreforkParser();
+
+	// loads the models once and forks the workers
+	bool load(const std::string & sFeatureFile);
+	void parse(const std::string & sInputFile, CorpusWriter & output);
+};
+
+#endif
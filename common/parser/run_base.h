@@ -2,17 +2,92 @@
 #define _RUN_H
 
 #include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <iostream>
 
+#include "corpus.h"
+#include "arc_labeler.h"
+#include "sentence_cache.h"
+#include "sentence_parser.h"
 #include "depparser_base.h"
 
 class RunBase {
+protected:
+	std::shared_ptr<ArcLabeler> m_pLabeler;
+	std::shared_ptr<SentenceCache> m_pSentenceCache;
+	// buffering of the CorpusWriter parse writes to
+	int m_nFlushTrees;
+	int m_nBufferSize;
+	// time budget of a sentence in milliseconds, sentences decoded and those
+	// of them finished by the fallback of the decoder
+	double m_dBudget;
+	std::atomic<int> m_nDecoded;
+	std::atomic<int> m_nDegraded;
+
 public:
-	RunBase() = default;
+	RunBase() : m_nFlushTrees(CORPUS_FLUSH_TREES), m_nBufferSize(CORPUS_BUFFER_SIZE), m_dBudget(0.0), m_nDecoded(0), m_nDegraded(0) {}
 	virtual ~RunBase() {};
 
+	void setLabeler(const std::shared_ptr<ArcLabeler> & pLabeler) { m_pLabeler = pLabeler; }
+	void setSentenceCache(const std::shared_ptr<SentenceCache> & pCache) { m_pSentenceCache = pCache; }
+	const std::shared_ptr<SentenceCache> & sentenceCache() const { return m_pSentenceCache; }
+	void setOutputBuffer(const int & nFlushTrees, const int & nBufferSize) { m_nFlushTrees = nFlushTrees; m_nBufferSize = nBufferSize; }
+	void setBudget(const double & dMilliseconds) { m_dBudget = dMilliseconds; }
+	const double & budget() const { return m_dBudget; }
+
+	// repeated sentences are answered from the sentence cache when one is set
+	// the budget goes to the parser with every sentence, so parsers however
+	// they were loaded keep to it, true when the tree is degraded, decoded by
+	// the fallback of the decoder after the budget ran out, such trees aren't
+	// cached
+	template<class PARSER>
+	bool parseSentence(PARSER & parser, const Sentence & sentence, DependencyTree & tree) {
+		if (m_pSentenceCache && m_pSentenceCache->find(sentence, tree)) {
+			return false;
+		}
+		parser.setBudget(m_dBudget);
+		parser.parse(sentence, &tree);
+		++m_nDecoded;
+		if (parser.degraded()) {
+			++m_nDegraded;
+			return true;
+		}
+		if (m_pSentenceCache) {
+			m_pSentenceCache->insert(sentence, tree);
+		}
+		return false;
+	}
+
+	void reportBudget(std::ostream & output) const {
+		int decoded = m_nDecoded, degraded = m_nDegraded;
+		output << "budget " << m_dBudget << "ms: " << degraded << " of " << decoded << " sentences degraded (" << (decoded == 0 ? 0.0 : 100.0 * degraded / decoded) << "%)" << std::endl;
+	}
+
+	// parsed trees are labeled on the way out when a labeler is set
+	void write(std::ostream & output, DependencyTree & tree) {
+		if (m_pLabeler) {
+			m_pLabeler->label(tree);
+		}
+		output << tree;
+	}
+
 	virtual void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::string & sFeatureOutput) = 0;
+	virtual void train(const std::string & sInputFile, const std::string & sFeatureInput, const std::vector<std::string> & vecFeatureOutput, const bool & bShuffle, const int & nThreads, const int & nMixStep) = 0;
 	virtual void parse(const std::string & sInputFile, const std::string & sOutputFile, const std::string & sFeatureFile) = 0;
 	virtual void goldtest(const std::string & sInputFile, const std::string & sFeatureInput) = 0;
+	// parsing a sentence of n words takes about n ^ timeExponent() steps
+	virtual int timeExponent() const { return 3; }
+	// parser with the models of sFeatureFile loaded, as parse() would use it
+	virtual std::unique_ptr<SentenceParser> load(const std::string & /*sFeatureFile*/) {
+		std::cout << "loading a sentence parser is not supported by this decoder." << std::endl;
+		return nullptr;
+	}
+	// decoder specific measurements over gold trees
+	virtual void benchmark(const std::string & /*sInputFile*/, const std::string & /*sFeatureInput*/, const std::vector<std::string> & /*vecOptions*/) {
+		std::cout << "benchmark is not supported by this decoder." << std::endl;
+	}
 };
 
 #endif
@@ -0,0 +1,183 @@
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "score_cache.h"
+
+std::mutex ScoreCache::s_mtxCaches;
+std::map<std::string, std::weak_ptr<ScoreCache>> ScoreCache::s_mapCaches;
+
+ScoreCache::ScoreCache(const std::string & sFile) : m_sFile(sFile) {}
+
+ScoreCache::~ScoreCache() {
+	m_fCache.close();
+}
+
+bool ScoreCache::load(const std::string & sFingerprint) {
+	m_fCache.open(m_sFile, std::ios::in | std::ios::out | std::ios::binary);
+	if (!m_fCache) {
+		return false;
+	}
+
+	char magic[SCORE_CACHE_MAGIC_SIZE];
+	std::uint32_t length = 0;
+	if (!m_fCache.read(magic, SCORE_CACHE_MAGIC_SIZE) || memcmp(magic, SCORE_CACHE_MAGIC, SCORE_CACHE_MAGIC_SIZE) != 0 ||
+		!m_fCache.read((char *)&length, sizeof(length)) || length != sFingerprint.size()) {
+		m_fCache.close();
+		return false;
+	}
+	std::string fingerprint(length, '\0');
+	if (!m_fCache.read(&fingerprint[0], length) || fingerprint != sFingerprint) {
+		m_fCache.close();
+		return false;
+	}
+
+	std::streamoff end = m_fCache.tellg();
+	m_fCache.seekg(0, std::ios::end);
+	std::streamoff file_size = m_fCache.tellg();
+	m_fCache.seekg(end);
+
+	std::uint64_t key;
+	std::uint32_t bytes;
+	// a record cut short by an interrupted run is dropped
+	while (m_fCache.read((char *)&key, sizeof(key)) && m_fCache.read((char *)&bytes, sizeof(bytes))) {
+		std::streamoff offset = end + sizeof(key) + sizeof(bytes);
+		if (offset + bytes > file_size) {
+			break;
+		}
+		m_mapIndex[key] = std::make_pair(offset, bytes);
+		end = offset + bytes;
+		m_fCache.seekg(end);
+	}
+	m_fCache.clear();
+	if (end < file_size) {
+		m_fCache.close();
+		if (truncate(m_sFile.c_str(), end) != 0) {
+			return false;
+		}
+		m_fCache.open(m_sFile, std::ios::in | std::ios::out | std::ios::binary);
+	}
+	return (bool)m_fCache;
+}
+
+bool ScoreCache::reset(const std::string & sFingerprint) {
+	m_mapIndex.clear();
+	m_fCache.close();
+	m_fCache.clear();
+	m_fCache.open(m_sFile, std::ios::out | std::ios::trunc | std::ios::binary);
+	if (!m_fCache) {
+		return false;
+	}
+	std::uint32_t length = sFingerprint.size();
+	m_fCache.write(SCORE_CACHE_MAGIC, SCORE_CACHE_MAGIC_SIZE);
+	m_fCache.write((const char *)&length, sizeof(length));
+	m_fCache.write(sFingerprint.data(), length);
+	m_fCache.close();
+	m_fCache.open(m_sFile, std::ios::in | std::ios::out | std::ios::binary);
+	return (bool)m_fCache;
+}
+
+int ScoreCache::size() {
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	return m_mapIndex.size();
+}
+
+bool ScoreCache::find(const std::uint64_t & key, std::vector<tscore> & scores) {
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	auto itr = m_mapIndex.find(key);
+	if (itr == m_mapIndex.end()) {
+		return false;
+	}
+	m_vecBuffer.resize(itr->second.second);
+	m_fCache.seekg(itr->second.first);
+	if (!m_fCache.read(m_vecBuffer.data(), m_vecBuffer.size())) {
+		m_fCache.clear();
+		return false;
+	}
+
+	scores.clear();
+	std::uint64_t value = 0;
+	int shift = 0;
+	for (const auto & byte : m_vecBuffer) {
+		value |= (std::uint64_t)(byte & 0x7f) << shift;
+		if (byte & 0x80) {
+			shift += 7;
+			// no varint of a score is that long, the record is corrupt
+			if (shift >= 64) {
+				return false;
+			}
+		}
+		else {
+			scores.push_back((tscore)(value >> 1) ^ -(tscore)(value & 1));
+			value = 0;
+			shift = 0;
+		}
+	}
+	return true;
+}
+
+void ScoreCache::insert(const std::uint64_t & key, const std::vector<tscore> & scores, const bool & bReplace) {
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	if (!bReplace && m_mapIndex.find(key) != m_mapIndex.end()) {
+		return;
+	}
+
+	m_vecBuffer.clear();
+	for (const auto & score : scores) {
+		std::uint64_t value = ((std::uint64_t)score << 1) ^ (std::uint64_t)(score >> 63);
+		while (value >= 0x80) {
+			m_vecBuffer.push_back((char)(value | 0x80));
+			value >>= 7;
+		}
+		m_vecBuffer.push_back((char)value);
+	}
+
+	std::uint32_t bytes = m_vecBuffer.size();
+	m_fCache.seekp(0, std::ios::end);
+	std::streamoff offset = (std::streamoff)m_fCache.tellp() + sizeof(key) + sizeof(bytes);
+	m_fCache.write((const char *)&key, sizeof(key));
+	m_fCache.write((const char *)&bytes, sizeof(bytes));
+	m_fCache.write(m_vecBuffer.data(), bytes);
+	if (m_fCache) {
+		m_mapIndex[key] = std::make_pair(offset, bytes);
+	}
+	m_fCache.clear();
+}
+
+std::shared_ptr<ScoreCache> ScoreCache::open(const std::string & sFile, const std::string & sFingerprint) {
+	std::lock_guard<std::mutex> lock(s_mtxCaches);
+	std::shared_ptr<ScoreCache> cache = s_mapCaches[sFile].lock();
+	if (!cache) {
+		cache = std::make_shared<ScoreCache>(sFile);
+		if (!cache->load(sFingerprint) && !cache->reset(sFingerprint)) {
+			return nullptr;
+		}
+		s_mapCaches[sFile] = cache;
+	}
+	return cache;
+}
+
+std::string ScoreCache::fingerprint(const std::vector<std::string> & vecFiles) {
+	std::uint64_t key = SCORE_CACHE_HASH_SEED;
+	for (const auto & file : vecFiles) {
+		struct stat st;
+		key = hash(file, key);
+		if (stat(file.c_str(), &st) == 0) {
+			key = hash(std::to_string(st.st_size), key);
+			key = hash(std::to_string(st.st_mtime), key);
+		}
+	}
+	std::ostringstream oss;
+	oss << std::hex << key;
+	return oss.str();
+}
+
+std::uint64_t ScoreCache::hash(const std::string & str, const std::uint64_t & seed) {
+	std::uint64_t key = seed;
+	for (const auto & c : str) {
+		key = (key ^ (unsigned char)c) * 1099511628211ULL;
+	}
+	// terminator, so "ab" + "c" differs from "a" + "bc"
+	return (key ^ 0xff) * 1099511628211ULL;
+}
@@ -0,0 +1,57 @@
+#ifndef _SCORE_CACHE_H
+#define _SCORE_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+
+#include "include/learning/perceptron/score.h"
+
+#define SCORE_CACHE_MAGIC		"XESCACH1"
+#define SCORE_CACHE_MAGIC_SIZE	8
+#define SCORE_CACHE_HASH_SEED	14695981039346656037ULL
+
+// per-sentence scores of models that stay fixed during training, kept on disk
+// the file starts with a fingerprint of the models, a file written for other
+// models is emptied when opened
+// records are appended as (key, bytes, zigzag varints) and indexed by
+// key when the file is opened, so later runs can reuse them
+// parsers opening the same file share one instance
+class ScoreCache {
+private:
+	std::string m_sFile;
+	std::fstream m_fCache;
+	std::mutex m_mtxCache;
+	// key -> (offset of the varints, bytes)
+	std::unordered_map<std::uint64_t, std::pair<std::streamoff, std::uint32_t>> m_mapIndex;
+	std::vector<char> m_vecBuffer;
+
+	static std::mutex s_mtxCaches;
+	static std::map<std::string, std::weak_ptr<ScoreCache>> s_mapCaches;
+
+	bool load(const std::string & sFingerprint);
+	bool reset(const std::string & sFingerprint);
+
+public:
+	ScoreCache(const std::string & sFile);
+	~ScoreCache();
+
+	int size();
+	bool find(const std::uint64_t & key, std::vector<tscore> & scores);
+	// a record already kept for key stays unless bReplace, the last one
+	// appended wins when the file is opened again
+	void insert(const std::uint64_t & key, const std::vector<tscore> & scores, const bool & bReplace = false);
+
+	static std::shared_ptr<ScoreCache> open(const std::string & sFile, const std::string & sFingerprint);
+	// size, mtime and name of every model file
+	static std::string fingerprint(const std::vector<std::string> & vecFiles);
+	// fnv-1a, chained through seed
+	static std::uint64_t hash(const std::string & str, const std::uint64_t & seed = SCORE_CACHE_HASH_SEED);
+};
+
+#endif
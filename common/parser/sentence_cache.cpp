@@ -0,0 +1,89 @@
+#include <iostream>
+
+#include "score_cache.h"
+#include "sentence_cache.h"
+
+SentenceCache::SentenceCache(const std::size_t & nMaxBytes, const std::string & sFingerprint) :
+	m_nMaxBytes(nMaxBytes), m_nBytes(0), m_nSeed(ScoreCache::hash(sFingerprint)), m_nHits(0), m_nMisses(0) {}
+
+SentenceCache::~SentenceCache() = default;
+
+std::uint64_t SentenceCache::key(const Sentence & sentence) const {
+	std::uint64_t key = m_nSeed;
+	for (const auto & token : sentence) {
+		key = ScoreCache::hash(SENT_WORD(token), key);
+		key = ScoreCache::hash(SENT_POSTAG(token), key);
+	}
+	return key;
+}
+
+std::size_t SentenceCache::bytes(const DependencyTree & tree) {
+	std::size_t bytes = SENTENCE_CACHE_NODE_BYTES;
+	for (const auto & node : tree) {
+		bytes += sizeof(node) + TREENODE_WORD(node).size() + TREENODE_POSTAG(node).size() + TREENODE_LABEL(node).size();
+	}
+	return bytes;
+}
+
+// a hit is checked against the words of the tree, so keys can't collide
+bool SentenceCache::matches(const Sentence & sentence, const DependencyTree & tree) {
+	if (sentence.size() != tree.size()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < sentence.size(); ++i) {
+		if (SENT_WORD(sentence[i]) != TREENODE_WORD(tree[i]) || SENT_POSTAG(sentence[i]) != TREENODE_POSTAG(tree[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SentenceCache::find(const Sentence & sentence, DependencyTree & tree) {
+	std::uint64_t k = key(sentence);
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	auto itr = m_mapTrees.find(k);
+	if (itr == m_mapTrees.end() || !matches(sentence, itr->second->second)) {
+		++m_nMisses;
+		return false;
+	}
+	m_lstTrees.splice(m_lstTrees.begin(), m_lstTrees, itr->second);
+	tree = itr->second->second;
+	++m_nHits;
+	return true;
+}
+
+void SentenceCache::insert(const Sentence & sentence, const DependencyTree & tree) {
+	std::size_t size = bytes(tree);
+	if (size > m_nMaxBytes) {
+		return;
+	}
+	std::uint64_t k = key(sentence);
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	auto itr = m_mapTrees.find(k);
+	if (itr != m_mapTrees.end()) {
+		m_nBytes -= bytes(itr->second->second);
+		m_lstTrees.erase(itr->second);
+		m_mapTrees.erase(itr);
+	}
+	m_lstTrees.push_front(std::make_pair(k, tree));
+	m_mapTrees[k] = m_lstTrees.begin();
+	m_nBytes += size;
+	while (m_nBytes > m_nMaxBytes) {
+		m_nBytes -= bytes(m_lstTrees.back().second);
+		m_mapTrees.erase(m_lstTrees.back().first);
+		m_lstTrees.pop_back();
+	}
+}
+
+void SentenceCache::clear() {
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	m_lstTrees.clear();
+	m_mapTrees.clear();
+	m_nBytes = 0;
+}
+
+void SentenceCache::report(std::ostream & output) {
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	long long total = m_nHits + m_nMisses;
+	output << "sentence cache: " << m_nHits << " hits of " << total << " lookups (" << (total == 0 ? 0.0 : 100.0 * m_nHits / total) << "%), " << m_lstTrees.size() << " trees in " << m_nBytes << " bytes" << std::endl;
+}
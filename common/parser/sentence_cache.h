@@ -0,0 +1,51 @@
+#ifndef _SENTENCE_CACHE_H
+#define _SENTENCE_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "macros_base.h"
+
+#define SENTENCE_CACHE_NODE_BYTES	64
+
+// trees of parsed sentences, so repeated sentences aren't decoded again
+// sentences are keyed by a hash of their words and tags seeded with the
+// fingerprint of the models, the least recently used trees are dropped once
+// the trees held take more than the byte budget
+// threads may share one cache
+class SentenceCache {
+private:
+	typedef std::list<std::pair<std::uint64_t, DependencyTree>> TreeList;
+
+	std::mutex m_mtxCache;
+	std::size_t m_nMaxBytes;
+	std::size_t m_nBytes;
+	std::uint64_t m_nSeed;
+	// most recently used first
+	TreeList m_lstTrees;
+	std::unordered_map<std::uint64_t, TreeList::iterator> m_mapTrees;
+	long long m_nHits;
+	long long m_nMisses;
+
+	std::uint64_t key(const Sentence & sentence) const;
+	static std::size_t bytes(const DependencyTree & tree);
+	static bool matches(const Sentence & sentence, const DependencyTree & tree);
+
+public:
+	SentenceCache(const std::size_t & nMaxBytes, const std::string & sFingerprint);
+	~SentenceCache();
+
+	// false when the sentence isn't cached
+	bool find(const Sentence & sentence, DependencyTree & tree);
+	void insert(const Sentence & sentence, const DependencyTree & tree);
+	// drops every tree, for models replaced while the cache is in use
+	void clear();
+
+	void report(std::ostream & output);
+};
+
+#endif
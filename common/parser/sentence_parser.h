@@ -0,0 +1,45 @@
+#ifndef _SENTENCE_PARSER_H
+#define _SENTENCE_PARSER_H
+
+#include <memory>
+
+#include "macros_base.h"
+
+// a parser with its models loaded, for modes that parse one sentence at a
+// time and keep the models between sentences
+class SentenceParser {
+public:
+	SentenceParser() = default;
+	virtual ~SentenceParser() {};
+
+	virtual void parse(const Sentence & sentence, DependencyTree * retval) = 0;
+	virtual void setBudget(const double & dMilliseconds) = 0;
+	virtual bool degraded() const = 0;
+};
+
+// SentenceParser over the DepParser of a decoder
+template<class DEP_PARSER>
+class LoadedParser : public SentenceParser {
+private:
+	std::unique_ptr<DEP_PARSER> m_pParser;
+
+public:
+	LoadedParser(DEP_PARSER * pParser) : m_pParser(pParser) {}
+	~LoadedParser() = default;
+
+	DEP_PARSER * get() { return m_pParser.get(); }
+
+	void parse(const Sentence & sentence, DependencyTree * retval) override {
+		m_pParser->parse(sentence, retval);
+	}
+
+	void setBudget(const double & dMilliseconds) override {
+		m_pParser->setBudget(dMilliseconds);
+	}
+
+	bool degraded() const override {
+		return m_pParser->degraded();
+	}
+};
+
+#endif
@@ -12,6 +12,8 @@ public:
 	WeightBase(const std::string & sRead, const std::string & sRecord) :
 		m_sReadPath(sRead), m_sRecordPath(sRecord) {}
 	virtual ~WeightBase() {};
+
+	void referRecordPath(const std::string & sRecord) { m_sRecordPath = sRecord; }
 };
 
 #endif
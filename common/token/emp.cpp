@@ -1,3 +1,4 @@
 #include "emp.h"
 
 Token TEmptyTag::tokenizer = Token(1);
+thread_local Token * TEmptyTag::current = &TEmptyTag::tokenizer;
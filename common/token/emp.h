@@ -5,6 +5,8 @@
 class TEmptyTag {
 protected:
 	static Token tokenizer;
+	// tokenizer the calling thread codes with, tokenizer unless it uses another
+	static thread_local Token * current;
 
 public:
 	TEmptyTag();
@@ -17,6 +19,8 @@ public:
 	static const int end();
 
 	static Token & getTokenizer();
+	// nullptr goes back to tokenizer
+	static void useTokenizer(Token * pTokenizer);
 };
 
 inline TEmptyTag::TEmptyTag() = default;
@@ -24,27 +28,31 @@ inline TEmptyTag::TEmptyTag() = default;
 inline TEmptyTag::~TEmptyTag() = default;
 
 inline int TEmptyTag::count() {
-	return TEmptyTag::tokenizer.count();
+	return TEmptyTag::current->count();
 }
 
 inline const int TEmptyTag::start() {
-	return TEmptyTag::tokenizer.start();
+	return TEmptyTag::current->start();
 }
 
 inline const int TEmptyTag::end() {
-	return TEmptyTag::tokenizer.end();
+	return TEmptyTag::current->end();
 }
 
 inline int TEmptyTag::code(const ttoken & s) {
-	return TEmptyTag::tokenizer.lookup(s);
+	return TEmptyTag::current->lookup(s);
 }
 
 inline const ttoken & TEmptyTag::key(const int & index) {
-	return TEmptyTag::tokenizer.key(index);
+	return TEmptyTag::current->key(index);
 }
 
 inline Token & TEmptyTag::getTokenizer() {
-	return tokenizer;
+	return *current;
+}
+
+inline void TEmptyTag::useTokenizer(Token * pTokenizer) {
+	current = pTokenizer == nullptr ? &tokenizer : pTokenizer;
 }
 
 #endif
@@ -1,3 +1,5 @@
 #include "pos.h"
 
+const int TPOSTag::START;
 Token TPOSTag::tokenizer = Token(1);
+thread_local Token * TPOSTag::current = &TPOSTag::tokenizer;
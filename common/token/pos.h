@@ -5,6 +5,8 @@
 class TPOSTag {
 protected:
 	static Token tokenizer;
+	// tokenizer the calling thread codes with, tokenizer unless it uses another
+	static thread_local Token * current;
 
 public:
 	TPOSTag();
@@ -16,6 +18,8 @@ public:
 	static const int START = 1;
 
 	static Token & getTokenizer();
+	// nullptr goes back to tokenizer
+	static void useTokenizer(Token * pTokenizer);
 };
 
 inline TPOSTag::TPOSTag() = default;
@@ -23,19 +27,23 @@ inline TPOSTag::TPOSTag() = default;
 inline TPOSTag::~TPOSTag() = default;
 
 inline int TPOSTag::count() {
-	return TPOSTag::tokenizer.count();
+	return TPOSTag::current->count();
 }
 
 inline int TPOSTag::code(const ttoken & s) {
-	return TPOSTag::tokenizer.lookup(s);
+	return TPOSTag::current->lookup(s);
 }
 
 inline const ttoken & TPOSTag::key(const int & index) {
-	return TPOSTag::tokenizer.key(index);
+	return TPOSTag::current->key(index);
 }
 
 inline Token & TPOSTag::getTokenizer() {
-	return tokenizer;
+	return *current;
+}
+
+inline void TPOSTag::useTokenizer(Token * pTokenizer) {
+	current = pTokenizer == nullptr ? &tokenizer : pTokenizer;
 }
 
 #endif
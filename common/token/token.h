@@ -2,6 +2,7 @@
 #define _TOKEN_H
 #include <vector>
 #include <string>
+#include <utility>
 #include <iostream>
 #include <unordered_map>
 
@@ -34,6 +35,7 @@ public:
 	void add(const ttoken & key);
 	int start() const;
 	int end() const;
+	void swap(Token & token);
 
 	friend std::istream & operator>>(std::istream & is, Token & token) {
 		int count;
@@ -55,12 +57,14 @@ public:
 	}
 };
 
+// only reads the map for a known key, so threads may look known keys up together
 inline const int & Token::lookup(const ttoken & key) {
-	if (m_mapTokens.find(key) == m_mapTokens.end()) {
-		m_mapTokens[key] = m_nWaterMark++;
+	auto itr = m_mapTokens.find(key);
+	if (itr == m_mapTokens.end()) {
+		itr = m_mapTokens.insert(std::make_pair(key, m_nWaterMark++)).first;
 		m_vecKeys.push_back(key);
 	}
-	return m_mapTokens[key];
+	return itr->second;
 }
 
 inline const int & Token::find(const ttoken & key, const int & val) const {
@@ -90,4 +94,11 @@ inline int Token::end() const {
 	return m_nWaterMark;
 }
 
+inline void Token::swap(Token & token) {
+	std::swap(m_nWaterMark, token.m_nWaterMark);
+	std::swap(m_nStartingToken, token.m_nStartingToken);
+	m_vecKeys.swap(token.m_vecKeys);
+	m_mapTokens.swap(token.m_mapTokens);
+}
+
 #endif
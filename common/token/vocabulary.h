@@ -0,0 +1,45 @@
+#ifndef _VOCABULARY_H
+#define _VOCABULARY_H
+#include "word.h"
+#include "pos.h"
+#include "emp.h"
+
+// word, postag and empty tag tokens of one set of models
+// models add their vocabulary to the tokenizers while they load, so models
+// loaded beside threads parsing with older ones go into a vocabulary of their
+// own, used only by the loading thread, swap() then hands it to every thread
+class Vocabulary {
+private:
+	Token m_cWords;
+	Token m_cPOSTags;
+	Token m_cEmptyTags;
+
+public:
+	Vocabulary() : m_cWords(TWord::START), m_cPOSTags(TPOSTag::START), m_cEmptyTags(1) {}
+	~Vocabulary() = default;
+
+	// the calling thread codes with this vocabulary
+	void use() {
+		TWord::useTokenizer(&m_cWords);
+		TPOSTag::useTokenizer(&m_cPOSTags);
+		TEmptyTag::useTokenizer(&m_cEmptyTags);
+	}
+
+	// the calling thread codes with the tokenizers of the process again
+	static void release() {
+		TWord::useTokenizer(nullptr);
+		TPOSTag::useTokenizer(nullptr);
+		TEmptyTag::useTokenizer(nullptr);
+	}
+
+	// exchanges this vocabulary with the tokenizers of the process, no other
+	// thread may code meanwhile
+	void swap() {
+		release();
+		TWord::getTokenizer().swap(m_cWords);
+		TPOSTag::getTokenizer().swap(m_cPOSTags);
+		TEmptyTag::getTokenizer().swap(m_cEmptyTags);
+	}
+};
+
+#endif
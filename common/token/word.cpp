@@ -1,3 +1,5 @@
 #include "word.h"
 
+const int TWord::START;
 Token TWord::tokenizer = Token(1);
+thread_local Token * TWord::current = &TWord::tokenizer;
@@ -5,6 +5,8 @@
 class TWord {
 protected:
 	static Token tokenizer;
+	// tokenizer the calling thread codes with, tokenizer unless it uses another
+	static thread_local Token * current;
 
 public:
 	TWord();
@@ -16,6 +18,8 @@ public:
 	static const int START = 1;
 
 	static Token & getTokenizer();
+	// nullptr goes back to tokenizer
+	static void useTokenizer(Token * pTokenizer);
 };
 
 inline TWord::TWord() = default;
@@ -23,19 +27,23 @@ inline TWord::TWord() = default;
 inline TWord::~TWord() = default;
 
 inline int TWord::code(const ttoken & s) {
-	return tokenizer.lookup(s);
+	return current->lookup(s);
 }
 
 inline int TWord::count() {
-	return TWord::tokenizer.count();
+	return TWord::current->count();
 }
 
 inline const ttoken & TWord::key(const int & index) {
-	return TWord::tokenizer.key(index);
+	return TWord::current->key(index);
 }
 
 inline Token & TWord::getTokenizer() {
-	return tokenizer;
+	return *current;
+}
+
+inline void TWord::useTokenizer(Token * pTokenizer) {
+	current = pTokenizer == nullptr ? &tokenizer : pTokenizer;
 }
 
 #endif
@@ -27,9 +27,11 @@ public:
 	}
 
 	void getOrUpdateScore(RET_TYPE & ts, const KEY_TYPE & key, const int & which, const UPDATE_TYPE & amount, const int & round) {
+		// reading leaves the map untouched, so forked parsers share its pages
 		if (amount == 0) {
-			if (m_mapScores.find(key) != m_mapScores.end()) {
-				m_mapScores[key].updateRetval(ts, which);
+			auto itr = m_mapScores.find(key);
+			if (itr != m_mapScores.end()) {
+				itr->second.updateRetval(ts, which);
 			}
 		}
 		else {
@@ -47,6 +49,13 @@ public:
 		}
 	}
 
+	void mixScores(const PackedScoreMap & base, const PackedScoreMap & worker) {
+		for (const auto & score : worker.m_mapScores) {
+			auto itr = base.m_mapScores.find(score.first);
+			m_mapScores[score.first].mix(itr == base.m_mapScores.end() ? VAL_TYPE() : itr->second, score.second);
+		}
+	}
+
 	void clearScore() {
 		for (auto && score : m_mapScores) {
 			score.second.reset();
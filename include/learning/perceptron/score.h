@@ -1,6 +1,7 @@
 #ifndef _SCORE_H
 #define _SCORE_H
 
+#include <cmath>
 #include <string>
 #include <iostream>
 #include <algorithm>
@@ -42,6 +43,7 @@ public:
 	bool zero() const;
 	void updateCurrent(const int & added = 0, const int & round = 0);
 	void updateAverage(const int & round);
+	void mix(const Score & base, const Score & worker);
 	void updateRetval(tscore & retval, const int & which);
 	void updateRetvalCurrent(tscore & retval);
 	void updateRetvalTotal(tscore & retval);
@@ -80,10 +82,7 @@ inline void Score::reset() {
 }
 
 inline void Score::updateCurrent(const int & added, const int & round) {
-	if (round > m_nLastUpdate) {
-		updateAverage(round);
-		m_nLastUpdate = round;
-	}
+	updateAverage(round);
 	m_nCurrent += added;
 	m_nTotal += added;
 }
@@ -91,9 +90,18 @@ inline void Score::updateCurrent(const int & added, const int & round) {
 inline void Score::updateAverage(const int & round) {
 	if (round > m_nLastUpdate) {
 		m_nTotal += (tscore)(m_nCurrent * (round - m_nLastUpdate));
+		m_nLastUpdate = round;
 	}
 }
 
+// add what a worker copy learned since it was copied from base
+// both must be averaged to the same round
+inline void Score::mix(const Score & base, const Score & worker) {
+	m_nCurrent += worker.m_nCurrent - base.m_nCurrent;
+	m_nTotal += worker.m_nTotal - base.m_nTotal;
+	m_nLastUpdate = worker.m_nLastUpdate;
+}
+
 inline void Score::updateRetval(tscore & retval, const int & which) {
 	switch (which) {
 	case eNonAverage:
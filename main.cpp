@@ -1,16 +1,17 @@
+#include <set>
 #include <memory>
+#include <vector>
 #include <cstring>
+#include <sstream>
 
-#include "common/parser/graph_dp/eisner/eisner_run.h"
-#include "common/parser/graph_dp/eisner2nd/eisner2nd_run.h"
-#include "common/parser/graph_dp/eisner3rd/eisner3rd_run.h"
-#include "common/parser/graph_dp/eisnergc/eisnergc_run.h"
-#include "common/parser/graph_dp/eisnergc2nd/eisnergc2nd_run.h"
-#include "common/parser/graph_dp/eisnergc3rd/eisnergc3rd_run.h"
-#include "common/parser/graph_dp/emptyeisner2nd/emptyeisner2nd_run.h"
-#include "common/parser/graph_dp/emptyeisner3rd/emptyeisner3rd_run.h"
-#include "common/parser/graph_dp/emptyeisnergc2nd/emptyeisnergc2nd_run.h"
-#include "common/parser/graph_dp/emptyeisnergc3rd/emptyeisnergc3rd_run.h"
+#include "common/parser/corpus.h"
+#include "common/parser/arc_labeler.h"
+#include "common/parser/score_cache.h"
+#include "common/parser/parse_server.h"
+#include "common/parser/parse_scheduler.h"
+#include "common/parser/prefork_parser.h"
+#include "common/parser/empty_detector.h"
+#include "common/parser/graph_dp/decoders.h"
 
 #define	SLASH	"\\"
 
@@ -18,48 +19,105 @@ int main(int argc, char * argv[]) {
 
 	std::unique_ptr<RunBase> run(nullptr);
 
-	if (strcmp(argv[2], "eisner") == 0) {
-		run.reset(new eisner::Run());
-	}
-	else if (strcmp(argv[2], "eisner2nd") == 0) {
-		run.reset(new eisner2nd::Run());
-	}
-	else if (strcmp(argv[2], "eisner3rd") == 0) {
-		run.reset(new eisner3rd::Run());
-	}
-	else if (strcmp(argv[2], "eisnergc") == 0) {
-		run.reset(new eisnergc::Run());
+	// convert tree|sent <text file> <binary file>
+	if (strcmp(argv[1], "convert") == 0) {
+		if (!BinaryCorpus::convert(argv[3], argv[4], strcmp(argv[2], "tree") == 0)) {
+			std::cout << "convert failed." << std::endl;
+			return 1;
+		}
+		return 0;
 	}
-	else if (strcmp(argv[2], "eisnergc2nd") == 0) {
-		run.reset(new eisnergc2nd::Run());
+
+	// detector <gold trees> <model file> [iterations]
+	if (strcmp(argv[1], "detector") == 0) {
+		EmptyDetector detector;
+		detector.train(argv[2], argc > 4 ? std::atoi(argv[4]) : EMPTY_DETECTOR_ITERATION);
+		if (!detector.save(argv[3])) {
+			std::cout << "saving detector failed." << std::endl;
+			return 1;
+		}
+		return 0;
 	}
-	else if (strcmp(argv[2], "eisnergc3rd") == 0) {
-		run.reset(new eisnergc3rd::Run());
+
+	// labeler <gold trees> <model file> [iterations]
+	if (strcmp(argv[1], "labeler") == 0) {
+		ArcLabeler labeler;
+		labeler.train(argv[2], argc > 4 ? std::atoi(argv[4]) : ARC_LABELER_ITERATION);
+		if (!labeler.save(argv[3])) {
+			std::cout << "saving labeler failed." << std::endl;
+			return 1;
+		}
+		return 0;
 	}
-	else if (strcmp(argv[2], "emptyeisner2nd") == 0) {
-		run.reset(new emptyeisner2nd::Run());
+
+	// client <socket> <input file> <output file>, parses through a running server
+	if (strcmp(argv[1], "client") == 0) {
+		return ParseServer::client(argv[2], argv[3], argv[4]) ? 0 : 1;
 	}
-	else if (strcmp(argv[2], "emptyeisner3rd") == 0) {
-		run.reset(new emptyeisner3rd::Run());
+
+	// reload <socket> [feature file], replaces the models of a running server,
+	// with the file it was started with when none is given, as SIGHUP does
+	if (strcmp(argv[1], "reload") == 0) {
+		return ParseServer::requestReload(argv[2], argc > 3 ? argv[3] : "") ? 0 : 1;
 	}
-	else if (strcmp(argv[2], "emptyeisnergc2nd") == 0) {
-		run.reset(new emptyeisnergc2nd::Run());
+
+	// decoder options are read by createRun()
+	// labeler=file labels the arcs of parsed trees with an arc labeler model
+	// flush=n writes parsed trees out every n sentences (0 when the buffer is
+	// full only), buffer=kb bounds the memory of trees waiting to be written
+	// the input and output of parse may be - for stdin and stdout
+	// lru=mb answers repeated sentences of parse and server from a cache of
+	// at most mb megabytes of trees
+	// threads=n parses with n parsers, longest sentences first, and trains
+	// trainall with n workers
+	// workers=n parses with n processes forked after loading the models once
+	// budget=ms gives every sentence of parse and server ms milliseconds,
+	// higher order decoders finish the sentences running over it with first
+	// order eisner and report how many they degraded
+	int flush = CORPUS_FLUSH_TREES, buffer = CORPUS_BUFFER_SIZE, threads = 1, workers = 1, lru = 0;
+	double budget = 0.0;
+	std::string labeler;
+	for (int i = 3; i < argc; ++i) {
+		if (strncmp(argv[i], "labeler=", strlen("labeler=")) == 0) {
+			labeler = argv[i] + strlen("labeler=");
+		}
+		else if (strncmp(argv[i], "flush=", strlen("flush=")) == 0) {
+			flush = std::atoi(argv[i] + strlen("flush="));
+		}
+		else if (strncmp(argv[i], "buffer=", strlen("buffer=")) == 0) {
+			buffer = std::atoi(argv[i] + strlen("buffer=")) << 10;
+		}
+		else if (strncmp(argv[i], "threads=", strlen("threads=")) == 0) {
+			threads = std::atoi(argv[i] + strlen("threads="));
+		}
+		else if (strncmp(argv[i], "workers=", strlen("workers=")) == 0) {
+			workers = std::atoi(argv[i] + strlen("workers="));
+		}
+		else if (strncmp(argv[i], "lru=", strlen("lru=")) == 0) {
+			lru = std::atoi(argv[i] + strlen("lru="));
+		}
+		else if (strncmp(argv[i], "budget=", strlen("budget=")) == 0) {
+			budget = std::atof(argv[i] + strlen("budget="));
+		}
 	}
-	else if (strcmp(argv[2], "emptyeisnergc3rd") == 0) {
-		run.reset(new emptyeisnergc3rd::Run());
+
+	run = createRun(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+	if (!run) {
+		std::cout << "unknown decoder " << argv[2] << "." << std::endl;
+		return 1;
 	}
 
 	if (strcmp(argv[1], "goldtest") == 0) {
 		run->goldtest(argv[3], argv[4]);
 	}
-	else if (strcmp(argv[1], "train") == 0) {
+	else if (strcmp(argv[1], "train") == 0 || strcmp(argv[1], "trainall") == 0) {
 
 		int iteration = std::atoi(argv[5]);
 
-		std::string current_feature;
 		std::string next_feature;
+		std::vector<std::string> features;
 
-		current_feature = next_feature = argv[4];
+		next_feature = argv[4];
 		next_feature =
 				next_feature.find('#') == std::string::npos ?
 						next_feature.substr(0, next_feature.rfind(SLASH) + strlen(SLASH)) + argv[2] + "1.feat" :
@@ -67,16 +125,106 @@ int main(int argc, char * argv[]) {
 						argv[2] + "1.feat" + "#" + next_feature.substr(next_feature.find('#') + 1);
 
 		for (int i = 0; i < iteration; ++i) {
-//			std::cout << current_feature << std::endl << next_feature << std::endl;
-			run->train(argv[3], current_feature, next_feature);
-			current_feature = next_feature;
+			features.push_back(next_feature);
 			next_feature = next_feature.find('#') == std::string::npos ?
 					next_feature.substr(0, next_feature.rfind(argv[2]) + strlen(argv[2])) + std::to_string(i + 2) + ".feat" :
 					next_feature.substr(0, next_feature.find('#')).substr(0, next_feature.substr(0, next_feature.find('#')).rfind(argv[2]) + strlen(argv[2])) +
 					std::to_string(i + 2) + ".feat" + "#" + next_feature.substr(next_feature.find('#') + 1);
 		}
+
+		if (strcmp(argv[1], "train") == 0) {
+			std::string current_feature = argv[4];
+			for (const auto & feature : features) {
+//				std::cout << current_feature << std::endl << feature << std::endl;
+				run->train(argv[3], current_feature, feature);
+				current_feature = feature;
+			}
+		}
+		// trainall keeps the model in memory between iterations
+		// options: shuffle, save=i,j,... (the last iteration is always saved),
+		// threads=n and mix=k for parameter mixing every k sentences (default every iteration)
+		else if (iteration > 0) {
+			bool shuffle = false;
+			int mix = 0;
+			std::set<int> saves;
+			for (int i = 6; i < argc; ++i) {
+				if (strcmp(argv[i], "shuffle") == 0) {
+					shuffle = true;
+				}
+				else if (strncmp(argv[i], "mix=", strlen("mix=")) == 0) {
+					mix = std::atoi(argv[i] + strlen("mix="));
+				}
+				else if (strncmp(argv[i], "save=", strlen("save=")) == 0) {
+					std::istringstream iss(argv[i] + strlen("save="));
+					std::string save;
+					while (std::getline(iss, save, ',')) {
+						saves.insert(std::atoi(save.c_str()));
+					}
+				}
+			}
+			if (!saves.empty()) {
+				for (int i = 0; i < iteration - 1; ++i) {
+					if (saves.find(i + 1) == saves.end()) {
+						features[i].clear();
+					}
+				}
+			}
+			run->train(argv[3], argv[4], features, shuffle, threads, mix);
+		}
+	}
+	else if (strcmp(argv[1], "parse") == 0 || strcmp(argv[1], "server") == 0) {
+		if (!labeler.empty()) {
+			std::shared_ptr<ArcLabeler> labels = ArcLabeler::open(labeler);
+			if (!labels) {
+				return 1;
+			}
+			run->setLabeler(labels);
+		}
+		if (lru > 0) {
+			// the model is the fourth argument of parse and the third of server
+			std::string feature = strcmp(argv[1], "parse") == 0 ? argv[4] : argv[3];
+			run->setSentenceCache(std::make_shared<SentenceCache>((std::size_t)lru << 20, std::string(argv[2]) + ScoreCache::fingerprint({ feature })));
+		}
+		run->setBudget(budget);
+		// server <decoder> <feature> <socket> [options], loads the models once
+		// and answers clients until it is stopped
+		if (strcmp(argv[1], "server") == 0) {
+			ParseServer server(*run);
+			if (!server.open(argv[4], argv[3])) {
+				return 1;
+			}
+			server.run();
+		}
+		else if (workers > 1) {
+			CorpusWriter output(argv[5], flush, buffer);
+			PreforkParser prefork(*run, workers);
+			if (!prefork.load(argv[4])) {
+				return 1;
+			}
+			prefork.parse(argv[3], output);
+		}
+		else if (threads > 1) {
+			CorpusWriter output(argv[5], flush, buffer);
+			ParseScheduler scheduler(*run, threads);
+			if (!scheduler.load(argv[4])) {
+				return 1;
+			}
+			scheduler.parse(argv[3], output);
+		}
+		else {
+			run->setOutputBuffer(flush, buffer);
+			run->parse(argv[3], argv[5], argv[4]);
+		}
+		if (run->sentenceCache()) {
+			run->sentenceCache()->report(std::cout);
+		}
+		// workers decode in processes of their own and report in prefork
+		if (budget > 0.0 && workers <= 1) {
+			run->reportBudget(std::cout);
+		}
 	}
-	else if (strcmp(argv[1], "parse") == 0) {
-		run->parse(argv[3], argv[5], argv[4]);
+	// benchmark <decoder> <gold trees> <feature> [options]
+	else if (strcmp(argv[1], "benchmark") == 0) {
+		run->benchmark(argv[3], argv[4], std::vector<std::string>(argv + 5, argv + argc));
 	}
 }
@@ -0,0 +1,47 @@
+#include <iostream>
+
+#include "test_models.h"
+#include "common/parser/batch_parser.h"
+
+// loads a model through the library and parses the test sentences with it
+int main() {
+	std::string directory = testDirectory();
+	if (directory.empty() || !trainModel(directory, "verb.feat", VERB_HEADS)) {
+		std::cout << "training the test model failed." << std::endl;
+		return 1;
+	}
+
+	std::unique_ptr<BatchParser> parser = BatchParser::open("eisner", directory + "/verb.feat");
+	if (!parser) {
+		std::cout << "opening the test model failed." << std::endl;
+		return 1;
+	}
+	if (BatchParser::open("nodecoder", directory + "/verb.feat")) {
+		std::cout << "an unknown decoder was opened." << std::endl;
+		return 1;
+	}
+
+	std::vector<Sentence> sentences = testSentences();
+	DependencyTree tree;
+	parser->parse(sentences[0], tree);
+	if (!hasHeads(tree, sentences[0], VERB_HEADS)) {
+		std::cout << "the sentence was parsed as" << std::endl << tree;
+		return 1;
+	}
+
+	// a batch parses as its sentences one by one, empty sentences get empty trees
+	sentences.push_back(Sentence());
+	std::vector<DependencyTree> trees = parser->parse(sentences);
+	if (trees.size() != sentences.size() || !trees.back().empty()) {
+		std::cout << "the batch has " << trees.size() << " trees for " << sentences.size() << " sentences." << std::endl;
+		return 1;
+	}
+	for (std::size_t i = 0; i + 1 < sentences.size(); ++i) {
+		if (!hasHeads(trees[i], sentences[i], VERB_HEADS)) {
+			std::cout << "sentence " << i << " of the batch was parsed as" << std::endl << trees[i];
+			return 1;
+		}
+	}
+	removeTestDirectory(directory);
+	return 0;
+}
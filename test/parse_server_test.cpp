@@ -0,0 +1,105 @@
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include "test_models.h"
+#include "common/parser/parse_server.h"
+
+#define CLIENTS	4
+#define ROUNDS	20
+
+// clients parse through the server while its models are swapped back and
+// forth between a verb headed and a noun headed one, every tree has to be
+// the tree of one of the two models, never one of a model half loaded
+int main() {
+	std::string directory = testDirectory();
+	if (directory.empty() || !trainModel(directory, "verb.feat", VERB_HEADS) || !trainModel(directory, "noun.feat", NOUN_HEADS)) {
+		std::cout << "training the test models failed." << std::endl;
+		return 1;
+	}
+
+	std::vector<Sentence> sentences = testSentences();
+	std::string input = directory + "/input.txt", socket = directory + "/server.sock";
+	std::ofstream output(input);
+	for (int round = 0; round < ROUNDS; ++round) {
+		for (const auto & sentence : sentences) {
+			for (std::size_t i = 0; i < sentence.size(); ++i) {
+				output << (i == 0 ? "" : " ") << SENT_WORD(sentence[i]) << SENT_SPTOKEN << SENT_POSTAG(sentence[i]);
+			}
+			output << std::endl;
+		}
+	}
+	output.close();
+
+	// run() doesn't return, the server and its run are left to the end of the process
+	RunBase * run = createRun("eisner", std::vector<std::string>()).release();
+	ParseServer * server = new ParseServer(*run);
+	if (!server->open(socket, directory + "/verb.feat")) {
+		std::cout << "the server can't be opened." << std::endl;
+		return 1;
+	}
+	std::thread(&ParseServer::run, server).detach();
+
+	std::atomic<bool> parsing(true);
+	int reloads = 0;
+	std::thread reloader([&]() {
+		while (parsing) {
+			if (!server->reload(directory + (reloads % 2 == 0 ? "/noun.feat" : "/verb.feat"))) {
+				break;
+			}
+			++reloads;
+		}
+	});
+	std::vector<std::thread> clients;
+	std::atomic<int> failed(0);
+	for (int i = 0; i < CLIENTS; ++i) {
+		clients.push_back(std::thread([&, i]() {
+			if (!ParseServer::client(socket, input, directory + "/output" + std::to_string(i) + ".txt")) {
+				++failed;
+			}
+		}));
+	}
+	for (auto & client : clients) {
+		client.join();
+	}
+	parsing = false;
+	reloader.join();
+	if (failed > 0 || reloads < 2) {
+		std::cout << failed << " clients failed, " << reloads << " reloads." << std::endl;
+		return 1;
+	}
+
+	int verbs = 0, nouns = 0;
+	for (int i = 0; i < CLIENTS; ++i) {
+		std::ifstream trees(directory + "/output" + std::to_string(i) + ".txt");
+		DependencyTree tree;
+		std::size_t index = 0;
+		while (trees >> tree) {
+			const Sentence & sentence = sentences[index % sentences.size()];
+			if (hasHeads(tree, sentence, VERB_HEADS)) {
+				++verbs;
+			}
+			else if (hasHeads(tree, sentence, NOUN_HEADS)) {
+				++nouns;
+			}
+			else {
+				std::cout << "sentence " << index << " of client " << i << " was parsed as" << std::endl << tree;
+				return 1;
+			}
+			++index;
+		}
+		if (index != ROUNDS * sentences.size()) {
+			std::cout << "client " << i << " got " << index << " trees of " << ROUNDS * sentences.size() << "." << std::endl;
+			return 1;
+		}
+	}
+	std::cout << verbs << " trees of the verb headed model, " << nouns << " of the noun headed one, " << reloads << " reloads." << std::endl;
+	// both models have to have parsed while the clients ran
+	if (verbs == 0 || nouns == 0) {
+		return 1;
+	}
+	removeTestDirectory(directory);
+	return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef _TEST_MODELS_H
+#define _TEST_MODELS_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <cstdlib>
+
+#include "common/parser/macros_base.h"
+#include "common/parser/graph_dp/decoders.h"
+
+// sentences of the tests, a determiner, a noun, a verb and a noun each
+inline std::vector<Sentence> testSentences() {
+	std::vector<Sentence> sentences;
+	for (int d = 0; d < 3; ++d) {
+		for (int n = 0; n < 4; ++n) {
+			for (int v = 0; v < 3; ++v) {
+				sentences.push_back(Sentence({
+					POSTaggedWord("dt" + std::to_string(d), "DT"),
+					POSTaggedWord("nn" + std::to_string(n), "NN"),
+					POSTaggedWord("vv" + std::to_string(v), "VV"),
+					POSTaggedWord("nn" + std::to_string((n + v) % 4), "NN") }));
+			}
+		}
+	}
+	return sentences;
+}
+
+// heads of the test sentences under the verb headed and the noun headed
+// annotation the two test models are trained on
+const std::vector<int> VERB_HEADS = { 1, 2, -1, 2 };
+const std::vector<int> NOUN_HEADS = { 1, -1, 1, 2 };
+
+// a directory of its own for the files of a test, empty if none was made
+inline std::string testDirectory() {
+	char path[] = "/tmp/xeisner_testXXXXXX";
+	return mkdtemp(path) == nullptr ? std::string() : std::string(path);
+}
+
+inline void removeTestDirectory(const std::string & sDirectory) {
+	std::system(("rm -rf " + sDirectory).c_str());
+}
+
+// trains eisner on the test sentences with vecHeads, the model file is
+// sDirectory/sName
+inline bool trainModel(const std::string & sDirectory, const std::string & sName, const std::vector<int> & vecHeads, const int & nIterations = 5) {
+	std::string corpus = sDirectory + "/" + sName + ".txt", model = sDirectory + "/" + sName;
+	std::ofstream output(corpus);
+	for (const auto & sentence : testSentences()) {
+		for (std::size_t i = 0; i < sentence.size(); ++i) {
+			output << SENT_WORD(sentence[i]) << "\t" << SENT_POSTAG(sentence[i]) << "\t" << vecHeads[i] << "\t" << "-NULL-" << std::endl;
+		}
+		output << std::endl;
+	}
+	output.close();
+	std::unique_ptr<RunBase> run = createRun("eisner", std::vector<std::string>());
+	std::vector<std::string> models;
+	for (int i = 1; i < nIterations; ++i) {
+		models.push_back(std::string());
+	}
+	models.push_back(model);
+	run->train(corpus, "", models, false, 1, 0);
+	return std::ifstream(model).good();
+}
+
+inline bool hasHeads(const DependencyTree & tree, const Sentence & sentence, const std::vector<int> & vecHeads) {
+	if (tree.size() != sentence.size()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < tree.size(); ++i) {
+		if (TREENODE_POSTAGGEDWORD(tree[i]) != sentence[i] || TREENODE_HEAD(tree[i]) != vecHeads[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#endif